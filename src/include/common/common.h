@@ -1,16 +1,212 @@
 #pragma once
 
 #include <common/config.h>
+#include <common/string_kernels.h>
 
+#include <algorithm>
 #include <cassert>
+#include <cstddef>
+#include <cstring>
+#include <functional>
+#include <ostream>
 #include <string>
 
 namespace DDS_ROOT_NAMESPACE {
 
 #define DdsVerify assert
 
+// branch prediction hints
+#if defined(__GNUC__) || defined(__clang__)
+#define DdsLikely(x) __builtin_expect(!!(x), 1)
+#define DdsUnlikely(x) __builtin_expect(!!(x), 0)
+#else
+#define DdsLikely(x) (x)
+#define DdsUnlikely(x) (x)
+#endif
+
 using String = std::string;
 
-// untill switch to C++17 or boost::string_view
-using StringView = std::string;
+/*
+ * Non-owning view of `size` characters, until switch to C++17 std::string_view. Long
+ * views are searched and compared by SSE2/AVX2 kernels chosen at runtime by CPUID, with
+ * scalar fallback (see string_kernels.h). It must not outlive the viewed characters.
+ */
+class StringView {
+public:
+   using value_type = char;
+   using size_type = std::size_t;
+   using const_iterator = const char *;
+   using iterator = const_iterator;
+
+   static constexpr std::size_t npos = detail::search_npos;
+
+   constexpr StringView() noexcept = default;
+   constexpr StringView(const char *str, std::size_t size) noexcept
+      : ptr{str}
+      , count{size} {}
+   StringView(const char *str) noexcept
+      : ptr{str}
+      , count{std::strlen(str)} {}
+   StringView(const String &str) noexcept
+      : ptr{str.data()}
+      , count{str.size()} {}
+
+   constexpr const char *data() const noexcept { return ptr; }
+   constexpr std::size_t size() const noexcept { return count; }
+   constexpr std::size_t length() const noexcept { return count; }
+   constexpr bool empty() const noexcept { return 0 == count; }
+
+   constexpr const_iterator begin() const noexcept { return ptr; }
+   constexpr const_iterator end() const noexcept { return ptr + count; }
+
+   constexpr char operator[](std::size_t pos) const { return ptr[pos]; }
+   constexpr char front() const { return ptr[0]; }
+   constexpr char back() const { return ptr[count - 1]; }
+
+   void remove_prefix(std::size_t n) {
+      DdsVerify(n <= count && "remove_prefix beyond the view");
+      ptr += n;
+      count -= n;
+   }
+
+   void remove_suffix(std::size_t n) {
+      DdsVerify(n <= count && "remove_suffix beyond the view");
+      count -= n;
+   }
+
+   // at most `n` characters from `pos`, which must be inside the view or at its end
+   StringView substr(std::size_t pos, std::size_t n = npos) const {
+      DdsVerify(pos <= count && "substr beyond the view");
+      return {ptr + pos, std::min(n, count - pos)};
+   }
+
+   String to_string() const { return {ptr, count}; }
+   explicit operator String() const { return to_string(); }
+
+   // negative, zero or positive as *this is before, equal or after `other`
+   int compare(StringView other) const noexcept {
+      auto common = std::min(count, other.count);
+      auto pos = detail::mismatch(ptr, other.ptr, common);
+      if (pos < common) {
+         return static_cast<unsigned char>(ptr[pos]) <
+                      static_cast<unsigned char>(other.ptr[pos])
+                   ? -1
+                   : 1;
+      }
+      return count == other.count ? 0 : (count < other.count ? -1 : 1);
+   }
+
+   bool equals(StringView other) const noexcept {
+      return count == other.count && detail::mismatch(ptr, other.ptr, count) == count;
+   }
+
+   bool starts_with(StringView prefix) const noexcept {
+      return count >= prefix.count &&
+             detail::mismatch(ptr, prefix.ptr, prefix.count) == prefix.count;
+   }
+
+   bool starts_with(char c) const noexcept { return count && ptr[0] == c; }
+
+   bool ends_with(StringView suffix) const noexcept {
+      return count >= suffix.count &&
+             detail::mismatch(end() - suffix.count, suffix.ptr, suffix.count) ==
+                suffix.count;
+   }
+
+   bool ends_with(char c) const noexcept { return count && ptr[count - 1] == c; }
+
+   // position of the first `needle` starting at `pos` or after it
+   std::size_t find(StringView needle, std::size_t pos = 0) const noexcept {
+      if (pos > count) {
+         return npos;
+      }
+      return detail::offset_pos(
+         detail::find(ptr + pos, count - pos, needle.ptr, needle.count), pos);
+   }
+
+   std::size_t find(char c, std::size_t pos = 0) const noexcept {
+      if (pos >= count) {
+         return npos;
+      }
+      return detail::offset_pos(detail::find_char(ptr + pos, count - pos, c), pos);
+   }
+
+   // position of the last `needle` starting at `pos` or before it
+   std::size_t rfind(StringView needle, std::size_t pos = npos) const noexcept {
+      if (needle.count > count) {
+         return npos;
+      }
+      auto last = std::min(pos, count - needle.count);
+      if (needle.empty()) {
+         return last;
+      }
+      // candidates by the first character, compared in full
+      for (auto candidates = last + 1;;) {
+         auto found = detail::rfind_char(ptr, candidates, needle.ptr[0]);
+         if (npos == found || !std::memcmp(ptr + found + 1,
+                                           needle.ptr + 1,
+                                           needle.count - 1)) {
+            return found;
+         }
+         candidates = found;
+      }
+   }
+
+   std::size_t rfind(char c, std::size_t pos = npos) const noexcept {
+      return detail::rfind_char(ptr, pos < count ? pos + 1 : count, c);
+   }
+
+   // position of the first character from `set` at `pos` or after it
+   std::size_t find_first_of(StringView set, std::size_t pos = 0) const noexcept {
+      if (pos >= count) {
+         return npos;
+      }
+      return detail::offset_pos(
+         detail::find_first_of(ptr + pos, count - pos, set.ptr, set.count), pos);
+   }
+
+   std::size_t find_first_of(char c, std::size_t pos = 0) const noexcept {
+      return find(c, pos);
+   }
+
+   std::size_t hash() const noexcept {
+      return static_cast<std::size_t>(detail::fnv1a(ptr, count));
+   }
+
+private:
+   const char *ptr{};
+   std::size_t count{};
+};
+
+inline bool operator==(StringView lhs, StringView rhs) noexcept {
+   return lhs.equals(rhs);
+}
+inline bool operator!=(StringView lhs, StringView rhs) noexcept {
+   return !lhs.equals(rhs);
+}
+inline bool operator<(StringView lhs, StringView rhs) noexcept {
+   return lhs.compare(rhs) < 0;
+}
+inline bool operator>(StringView lhs, StringView rhs) noexcept {
+   return lhs.compare(rhs) > 0;
+}
+inline bool operator<=(StringView lhs, StringView rhs) noexcept {
+   return lhs.compare(rhs) <= 0;
+}
+inline bool operator>=(StringView lhs, StringView rhs) noexcept {
+   return lhs.compare(rhs) >= 0;
+}
+
+inline std::ostream &operator<<(std::ostream &out, StringView str) {
+   return out.write(str.data(), static_cast<std::streamsize>(str.size()));
+}
 } // namespace DDS_ROOT_NAMESPACE
+
+namespace std {
+template <>
+struct hash<DDS_ROOT_NAMESPACE::StringView> {
+   std::size_t operator()(DDS_ROOT_NAMESPACE::StringView str) const noexcept {
+      return str.hash();
+   }
+};
+} // namespace std
@@ -0,0 +1,63 @@
+#pragma once
+
+#include <common/common.h>
+
+#include <memory>
+#include <type_traits>
+
+namespace DDS_ROOT_NAMESPACE {
+
+template <typename Sig>
+class function_ref_t;
+
+/*
+ * Non-owning reference to a callable, two pointers passed by value. The callable must
+ * outlive the reference, so it is meant for parameters of functions which call it before
+ * they return, not for storing.
+ */
+template <typename R, typename... Args>
+class function_ref_t<R(Args...)> {
+   template <typename F>
+   using enable_callable_t = std::enable_if_t<
+      !std::is_same<std::decay_t<F>, function_ref_t>::value &&
+      !std::is_function<std::remove_reference_t<F>>::value &&
+      std::is_convertible<std::result_of_t<F &(Args &&...)>, R>::value>;
+
+public:
+   template <typename F, typename = enable_callable_t<F>>
+   function_ref_t(F &&f) noexcept
+      : invoke{&invoke_callable<std::remove_reference_t<F>>} {
+      target.callable = const_cast<void *>(static_cast<const void *>(std::addressof(f)));
+   }
+
+   function_ref_t(R (*f)(Args...)) noexcept
+      : invoke{&invoke_function} {
+      DdsVerify(f && "function_ref_t of a null function");
+      target.function = f;
+   }
+
+   R operator()(Args... args) const {
+      return invoke(target, static_cast<Args &&>(args)...);
+   }
+
+private:
+   // passed by value to `invoke`, in a register
+   union target_t {
+      void *callable;
+      R (*function)(Args...);
+   };
+
+   template <typename F>
+   static R invoke_callable(target_t target, Args &&...args) {
+      return (*static_cast<F *>(target.callable))(static_cast<Args &&>(args)...);
+   }
+
+   static R invoke_function(target_t target, Args &&...args) {
+      return target.function(static_cast<Args &&>(args)...);
+   }
+
+   target_t target;
+   R (*invoke)(target_t, Args &&...);
+};
+
+} // namespace DDS_ROOT_NAMESPACE
@@ -0,0 +1,220 @@
+#pragma once
+
+#include <common/common.h>
+
+#include <cstddef>
+#include <exception>
+#include <new>
+#include <type_traits>
+#include <utility>
+
+namespace DDS_ROOT_NAMESPACE {
+
+namespace detail {
+// operations on a callable of type F stored in a buffer
+template <bool Copyable, typename R, typename... Args>
+struct inplace_vtable_t {
+   R (*invoke)(void *storage, Args &&...args);
+   void (*copy)(void *to, const void *from); // nullptr when not copyable
+   void (*move)(void *to, void *from);       // moves and destroys `from`
+   void (*destroy)(void *storage);
+};
+
+template <typename R, typename... Args>
+R empty_invoke(void *, Args &&...) {
+   DdsVerify(!"Call of an empty inplace_function_t");
+   std::terminate();
+}
+
+inline void empty_copy(void *, const void *) {}
+inline void empty_move(void *, void *) {}
+inline void empty_destroy(void *) {}
+
+template <bool Copyable, typename R, typename... Args>
+struct empty_vtable_t {
+   static constexpr inplace_vtable_t<Copyable, R, Args...> value{
+      &empty_invoke<R, Args...>, &empty_copy, &empty_move, &empty_destroy};
+};
+
+template <bool Copyable, typename R, typename... Args>
+constexpr inplace_vtable_t<Copyable, R, Args...>
+   empty_vtable_t<Copyable, R, Args...>::value;
+
+template <typename F, typename R, typename... Args>
+R callable_invoke(void *storage, Args &&...args) {
+   return (*static_cast<F *>(storage))(static_cast<Args &&>(args)...);
+}
+
+template <typename F>
+void callable_copy(void *to, const void *from) {
+   new (to) F(*static_cast<const F *>(from));
+}
+
+template <typename F>
+void callable_move(void *to, void *from) {
+   new (to) F(std::move(*static_cast<F *>(from)));
+   static_cast<F *>(from)->~F();
+}
+
+template <typename F>
+void callable_destroy(void *storage) {
+   static_cast<F *>(storage)->~F();
+}
+
+// copy of a move-only function isn't instantiated, F may not be copyable
+template <typename F>
+constexpr auto callable_copy_of(std::true_type) {
+   return &callable_copy<F>;
+}
+
+template <typename F>
+constexpr void (*callable_copy_of(std::false_type))(void *, const void *) {
+   return nullptr;
+}
+
+template <typename F, bool Copyable, typename R, typename... Args>
+struct callable_vtable_t {
+   static constexpr inplace_vtable_t<Copyable, R, Args...> value{
+      &callable_invoke<F, R, Args...>,
+      callable_copy_of<F>(std::integral_constant<bool, Copyable>{}),
+      &callable_move<F>,
+      &callable_destroy<F>};
+};
+
+template <typename F, bool Copyable, typename R, typename... Args>
+constexpr inplace_vtable_t<Copyable, R, Args...>
+   callable_vtable_t<F, Copyable, R, Args...>::value;
+
+// parameter of the copy operations of a move-only function, so they aren't declared
+struct no_copy_t {};
+} // namespace detail
+
+template <typename Sig, std::size_t Capacity, std::size_t Alignment, bool Copyable>
+class basic_inplace_function_t;
+
+/*
+ * Type erased callable stored in a buffer of `Capacity` bytes inside the object, it never
+ * allocates. A callable which doesn't fit the size or the alignment is a compile error.
+ * The call is a single indirect call, copy and move go through a table of the callable
+ * type. Callables must be nothrow move constructible, the move-only flavour
+ * (inplace_move_function_t) takes also callables which can't be copied.
+ */
+template <typename R,
+          typename... Args,
+          std::size_t Capacity,
+          std::size_t Alignment,
+          bool Copyable>
+class basic_inplace_function_t<R(Args...), Capacity, Alignment, Copyable> {
+   using vtable_t = detail::inplace_vtable_t<Copyable, R, Args...>;
+   using copy_t =
+      std::conditional_t<Copyable, basic_inplace_function_t, detail::no_copy_t>;
+
+   template <typename F>
+   using enable_callable_t = std::enable_if_t<
+      !std::is_same<std::decay_t<F>, basic_inplace_function_t>::value &&
+      std::is_convertible<std::result_of_t<std::decay_t<F> &(Args &&...)>, R>::value>;
+
+public:
+   static constexpr std::size_t capacity = Capacity;
+   static constexpr std::size_t alignment = Alignment;
+
+   basic_inplace_function_t() noexcept = default;
+   basic_inplace_function_t(std::nullptr_t) noexcept {}
+
+   template <typename F, typename = enable_callable_t<F>>
+   basic_inplace_function_t(F &&f) {
+      using callable_t = std::decay_t<F>;
+      static_assert(sizeof(callable_t) <= Capacity,
+                    "Callable doesn't fit the capacity of inplace_function_t");
+      static_assert(Alignment % alignof(callable_t) == 0,
+                    "Callable doesn't fit the alignment of inplace_function_t");
+      static_assert(std::is_nothrow_move_constructible<callable_t>::value,
+                    "Callable must be nothrow move constructible");
+      static_assert(!Copyable || std::is_copy_constructible<callable_t>::value,
+                    "Callable can't be copied, use inplace_move_function_t");
+      new (&storage) callable_t(static_cast<F &&>(f));
+      vtable = &detail::callable_vtable_t<callable_t, Copyable, R, Args...>::value;
+   }
+
+   basic_inplace_function_t(const copy_t &other) {
+      other.vtable->copy(&storage, &other.storage);
+      vtable = other.vtable;
+   }
+
+   basic_inplace_function_t(basic_inplace_function_t &&other) noexcept {
+      other.vtable->move(&storage, &other.storage);
+      vtable = other.vtable;
+      other.vtable = empty();
+   }
+
+   ~basic_inplace_function_t() { vtable->destroy(&storage); }
+
+   basic_inplace_function_t &operator=(const copy_t &other) {
+      if (this != &other) {
+         *this = basic_inplace_function_t{other};
+      }
+      return *this;
+   }
+
+   basic_inplace_function_t &operator=(basic_inplace_function_t &&other) noexcept {
+      if (this != &other) {
+         vtable->destroy(&storage);
+         other.vtable->move(&storage, &other.storage);
+         vtable = other.vtable;
+         other.vtable = empty();
+      }
+      return *this;
+   }
+
+   basic_inplace_function_t &operator=(std::nullptr_t) noexcept {
+      vtable->destroy(&storage);
+      vtable = empty();
+      return *this;
+   }
+
+   explicit operator bool() const noexcept { return vtable != empty(); }
+
+   R operator()(Args... args) const {
+      return vtable->invoke(&storage, static_cast<Args &&>(args)...);
+   }
+
+private:
+   static constexpr const vtable_t *empty() {
+      return &detail::empty_vtable_t<Copyable, R, Args...>::value;
+   }
+
+   const vtable_t *vtable{empty()};
+   mutable std::aligned_storage_t<Capacity, Alignment> storage;
+};
+
+template <typename R,
+          typename... Args,
+          std::size_t Capacity,
+          std::size_t Alignment,
+          bool Copyable>
+constexpr std::size_t
+   basic_inplace_function_t<R(Args...), Capacity, Alignment, Copyable>::capacity;
+
+template <typename R,
+          typename... Args,
+          std::size_t Capacity,
+          std::size_t Alignment,
+          bool Copyable>
+constexpr std::size_t
+   basic_inplace_function_t<R(Args...), Capacity, Alignment, Copyable>::alignment;
+
+// four pointers, enough for the usual lambda capturing a few references
+const std::size_t inplace_function_capacity = 4 * sizeof(void *);
+
+template <typename Sig,
+          std::size_t Capacity = inplace_function_capacity,
+          std::size_t Alignment = alignof(std::max_align_t)>
+using inplace_function_t = basic_inplace_function_t<Sig, Capacity, Alignment, true>;
+
+template <typename Sig,
+          std::size_t Capacity = inplace_function_capacity,
+          std::size_t Alignment = alignof(std::max_align_t)>
+using inplace_move_function_t =
+   basic_inplace_function_t<Sig, Capacity, Alignment, false>;
+
+} // namespace DDS_ROOT_NAMESPACE
@@ -0,0 +1,413 @@
+#pragma once
+
+#include <common/config.h>
+
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+
+// SSE2 is part of x86-64, AVX2 kernels are compiled with a target attribute
+#if (defined(__GNUC__) || defined(__clang__)) && defined(__SSE2__) &&                  \
+   (defined(__x86_64__) || defined(__i386__))
+#define DDS_STRING_KERNELS_SIMD 1
+#include <immintrin.h>
+#define DDS_TARGET_AVX2 __attribute__((target("avx2")))
+#else
+#define DDS_STRING_KERNELS_SIMD 0
+#endif
+
+namespace DDS_ROOT_NAMESPACE {
+namespace detail {
+
+const std::size_t search_npos = static_cast<std::size_t>(-1);
+
+// views shorter than this are searched by the scalar kernels, without indirect call
+const std::size_t short_string = 16;
+
+/*
+ * Search and compare kernels of StringView. The searches return the position of the
+ * first (last for rfind_char) match or search_npos, mismatch returns the first position
+ * where `a` and `b` differ or `size`. find expects a needle of at least two characters
+ * not longer than `size`, find_first_of a set of at most `max_set` characters.
+ */
+struct string_kernels_t {
+   static constexpr std::size_t max_set = 16;
+
+   std::size_t (*find_char)(const char *str, std::size_t size, char c);
+   std::size_t (*rfind_char)(const char *str, std::size_t size, char c);
+   std::size_t (*find)(const char *str,
+                       std::size_t size,
+                       const char *needle,
+                       std::size_t needle_size);
+   std::size_t (*find_first_of)(const char *str,
+                                std::size_t size,
+                                const char *set,
+                                std::size_t set_size);
+   std::size_t (*mismatch)(const char *a, const char *b, std::size_t size);
+};
+
+inline std::size_t offset_pos(std::size_t pos, std::size_t offset) {
+   return search_npos == pos ? pos : offset + pos;
+}
+
+struct scalar_kernels_t {
+   static std::size_t find_char(const char *str, std::size_t size, char c) {
+      for (std::size_t i = 0; i < size; ++i) {
+         if (str[i] == c) {
+            return i;
+         }
+      }
+      return search_npos;
+   }
+
+   static std::size_t rfind_char(const char *str, std::size_t size, char c) {
+      for (auto i = size; i-- > 0;) {
+         if (str[i] == c) {
+            return i;
+         }
+      }
+      return search_npos;
+   }
+
+   static std::size_t find(const char *str,
+                           std::size_t size,
+                           const char *needle,
+                           std::size_t needle_size) {
+      auto last = needle_size - 1;
+      for (std::size_t i = 0; i + needle_size <= size; ++i) {
+         if (str[i] == needle[0] && str[i + last] == needle[last] &&
+             !std::memcmp(str + i + 1, needle + 1, needle_size - 2)) {
+            return i;
+         }
+      }
+      return search_npos;
+   }
+
+   static std::size_t find_first_of(const char *str,
+                                    std::size_t size,
+                                    const char *set,
+                                    std::size_t set_size) {
+      for (std::size_t i = 0; i < size; ++i) {
+         for (std::size_t j = 0; j < set_size; ++j) {
+            if (str[i] == set[j]) {
+               return i;
+            }
+         }
+      }
+      return search_npos;
+   }
+
+   static std::size_t mismatch(const char *a, const char *b, std::size_t size) {
+      std::size_t i{};
+      while (i < size && a[i] == b[i]) {
+         ++i;
+      }
+      return i;
+   }
+};
+
+#if DDS_STRING_KERNELS_SIMD
+/*
+ * 16 characters per step. The needle of find is matched by its first and last character
+ * over a whole block, only the candidates are compared in full.
+ */
+struct sse2_kernels_t {
+   static __m128i load(const char *str) {
+      return _mm_loadu_si128(reinterpret_cast<const __m128i *>(str));
+   }
+
+   static unsigned equal_mask(__m128i a, __m128i b) {
+      return static_cast<unsigned>(_mm_movemask_epi8(_mm_cmpeq_epi8(a, b)));
+   }
+
+   static std::size_t find_char(const char *str, std::size_t size, char c) {
+      auto pattern = _mm_set1_epi8(c);
+      std::size_t i{};
+      for (; i + 16 <= size; i += 16) {
+         if (auto mask = equal_mask(load(str + i), pattern)) {
+            return i + static_cast<std::size_t>(__builtin_ctz(mask));
+         }
+      }
+      return offset_pos(scalar_kernels_t::find_char(str + i, size - i, c), i);
+   }
+
+   static std::size_t rfind_char(const char *str, std::size_t size, char c) {
+      auto pattern = _mm_set1_epi8(c);
+      auto end = size;
+      for (; end >= 16; end -= 16) {
+         if (auto mask = equal_mask(load(str + end - 16), pattern)) {
+            return end - 16 + static_cast<std::size_t>(31 - __builtin_clz(mask));
+         }
+      }
+      return scalar_kernels_t::rfind_char(str, end, c);
+   }
+
+   static std::size_t find(const char *str,
+                           std::size_t size,
+                           const char *needle,
+                           std::size_t needle_size) {
+      auto last = needle_size - 1;
+      auto first_pattern = _mm_set1_epi8(needle[0]);
+      auto last_pattern = _mm_set1_epi8(needle[last]);
+      std::size_t i{};
+      for (; i + last + 16 <= size; i += 16) {
+         auto mask = equal_mask(load(str + i), first_pattern) &
+                     equal_mask(load(str + i + last), last_pattern);
+         for (; mask; mask &= mask - 1) {
+            auto pos = i + static_cast<std::size_t>(__builtin_ctz(mask));
+            if (!std::memcmp(str + pos + 1, needle + 1, needle_size - 2)) {
+               return pos;
+            }
+         }
+      }
+      return offset_pos(scalar_kernels_t::find(str + i, size - i, needle, needle_size),
+                        i);
+   }
+
+   static std::size_t find_first_of(const char *str,
+                                    std::size_t size,
+                                    const char *set,
+                                    std::size_t set_size) {
+      __m128i patterns[string_kernels_t::max_set];
+      for (std::size_t j = 0; j < set_size; ++j) {
+         patterns[j] = _mm_set1_epi8(set[j]);
+      }
+      std::size_t i{};
+      for (; i + 16 <= size; i += 16) {
+         auto block = load(str + i);
+         unsigned mask{};
+         for (std::size_t j = 0; j < set_size; ++j) {
+            mask |= equal_mask(block, patterns[j]);
+         }
+         if (mask) {
+            return i + static_cast<std::size_t>(__builtin_ctz(mask));
+         }
+      }
+      return offset_pos(
+         scalar_kernels_t::find_first_of(str + i, size - i, set, set_size), i);
+   }
+
+   static std::size_t mismatch(const char *a, const char *b, std::size_t size) {
+      std::size_t i{};
+      for (; i + 16 <= size; i += 16) {
+         if (auto mask = ~equal_mask(load(a + i), load(b + i)) & 0xffff) {
+            return i + static_cast<std::size_t>(__builtin_ctz(mask));
+         }
+      }
+      return i + scalar_kernels_t::mismatch(a + i, b + i, size - i);
+   }
+};
+
+// 32 characters per step, the rest goes to the SSE2 kernels
+struct avx2_kernels_t {
+   DDS_TARGET_AVX2 static __m256i load(const char *str) {
+      return _mm256_loadu_si256(reinterpret_cast<const __m256i *>(str));
+   }
+
+   DDS_TARGET_AVX2 static unsigned equal_mask(__m256i a, __m256i b) {
+      return static_cast<unsigned>(_mm256_movemask_epi8(_mm256_cmpeq_epi8(a, b)));
+   }
+
+   DDS_TARGET_AVX2 static std::size_t find_char(const char *str,
+                                                std::size_t size,
+                                                char c) {
+      auto pattern = _mm256_set1_epi8(c);
+      std::size_t i{};
+      // 128 characters tested by a single branch
+      for (; i + 128 <= size; i += 128) {
+         auto eq0 = _mm256_cmpeq_epi8(load(str + i), pattern);
+         auto eq1 = _mm256_cmpeq_epi8(load(str + i + 32), pattern);
+         auto eq2 = _mm256_cmpeq_epi8(load(str + i + 64), pattern);
+         auto eq3 = _mm256_cmpeq_epi8(load(str + i + 96), pattern);
+         auto any = _mm256_or_si256(_mm256_or_si256(eq0, eq1), _mm256_or_si256(eq2, eq3));
+         if (_mm256_movemask_epi8(any)) {
+            break;
+         }
+      }
+      for (; i + 32 <= size; i += 32) {
+         if (auto mask = equal_mask(load(str + i), pattern)) {
+            return i + static_cast<std::size_t>(__builtin_ctz(mask));
+         }
+      }
+      return offset_pos(sse2_kernels_t::find_char(str + i, size - i, c), i);
+   }
+
+   DDS_TARGET_AVX2 static std::size_t rfind_char(const char *str,
+                                                 std::size_t size,
+                                                 char c) {
+      auto pattern = _mm256_set1_epi8(c);
+      auto end = size;
+      for (; end >= 32; end -= 32) {
+         if (auto mask = equal_mask(load(str + end - 32), pattern)) {
+            return end - 32 + static_cast<std::size_t>(31 - __builtin_clz(mask));
+         }
+      }
+      return sse2_kernels_t::rfind_char(str, end, c);
+   }
+
+   DDS_TARGET_AVX2 static std::size_t find(const char *str,
+                                           std::size_t size,
+                                           const char *needle,
+                                           std::size_t needle_size) {
+      auto last = needle_size - 1;
+      auto first_pattern = _mm256_set1_epi8(needle[0]);
+      auto last_pattern = _mm256_set1_epi8(needle[last]);
+      std::size_t i{};
+      for (; i + last + 32 <= size; i += 32) {
+         auto mask = equal_mask(load(str + i), first_pattern) &
+                     equal_mask(load(str + i + last), last_pattern);
+         for (; mask; mask &= mask - 1) {
+            auto pos = i + static_cast<std::size_t>(__builtin_ctz(mask));
+            if (!std::memcmp(str + pos + 1, needle + 1, needle_size - 2)) {
+               return pos;
+            }
+         }
+      }
+      return offset_pos(sse2_kernels_t::find(str + i, size - i, needle, needle_size), i);
+   }
+
+   DDS_TARGET_AVX2 static std::size_t find_first_of(const char *str,
+                                                    std::size_t size,
+                                                    const char *set,
+                                                    std::size_t set_size) {
+      __m256i patterns[string_kernels_t::max_set];
+      for (std::size_t j = 0; j < set_size; ++j) {
+         patterns[j] = _mm256_set1_epi8(set[j]);
+      }
+      std::size_t i{};
+      for (; i + 32 <= size; i += 32) {
+         auto block = load(str + i);
+         unsigned mask{};
+         for (std::size_t j = 0; j < set_size; ++j) {
+            mask |= equal_mask(block, patterns[j]);
+         }
+         if (mask) {
+            return i + static_cast<std::size_t>(__builtin_ctz(mask));
+         }
+      }
+      return offset_pos(sse2_kernels_t::find_first_of(str + i, size - i, set, set_size),
+                        i);
+   }
+
+   DDS_TARGET_AVX2 static std::size_t mismatch(const char *a,
+                                               const char *b,
+                                               std::size_t size) {
+      std::size_t i{};
+      for (; i + 128 <= size; i += 128) {
+         auto eq0 = _mm256_cmpeq_epi8(load(a + i), load(b + i));
+         auto eq1 = _mm256_cmpeq_epi8(load(a + i + 32), load(b + i + 32));
+         auto eq2 = _mm256_cmpeq_epi8(load(a + i + 64), load(b + i + 64));
+         auto eq3 = _mm256_cmpeq_epi8(load(a + i + 96), load(b + i + 96));
+         auto all =
+            _mm256_and_si256(_mm256_and_si256(eq0, eq1), _mm256_and_si256(eq2, eq3));
+         if (~_mm256_movemask_epi8(all)) {
+            break;
+         }
+      }
+      for (; i + 32 <= size; i += 32) {
+         if (auto mask = ~equal_mask(load(a + i), load(b + i))) {
+            return i + static_cast<std::size_t>(__builtin_ctz(mask));
+         }
+      }
+      return i + sse2_kernels_t::mismatch(a + i, b + i, size - i);
+   }
+};
+#endif
+
+template <typename Kernels>
+const string_kernels_t &kernels_of() {
+   static const string_kernels_t kernels{&Kernels::find_char,
+                                         &Kernels::rfind_char,
+                                         &Kernels::find,
+                                         &Kernels::find_first_of,
+                                         &Kernels::mismatch};
+   return kernels;
+}
+
+// the widest kernels supported by the CPU
+inline const string_kernels_t &select_string_kernels() {
+#if DDS_STRING_KERNELS_SIMD
+   __builtin_cpu_init();
+   if (__builtin_cpu_supports("avx2")) {
+      return kernels_of<avx2_kernels_t>();
+   }
+   return kernels_of<sse2_kernels_t>();
+#else
+   return kernels_of<scalar_kernels_t>();
+#endif
+}
+
+inline const string_kernels_t &string_kernels() {
+   static const string_kernels_t &kernels = select_string_kernels();
+   return kernels;
+}
+
+/*
+ * Entry points of StringView: short views go to the scalar kernels directly, the
+ * needles and sets are checked here.
+ */
+inline std::size_t find_char(const char *str, std::size_t size, char c) {
+   return size < short_string ? scalar_kernels_t::find_char(str, size, c)
+                              : string_kernels().find_char(str, size, c);
+}
+
+inline std::size_t rfind_char(const char *str, std::size_t size, char c) {
+   return size < short_string ? scalar_kernels_t::rfind_char(str, size, c)
+                              : string_kernels().rfind_char(str, size, c);
+}
+
+inline std::size_t find(const char *str,
+                        std::size_t size,
+                        const char *needle,
+                        std::size_t needle_size) {
+   if (needle_size > size) {
+      return search_npos;
+   }
+   if (needle_size < 2) {
+      return needle_size ? find_char(str, size, needle[0]) : 0;
+   }
+   return size < short_string ? scalar_kernels_t::find(str, size, needle, needle_size)
+                              : string_kernels().find(str, size, needle, needle_size);
+}
+
+inline std::size_t find_first_of(const char *str,
+                                 std::size_t size,
+                                 const char *set,
+                                 std::size_t set_size) {
+   if (set_size < 2) {
+      return set_size ? find_char(str, size, set[0]) : search_npos;
+   }
+   if (set_size > string_kernels_t::max_set) {
+      bool in_set[256]{};
+      for (std::size_t j = 0; j < set_size; ++j) {
+         in_set[static_cast<unsigned char>(set[j])] = true;
+      }
+      for (std::size_t i = 0; i < size; ++i) {
+         if (in_set[static_cast<unsigned char>(str[i])]) {
+            return i;
+         }
+      }
+      return search_npos;
+   }
+   return size < short_string
+             ? scalar_kernels_t::find_first_of(str, size, set, set_size)
+             : string_kernels().find_first_of(str, size, set, set_size);
+}
+
+inline std::size_t mismatch(const char *a, const char *b, std::size_t size) {
+   return size < short_string ? scalar_kernels_t::mismatch(a, b, size)
+                              : string_kernels().mismatch(a, b, size);
+}
+
+// 64-bit FNV-1a
+constexpr std::uint64_t fnv1a(const char *str, std::size_t size) {
+   std::uint64_t hash{0xcbf29ce484222325ull};
+   for (std::size_t i = 0; i < size; ++i) {
+      hash ^= static_cast<unsigned char>(str[i]);
+      hash *= 0x100000001b3ull;
+   }
+   return hash;
+}
+
+} // namespace detail
+} // namespace DDS_ROOT_NAMESPACE
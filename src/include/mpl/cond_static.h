@@ -0,0 +1,75 @@
+#pragma once
+
+#include <mpl/config.h>
+#include <mpl/if_static.h>
+#include <mpl/nth_arg.h>
+
+#include <cstddef>
+#include <type_traits>
+
+namespace DDS_ROOT_NAMESPACE {
+namespace DDS_MPL_NAMESPACE {
+
+namespace detail {
+// predicate is bool_t or a type derived from it (std::is_same<...> etc.)
+template <typename T>
+using is_static_pred_t = bool_t<std::is_base_of<true_t, std::decay_t<T>>::value ||
+                                std::is_base_of<false_t, std::decay_t<T>>::value>;
+
+template <typename T>
+using static_pred_value_t = std::is_base_of<true_t, std::decay_t<T>>;
+
+// every argument but the last one at an even position is a predicate
+template <std::size_t N>
+constexpr bool cond_static_valid(const bool (&is_pred)[N]) {
+   for (std::size_t i = 0; i + 1 < N; i += 2) {
+      if (!is_pred[i]) {
+         return false;
+      }
+   }
+   return true;
+}
+
+// index of the branch of the first true predicate, the last argument if none is true
+template <std::size_t N>
+constexpr std::size_t cond_static_index(const bool (&value)[N]) {
+   for (std::size_t i = 0; i + 1 < N; i += 2) {
+      if (value[i]) {
+         return i + 1;
+      }
+   }
+   return N - 1;
+}
+
+template <std::size_t Index, typename... Ts>
+constexpr forwarded_t<nth_arg_t<Index, Ts...>> cond_static_apply(Ts &&... args) {
+   return nth_arg<Index>(static_cast<Ts &&>(args)...);
+}
+} // namespace detail
+
+/*
+ * N-way if_static: cond_static(pred1, f1, pred2, f2, ..., default) selects the branch
+ * of the first true predicate, `default` when none is true. Predicates are bool_t
+ * (or types derived from it) and the branch is forwarded as in if_static. The branch is
+ * found by a constexpr loop, so the instantiation depth doesn't grow with the number
+ * of branches.
+ */
+struct cond_static_t {
+   template <typename... Ts>
+   constexpr decltype(auto) operator()(Ts &&... args) const {
+      static_assert(sizeof...(Ts) % 2, "cond_static expects pairs and a default branch");
+      constexpr bool is_pred[] = {detail::is_static_pred_t<Ts>::value...};
+      constexpr bool value[] = {detail::static_pred_value_t<Ts>::value...};
+      static_assert(detail::cond_static_valid(is_pred),
+                    "cond_static predicate must be bool_t");
+      return detail::cond_static_apply<detail::cond_static_index(value)>(
+         static_cast<Ts &&>(args)...);
+   }
+};
+
+constexpr cond_static_t cond_static{};
+
+inline void avoid_unused_cond_static() { (void)cond_static; }
+
+} // namespace DDS_MPL_NAMESPACE
+} // namespace DDS_ROOT_NAMESPACE
@@ -0,0 +1,205 @@
+#pragma once
+
+#include <common/common.h>
+#include <mpl/config.h>
+
+#include <cstddef>
+#include <type_traits>
+#include <utility>
+
+namespace DDS_ROOT_NAMESPACE {
+namespace DDS_MPL_NAMESPACE {
+
+template <int value>
+using int_t = std::integral_constant<int, value>;
+
+// closed range [Min, Max] of values of dispatch_static_product
+template <int Min, int Max>
+struct static_range_t {
+   static_assert(Min <= Max, "Empty range");
+
+   static constexpr int min = Min;
+   static constexpr std::size_t size = static_cast<std::size_t>(Max - Min) + 1;
+};
+
+namespace detail {
+/*
+ * Table of functions calling `f` with `std::integral_constant<T, Min + I>` for every I,
+ * a runtime value is dispatched by a single indirect call.
+ */
+template <typename T, T Min, typename R, typename F, typename Seq>
+struct dispatch_table_t;
+
+template <typename T, T Min, typename R, typename F, std::size_t... Is>
+struct dispatch_table_t<T, Min, R, F, std::index_sequence<Is...>> {
+   template <std::size_t I>
+   static R call(F &&f) {
+      constexpr auto value = static_cast<T>(static_cast<long long>(Min) + I);
+      return static_cast<F &&>(f)(std::integral_constant<T, value>{});
+   }
+
+   static constexpr R (*table[])(F &&) = {&call<Is>...};
+};
+
+template <typename T, T Min, typename R, typename F, std::size_t... Is>
+constexpr R (*dispatch_table_t<T, Min, R, F, std::index_sequence<Is...>>::table[])(F &&);
+
+template <typename T, T Min, T Max, typename F>
+using dispatch_result_t = decltype(std::declval<F>()(std::integral_constant<T, Min>{}));
+
+// position of `value` in [Min, Max], `size` when it is out of the range
+template <typename T, T Min, T Max>
+constexpr std::size_t dispatch_index(T value) {
+   auto offset = static_cast<long long>(value) - static_cast<long long>(Min);
+   auto size = static_cast<long long>(Max) - static_cast<long long>(Min) + 1;
+   return static_cast<std::size_t>(offset >= 0 && offset < size ? offset : size);
+}
+
+template <typename T, T Min, T Max, typename F>
+decltype(auto) dispatch_value(std::size_t index, F &&f) {
+   static_assert(Min <= Max, "Empty range");
+   constexpr auto size = static_cast<std::size_t>(static_cast<long long>(Max) -
+                                                  static_cast<long long>(Min)) +
+                         1;
+   using Table = dispatch_table_t<T,
+                                  Min,
+                                  dispatch_result_t<T, Min, Max, F>,
+                                  F,
+                                  std::make_index_sequence<size>>;
+   return Table::table[index](static_cast<F &&>(f));
+}
+
+template <typename... Ranges>
+struct static_ranges_t {};
+
+// value of dimension D for flat index K of the cartesian product, the last one varies
+// fastest
+template <typename... Ranges>
+constexpr int product_value(std::size_t k, std::size_t d) {
+   constexpr int mins[] = {Ranges::min...};
+   constexpr std::size_t sizes[] = {Ranges::size...};
+   for (auto i = sizeof...(Ranges) - 1; i > d; --i) {
+      k /= sizes[i];
+   }
+   return mins[d] + static_cast<int>(k % sizes[d]);
+}
+
+template <typename R, typename F, typename Ranges, typename Dims, typename Seq>
+struct product_table_t;
+
+template <typename R,
+          typename F,
+          typename... Ranges,
+          std::size_t... Ds,
+          std::size_t... Ks>
+struct product_table_t<R,
+                       F,
+                       static_ranges_t<Ranges...>,
+                       std::index_sequence<Ds...>,
+                       std::index_sequence<Ks...>> {
+   template <std::size_t K>
+   static R call(F &&f) {
+      return static_cast<F &&>(f)(int_t<product_value<Ranges...>(K, Ds)>{}...);
+   }
+
+   static constexpr R (*table[])(F &&) = {&call<Ks>...};
+};
+
+template <typename R,
+          typename F,
+          typename... Ranges,
+          std::size_t... Ds,
+          std::size_t... Ks>
+constexpr R (*product_table_t<R,
+                              F,
+                              static_ranges_t<Ranges...>,
+                              std::index_sequence<Ds...>,
+                              std::index_sequence<Ks...>>::table[])(F &&);
+
+template <typename... Ranges>
+constexpr std::size_t product_size() {
+   constexpr std::size_t sizes[] = {Ranges::size...};
+   std::size_t ret = 1;
+   for (auto size : sizes) {
+      ret *= size;
+   }
+   return ret;
+}
+
+// flat index of `values`, product_size() when any of them is out of its range
+template <typename... Ranges>
+constexpr std::size_t product_index(const int (&values)[sizeof...(Ranges)]) {
+   constexpr int mins[] = {Ranges::min...};
+   constexpr std::size_t sizes[] = {Ranges::size...};
+   std::size_t ret{};
+   for (std::size_t d = 0; d < sizeof...(Ranges); ++d) {
+      auto offset = static_cast<long long>(values[d]) - mins[d];
+      if (offset < 0 || offset >= static_cast<long long>(sizes[d])) {
+         return product_size<Ranges...>();
+      }
+      ret = ret * sizes[d] + static_cast<std::size_t>(offset);
+   }
+   return ret;
+}
+} // namespace detail
+
+/*
+ * Runtime to compile-time dispatch: calls `f(int_t<value>{})` for `value` in
+ * [Min, Max], so `f` is instantiated for every value of the range and the call is a
+ * single indirect call through a table, not a chain of comparisons. All instantiations
+ * should return the same type. `value` must be in the range, the overload with
+ * `otherwise` calls `otherwise(value)` when it isn't.
+ */
+template <int Min, int Max, typename F>
+decltype(auto) dispatch_static(int value, F &&f) {
+   auto index = detail::dispatch_index<int, Min, Max>(value);
+   DdsVerify(index <= static_cast<std::size_t>(Max - Min) && "value out of range");
+   return detail::dispatch_value<int, Min, Max>(index, static_cast<F &&>(f));
+}
+
+template <int Min, int Max, typename F, typename Otherwise>
+decltype(auto) dispatch_static(int value, F &&f, Otherwise &&otherwise) {
+   auto index = detail::dispatch_index<int, Min, Max>(value);
+   if (index > static_cast<std::size_t>(Max - Min)) {
+      return static_cast<Otherwise &&>(otherwise)(value);
+   }
+   return detail::dispatch_value<int, Min, Max>(index, static_cast<F &&>(f));
+}
+
+/*
+ * dispatch_static for enumerators of E in [Min, Max], `f` is called with
+ * `std::integral_constant<E, value>`. Values of the range which are not enumerators
+ * are instantiated too.
+ */
+template <typename E, E Min, E Max, typename F>
+decltype(auto) dispatch_enum(E value, F &&f) {
+   static_assert(std::is_enum<E>::value, "dispatch_enum expects an enum");
+   auto index = detail::dispatch_index<E, Min, Max>(value);
+   DdsVerify(index <= static_cast<std::size_t>(static_cast<long long>(Max) -
+                                              static_cast<long long>(Min)) &&
+             "value out of range");
+   return detail::dispatch_value<E, Min, Max>(index, static_cast<F &&>(f));
+}
+
+/*
+ * dispatch_static over the cartesian product of several runtime values:
+ *    dispatch_static_product<static_range_t<1, 4>, static_range_t<0, 1>>({w, b}, f)
+ * calls `f(int_t<w>{}, int_t<b>{})` through a single table of all the combinations.
+ */
+template <typename... Ranges, typename F>
+decltype(auto) dispatch_static_product(const int (&values)[sizeof...(Ranges)], F &&f) {
+   static_assert(sizeof...(Ranges) > 0, "dispatch_static_product expects ranges");
+   constexpr auto size = detail::product_size<Ranges...>();
+   auto index = detail::product_index<Ranges...>(values);
+   DdsVerify(index < size && "value out of range");
+   using R = decltype(std::declval<F>()(int_t<Ranges::min>{}...));
+   using Table = detail::product_table_t<R,
+                                         F,
+                                         detail::static_ranges_t<Ranges...>,
+                                         std::index_sequence_for<Ranges...>,
+                                         std::make_index_sequence<size>>;
+   return Table::table[index](static_cast<F &&>(f));
+}
+
+} // namespace DDS_MPL_NAMESPACE
+} // namespace DDS_ROOT_NAMESPACE
@@ -9,10 +9,26 @@
 namespace DDS_ROOT_NAMESPACE {
 namespace DDS_MPL_NAMESPACE {
 
+namespace detail {
+// the selected callback is called in place, it is neither copied nor moved
+struct exec_if_impl_t {
+   template <typename T, typename F>
+   static constexpr decltype(auto) apply(true_t, T &&t, F &&) {
+      return static_cast<T &&>(t)(identity);
+   }
+
+   template <typename T, typename F>
+   static constexpr decltype(auto) apply(false_t, T &&, F &&f) {
+      return static_cast<F &&>(f)(identity);
+   }
+};
+} // namespace detail
+
 struct exec_if_t {
    template <typename Cond, typename T, typename F>
-   decltype(auto) operator()(Cond cond, T &&t, F &&f) const {
-      return if_static(cond, static_cast<T &&>(t), static_cast<F &&>(f))(identity);
+   constexpr decltype(auto) operator()(Cond cond, T &&t, F &&f) const {
+      return detail::exec_if_impl_t::apply(
+         cond, static_cast<T &&>(t), static_cast<F &&>(f));
    }
 };
 
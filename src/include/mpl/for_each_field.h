@@ -0,0 +1,262 @@
+#pragma once
+
+#include <common/common.h>
+#include <mpl/config.h>
+#include <mpl/if_static.h>
+#include <mpl/static_for.h>
+#include <mpl/type_list.h>
+#include <mpl/type_tag.h>
+
+#include <cstddef>
+#include <cstring>
+#include <exception>
+#include <new>
+#include <tuple>
+#include <type_traits>
+#include <utility>
+
+namespace DDS_ROOT_NAMESPACE {
+namespace DDS_MPL_NAMESPACE {
+
+namespace detail {
+// converts to any field type, so an aggregate is initialized by N of them when it has N
+// fields (or more, the rest is value-initialized)
+struct any_field_t {
+   template <typename U>
+   constexpr operator U &() const && noexcept;
+};
+
+template <std::size_t>
+using any_field_at_t = any_field_t;
+
+template <typename T, typename Seq, typename = void>
+struct initializable_t : false_t {};
+
+template <typename T, std::size_t... Is>
+struct initializable_t<T,
+                       std::index_sequence<Is...>,
+                       decltype(void(T{std::declval<any_field_at_t<Is>>()...}))>
+   : true_t {};
+
+// largest count in [Lo, Hi] which initializes T, Lo initializes it
+template <typename T, std::size_t Lo, std::size_t Hi, bool = Lo == Hi>
+struct field_count_impl_t {
+   static constexpr std::size_t mid = (Lo + Hi + 1) / 2;
+   static constexpr std::size_t value =
+      std::conditional_t<initializable_t<T, std::make_index_sequence<mid>>::value,
+                         field_count_impl_t<T, mid, Hi>,
+                         field_count_impl_t<T, Lo, mid - 1>>::value;
+};
+
+template <typename T, std::size_t N>
+struct field_count_impl_t<T, N, N, true> {
+   static constexpr std::size_t value = N;
+};
+
+/*
+ * Field types are recorded while T is initialized from field_probe_t: the conversion to
+ * the type of field N defines field_type(field_tag_t<T, N>), which returns its type tag.
+ */
+#if defined(__GNUC__) && !defined(__clang__)
+#pragma GCC diagnostic push
+#pragma GCC diagnostic ignored "-Wnon-template-friend"
+#endif
+template <typename T, std::size_t N>
+struct field_tag_t {
+   friend auto field_type(field_tag_t);
+};
+#if defined(__GNUC__) && !defined(__clang__)
+#pragma GCC diagnostic pop
+#endif
+
+template <typename T, std::size_t N, typename U>
+struct field_type_def_t {
+   friend auto field_type(field_tag_t<T, N>) { return type_tag_t<U>{}; }
+};
+
+template <typename T, std::size_t N>
+struct field_probe_t {
+   template <typename U, std::size_t = sizeof(field_type_def_t<T, N, U>)>
+   constexpr operator U &() const && noexcept;
+};
+
+template <typename T, typename Seq>
+struct field_types_impl_t;
+
+// the base is instantiated first, it defines the field_type functions
+template <typename T, std::size_t... Is>
+struct field_types_impl_t<T, std::index_sequence<Is...>>
+   : std::is_same<T, decltype(T{field_probe_t<T, Is>{}...})> {
+   using type = type_list_t<typename decltype(field_type(field_tag_t<T, Is>{}))::type...>;
+};
+
+constexpr std::size_t align_field(std::size_t offset, std::size_t alignment) {
+   return (offset + alignment - 1) / alignment * alignment;
+}
+
+// offsets of the fields laid out in order, offsets[sizeof...(Fs)] is the padded size
+template <typename T, typename... Fs>
+struct field_offsets_impl_t {
+   static constexpr std::size_t offset(std::size_t index) {
+      const std::size_t sizes[] = {sizeof(Fs)..., 0};
+      const std::size_t alignments[] = {alignof(Fs)..., alignof(T)};
+      std::size_t ret{};
+      for (std::size_t i = 0; i < index; ++i) {
+         ret = align_field(ret, alignments[i]) + sizes[i];
+      }
+      return align_field(ret, alignments[index]);
+   }
+};
+
+template <typename T, typename List>
+struct field_offsets_t;
+
+template <typename T, typename... Fs>
+struct field_offsets_t<T, type_list_t<Fs...>> : field_offsets_impl_t<T, Fs...> {};
+
+template <typename T>
+constexpr bool is_aggregate() {
+#if defined(__GNUC__) || defined(__clang__)
+   return __is_aggregate(T);
+#else
+   return false;
+#endif
+}
+} // namespace detail
+
+/*
+ * Aggregates with fields accessible without macros: standard layout aggregates (no base
+ * classes, all fields public) whose fields are not C arrays or references.
+ */
+template <typename T>
+using is_reflectable_t = bool_t<std::is_class<T>::value && detail::is_aggregate<T>() &&
+                                std::is_standard_layout<T>::value>;
+
+/*
+ * Number of fields of aggregate T, the largest number of values which initialize it.
+ */
+template <typename T>
+struct field_count_t
+   : std::integral_constant<std::size_t,
+                            detail::field_count_impl_t<T, 0, sizeof(T)>::value> {
+   static_assert(is_reflectable_t<T>::value, "field_count_t expects an aggregate");
+};
+
+/*
+ * Types of the fields of T as type_list_t.
+ */
+template <typename T>
+using field_types_t = typename detail::
+   field_types_impl_t<T, std::make_index_sequence<field_count_t<T>::value>>::type;
+
+namespace detail {
+/*
+ * Offsets of the fields can't be taken without their names and a field declared alignas
+ * moves the next ones without changing sizeof(T). So the layout is checked once per type
+ * at startup: T is initialized from value-initialized fields in buffers filled with 0x00
+ * and 0xff, bytes equal in both are written by a field and must be inside the computed
+ * layout. Types whose fields can't be made so must have no padding at all.
+ */
+template <typename T, typename List = field_types_t<T>>
+struct field_layout_t;
+
+template <typename T, typename... Fs>
+struct field_layout_t<T, type_list_t<Fs...>> {
+   using offsets = field_offsets_impl_t<T, Fs...>;
+
+   static constexpr bool checkable = all_of<(std::is_default_constructible<Fs>::value &&
+                                             std::is_move_constructible<Fs>::value)...>();
+   static constexpr bool unpadded = sum_of({sizeof(Fs)..., std::size_t{0}}) == sizeof(T);
+
+   // whether the fields are where the offsets put them
+   static bool matches() { return matches(bool_t<checkable>{}); }
+
+   static const bool checked;
+
+private:
+   static bool matches(false_t /*checkable*/) { return true; }
+
+   static bool matches(true_t /*checkable*/) {
+      return matches(std::index_sequence_for<Fs...>{});
+   }
+
+   template <std::size_t... Is>
+   static bool matches(std::index_sequence<Is...>) {
+      // read through a volatile pointer, constant fields could be stored by clearing
+      // the whole object including the padding
+      std::tuple<Fs...> values[2]{};
+      std::tuple<Fs...> *volatile source = values;
+      alignas(T) unsigned char zeros[sizeof(T)];
+      alignas(T) unsigned char ones[sizeof(T)];
+      std::memset(zeros, 0, sizeof(T));
+      std::memset(ones, 0xff, sizeof(T));
+      auto *first = new (zeros) T{std::move(std::get<Is>(source[0]))...};
+      auto *second = new (ones) T{std::move(std::get<Is>(source[1]))...};
+      (void)source;
+
+      const std::size_t begins[] = {offsets::offset(Is)..., sizeof(T)};
+      const std::size_t ends[] = {(offsets::offset(Is) + sizeof(Fs))..., sizeof(T)};
+      bool ret = true;
+      std::size_t field{};
+      for (std::size_t byte = 0; byte < sizeof(T); ++byte) {
+         while (byte >= ends[field] && field < sizeof...(Fs)) {
+            ++field;
+         }
+         ret = ret && (byte >= begins[field] || zeros[byte] != ones[byte]);
+      }
+      first->~T();
+      second->~T();
+      return ret;
+   }
+
+   static bool verify() {
+      if (!matches()) {
+         DdsVerify(!"Layout of the fields doesn't match, alignas is not supported");
+         std::terminate();
+      }
+      return true;
+   }
+};
+
+template <typename T, typename... Fs>
+const bool field_layout_t<T, type_list_t<Fs...>>::checked = verify();
+} // namespace detail
+
+/*
+ * Field I of `obj`, at the offset of I in the layout of the field types in order. A
+ * layout which doesn't add up to sizeof(T) is a compile error (a field not supported),
+ * offsets moved by alignas of a field terminate the program at startup.
+ */
+template <std::size_t I, typename T>
+decltype(auto) get_field(T &obj) noexcept {
+   using type = std::remove_const_t<T>;
+   using types = field_types_t<type>;
+   using offsets = detail::field_offsets_t<type, types>;
+   using layout = detail::field_layout_t<type>;
+   static_assert(offsets::offset(types::size) == sizeof(type),
+                 "Layout of the fields doesn't match, C arrays and references are not "
+                 "supported");
+   static_assert(layout::checkable || layout::unpadded,
+                 "Layout of padded fields is checked with their default values, fields "
+                 "have to be default and move constructible");
+   (void)layout::checked;
+   using field = std::conditional_t<std::is_const<T>::value,
+                                    const at_t<types, I>,
+                                    at_t<types, I>>;
+   using byte = std::conditional_t<std::is_const<T>::value, const char, char>;
+   constexpr auto offset = offsets::offset(I);
+   return *reinterpret_cast<field *>(reinterpret_cast<byte *>(&obj) + offset);
+}
+
+/*
+ * Calls `f(field)` for every field of aggregate `obj` in order of declaration, fields
+ * of a const object are const.
+ */
+template <typename T, typename F>
+void for_each_field(T &obj, F &&f) {
+   constexpr auto count = static_cast<int>(field_count_t<std::remove_const_t<T>>::value);
+   static_for<0, count>([&](auto i) { f(get_field<decltype(i)::value>(obj)); });
+}
+
+} // namespace DDS_MPL_NAMESPACE
+} // namespace DDS_ROOT_NAMESPACE
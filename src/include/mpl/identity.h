@@ -7,7 +7,7 @@ namespace DDS_MPL_NAMESPACE {
 
 struct identity_t {
    template <typename T>
-   decltype(auto) operator()(T &&t) const {
+   constexpr decltype(auto) operator()(T &&t) const {
       return static_cast<T &&>(t);
    }
 };
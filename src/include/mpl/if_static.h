@@ -14,22 +14,26 @@ using true_t = bool_t<true>;
 using false_t = bool_t<false>;
 
 namespace detail {
+/*
+ * The selected branch keeps its value category: an lvalue is returned as a reference
+ * and an rvalue is moved into the result, so the branch is never copied.
+ */
 struct if_static_impl_t {
    template <typename T, typename F>
-   static auto apply(true_t, T &&t, F &&) {
-      return t;
+   static constexpr T apply(true_t, T &&t, F &&) {
+      return static_cast<T &&>(t);
    }
 
    template <typename T, typename F>
-   static auto apply(false_t, T &&, F &&f) {
-      return f;
+   static constexpr F apply(false_t, T &&, F &&f) {
+      return static_cast<F &&>(f);
    }
 };
 } // namespace detail
 
 struct if_static_t {
    template <typename Cond, typename T, typename F>
-   decltype(auto) operator()(Cond cond, T &&t, F &&f) const {
+   constexpr decltype(auto) operator()(Cond cond, T &&t, F &&f) const {
       return detail::if_static_impl_t::apply(
          cond, static_cast<T &&>(t), static_cast<F &&>(f));
    }
@@ -0,0 +1,59 @@
+#pragma once
+
+#include <mpl/config.h>
+
+#include <cstddef>
+#include <type_traits>
+#include <utility>
+
+namespace DDS_ROOT_NAMESPACE {
+namespace DDS_MPL_NAMESPACE {
+
+namespace detail {
+// parameter which accepts any argument and ignores it
+template <std::size_t>
+struct ignore_arg_t {
+   template <typename T>
+   constexpr ignore_arg_t(T &&) {}
+};
+
+/*
+ * The first I arguments are matched by ignore_arg_t, so the I-th one is selected by
+ * overload resolution. Unlike recursion or std::tuple it doesn't instantiate anything
+ * per skipped argument.
+ */
+template <typename Seq>
+struct nth_arg_impl_t;
+
+template <std::size_t... Is>
+struct nth_arg_impl_t<std::index_sequence<Is...>> {
+   template <typename T, typename... Rest>
+   static constexpr T &&apply(ignore_arg_t<Is>..., T &&t, Rest &&...) {
+      return static_cast<T &&>(t);
+   }
+};
+} // namespace detail
+
+/*
+ * I-th argument, forwarded.
+ */
+template <std::size_t I, typename... Ts>
+constexpr decltype(auto) nth_arg(Ts &&... args) {
+   static_assert(I < sizeof...(Ts), "Argument index out of range");
+   return detail::nth_arg_impl_t<std::make_index_sequence<I>>::apply(
+      static_cast<Ts &&>(args)...);
+}
+
+template <std::size_t I, typename... Ts>
+using nth_arg_t = decltype(nth_arg<I>(std::declval<Ts>()...));
+
+namespace detail {
+// type of a forwarded argument kept by value: an lvalue reference or a value
+template <typename T>
+using forwarded_t = std::conditional_t<std::is_lvalue_reference<T>::value,
+                                       T,
+                                       std::remove_reference_t<T>>;
+} // namespace detail
+
+} // namespace DDS_MPL_NAMESPACE
+} // namespace DDS_ROOT_NAMESPACE
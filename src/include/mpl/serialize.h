@@ -0,0 +1,539 @@
+#pragma once
+
+/*
+ * Binary serialization of values whose encoding is derived from their type:
+ *
+ * - trivially copyable values (numbers, enums, aggregates of them without padding) are
+ *   their bytes, in the byte order of the host, written by a single memcpy
+ * - strings (std::string, StringView) are a 32-bit length and the characters
+ * - sequences (std::vector, span_t) are a 32-bit count and the elements, a sequence of
+ *   trivially copyable elements is aligned to the elements and copied by one memcpy
+ * - std::array and aggregates (see for_each_field) are their elements or fields in order
+ *
+ * Decoding into StringView and span_t<const T> gives views into the input buffer, valid
+ * as long as the buffer is. Such views of a sequence need the buffer aligned to
+ * alignof(std::max_align_t), as allocated by new. The same struct can declare std::string
+ * and std::vector for encoding and StringView and span_t for decoding, the encoding of
+ * both is the same.
+ */
+
+#include <common/common.h>
+#include <mpl/config.h>
+#include <mpl/for_each_field.h>
+#include <mpl/span.h>
+#include <mpl/type_list.h>
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <limits>
+#include <string>
+#include <type_traits>
+#include <vector>
+
+namespace DDS_ROOT_NAMESPACE {
+namespace DDS_MPL_NAMESPACE {
+
+namespace detail {
+enum class WireKind {
+   Raw,      // trivially copyable, its bytes
+   String,   // length and characters
+   Sequence, // count and elements
+   Array,    // std::array, its elements
+   Fields,   // aggregate, its fields
+};
+
+template <WireKind K>
+using wire_kind_t = std::integral_constant<WireKind, K>;
+
+template <typename T>
+struct wire_string_t : false_t {};
+
+template <typename... Ts>
+struct wire_string_t<std::basic_string<char, Ts...>> : true_t {};
+
+template <>
+struct wire_string_t<StringView> : true_t {};
+
+template <typename T>
+struct wire_sequence_t : false_t {};
+
+template <typename E, typename A>
+struct wire_sequence_t<std::vector<E, A>> : true_t {
+   using element = E;
+};
+
+template <typename E>
+struct wire_sequence_t<span_t<E>> : true_t {
+   using element = std::remove_const_t<E>;
+};
+
+template <typename T>
+struct wire_array_t : false_t {};
+
+template <typename E, std::size_t N>
+struct wire_array_t<std::array<E, N>> : true_t {
+   using element = E;
+};
+
+template <typename T>
+constexpr WireKind wire_kind() {
+   return wire_string_t<T>::value     ? WireKind::String
+          : wire_sequence_t<T>::value ? WireKind::Sequence
+          : wire_array_t<T>::value    ? WireKind::Array
+          : is_reflectable_t<T>::value ? WireKind::Fields
+                                       : WireKind::Raw;
+}
+
+using wire_length_t = std::uint32_t;
+
+// fixed size of a type whose encoded size depends on the value
+const std::size_t wire_unbounded = std::numeric_limits<std::size_t>::max();
+
+template <typename... Ts>
+constexpr std::size_t wire_sum(Ts... sizes) {
+   const std::size_t values[] = {sizes..., 0};
+   std::size_t ret{};
+   for (auto value : values) {
+      if (wire_unbounded == value) {
+         return wire_unbounded;
+      }
+      ret += value;
+   }
+   return ret;
+}
+
+/*
+ * Encoding of T: `raw` when it is its bytes, `fixed_size` of every value of T or
+ * wire_unbounded, `min_size` the smallest one.
+ */
+template <typename T, WireKind = wire_kind<T>()>
+struct wire_traits_t;
+
+template <typename T>
+struct wire_traits_t<T, WireKind::Raw> {
+   static_assert(std::is_trivially_copyable<T>::value && !std::is_pointer<T>::value,
+                 "Type is not serializable, not trivially copyable nor an aggregate");
+   static constexpr bool raw = true;
+   static constexpr std::size_t fixed_size = sizeof(T);
+   static constexpr std::size_t min_size = sizeof(T);
+};
+
+struct wire_counted_traits_t {
+   static constexpr bool raw = false;
+   static constexpr std::size_t fixed_size = wire_unbounded;
+   static constexpr std::size_t min_size = sizeof(wire_length_t);
+};
+
+template <typename T>
+struct wire_traits_t<T, WireKind::String> : wire_counted_traits_t {};
+
+template <typename T>
+struct wire_traits_t<T, WireKind::Sequence> : wire_counted_traits_t {};
+
+template <typename T, typename E, std::size_t N>
+struct wire_array_traits_t {
+   static constexpr bool raw = wire_traits_t<E>::raw && sizeof(T) == N * sizeof(E);
+   static constexpr std::size_t fixed_size =
+      wire_traits_t<E>::fixed_size == wire_unbounded ? wire_unbounded
+                                                     : N * wire_traits_t<E>::fixed_size;
+   static constexpr std::size_t min_size = N * wire_traits_t<E>::min_size;
+};
+
+template <typename E, std::size_t N>
+struct wire_traits_t<std::array<E, N>, WireKind::Array>
+   : wire_array_traits_t<std::array<E, N>, E, N> {};
+
+// raw when the fields are and there is no padding between them
+template <typename T, typename List>
+struct wire_fields_traits_t;
+
+template <typename T, typename... Fs>
+struct wire_fields_traits_t<T, type_list_t<Fs...>> {
+   static constexpr bool raw =
+      all_of<wire_traits_t<Fs>::raw...>() && wire_sum(sizeof(Fs)...) == sizeof(T);
+   static constexpr std::size_t fixed_size = wire_sum(wire_traits_t<Fs>::fixed_size...);
+   static constexpr std::size_t min_size = wire_sum(wire_traits_t<Fs>::min_size...);
+};
+
+template <typename T>
+struct wire_traits_t<T, WireKind::Fields> : wire_fields_traits_t<T, field_types_t<T>> {};
+
+template <typename T>
+using wire_raw_t = bool_t<wire_traits_t<T>::raw>;
+
+template <typename T>
+using wire_fixed_t = bool_t<wire_traits_t<T>::fixed_size != wire_unbounded>;
+
+template <typename T>
+using wire_kind_of_t = wire_kind_t<wire_kind<T>()>;
+
+struct wire_writer_t {
+   // false when the output is shorter
+   bool write(const void *src, std::size_t size) {
+      if (DdsUnlikely(end - pos < size)) {
+         return false;
+      }
+      std::memcpy(out + pos, src, size);
+      pos += size;
+      return true;
+   }
+
+   bool write_length(std::size_t size) {
+      if (DdsUnlikely(size > std::numeric_limits<wire_length_t>::max())) {
+         return false;
+      }
+      auto length = static_cast<wire_length_t>(size);
+      return write(&length, sizeof(length));
+   }
+
+   // zeros up to the alignment, relative to the start of the buffer
+   bool align(std::size_t alignment) {
+      auto to = align_field(pos, alignment);
+      if (DdsUnlikely(to > end)) {
+         return false;
+      }
+      std::memset(out + pos, 0, to - pos);
+      pos = to;
+      return true;
+   }
+
+   char *out;
+   std::size_t end;
+   std::size_t pos;
+};
+
+struct wire_reader_t {
+   // `size` bytes at the position, nullptr when the input is shorter
+   const char *take(std::size_t size) {
+      if (DdsUnlikely(end - pos < size)) {
+         return nullptr;
+      }
+      auto ret = in + pos;
+      pos += size;
+      return ret;
+   }
+
+   bool read(void *dst, std::size_t size) {
+      auto src = take(size);
+      if (DdsUnlikely(!src)) {
+         return false;
+      }
+      std::memcpy(dst, src, size);
+      return true;
+   }
+
+   bool align(std::size_t alignment) {
+      auto to = align_field(pos, alignment);
+      if (DdsUnlikely(to > end)) {
+         return false;
+      }
+      pos = to;
+      return true;
+   }
+
+   const char *in;
+   std::size_t end;
+   std::size_t pos;
+};
+
+// end of the encoding of `value` which starts at `pos`
+
+template <typename T>
+std::size_t encoded_end(std::size_t pos, const T &value);
+
+template <typename T, typename Kind>
+std::size_t encoded_end(std::size_t pos, const T &, true_t /*fixed*/, Kind) {
+   return pos + wire_traits_t<T>::fixed_size;
+}
+
+template <typename T>
+std::size_t
+encoded_end(std::size_t pos, const T &value, false_t, wire_kind_t<WireKind::String>) {
+   return pos + sizeof(wire_length_t) + value.size();
+}
+
+template <typename E>
+std::size_t
+elements_end(std::size_t pos, const E *data, std::size_t count, true_t /*raw*/) {
+   (void)data;
+   return align_field(pos, alignof(E)) + count * sizeof(E);
+}
+
+template <typename E>
+std::size_t elements_end(std::size_t pos, const E *data, std::size_t count, false_t) {
+   for (std::size_t i = 0; i < count; ++i) {
+      pos = encoded_end(pos, data[i]);
+   }
+   return pos;
+}
+
+template <typename T>
+std::size_t
+encoded_end(std::size_t pos, const T &value, false_t, wire_kind_t<WireKind::Sequence>) {
+   using element = typename wire_sequence_t<T>::element;
+   return elements_end(
+      pos + sizeof(wire_length_t), value.data(), value.size(), wire_raw_t<element>{});
+}
+
+template <typename T>
+std::size_t
+encoded_end(std::size_t pos, const T &value, false_t, wire_kind_t<WireKind::Array>) {
+   return elements_end(pos, value.data(), value.size(), false_t{});
+}
+
+template <typename T>
+std::size_t
+encoded_end(std::size_t pos, const T &value, false_t, wire_kind_t<WireKind::Fields>) {
+   for_each_field(value, [&pos](const auto &field) { pos = encoded_end(pos, field); });
+   return pos;
+}
+
+template <typename T>
+std::size_t encoded_end(std::size_t pos, const T &value) {
+   return encoded_end(pos, value, wire_fixed_t<T>{}, wire_kind_of_t<T>{});
+}
+
+template <typename T>
+bool encode_value(wire_writer_t &out, const T &value);
+
+template <typename T, typename Kind>
+bool encode_value(wire_writer_t &out, const T &value, true_t /*raw*/, Kind) {
+   return out.write(&value, sizeof(T));
+}
+
+template <typename T>
+bool encode_value(wire_writer_t &out,
+                  const T &value,
+                  false_t,
+                  wire_kind_t<WireKind::String>) {
+   return out.write_length(value.size()) && out.write(value.data(), value.size());
+}
+
+template <typename E>
+bool encode_elements(wire_writer_t &out,
+                     const E *data,
+                     std::size_t count,
+                     true_t /*raw*/) {
+   if (!out.align(alignof(E))) {
+      return false;
+   }
+   return !count || out.write(data, count * sizeof(E));
+}
+
+template <typename E>
+bool encode_elements(wire_writer_t &out, const E *data, std::size_t count, false_t) {
+   for (std::size_t i = 0; i < count; ++i) {
+      if (!encode_value(out, data[i])) {
+         return false;
+      }
+   }
+   return true;
+}
+
+template <typename T>
+bool encode_value(wire_writer_t &out,
+                  const T &value,
+                  false_t,
+                  wire_kind_t<WireKind::Sequence>) {
+   using element = typename wire_sequence_t<T>::element;
+   return out.write_length(value.size()) &&
+          encode_elements(out, value.data(), value.size(), wire_raw_t<element>{});
+}
+
+template <typename T>
+bool encode_value(wire_writer_t &out,
+                  const T &value,
+                  false_t,
+                  wire_kind_t<WireKind::Array>) {
+   return encode_elements(out, value.data(), value.size(), false_t{});
+}
+
+template <typename T>
+bool encode_value(wire_writer_t &out,
+                  const T &value,
+                  false_t,
+                  wire_kind_t<WireKind::Fields>) {
+   bool ret = true;
+   for_each_field(value,
+                  [&](const auto &field) { ret = ret && encode_value(out, field); });
+   return ret;
+}
+
+template <typename T>
+bool encode_value(wire_writer_t &out, const T &value) {
+   return encode_value(out, value, wire_raw_t<T>{}, wire_kind_of_t<T>{});
+}
+
+template <typename T>
+bool decode_value(wire_reader_t &in, T &value);
+
+template <typename T, typename Kind>
+bool decode_value(wire_reader_t &in, T &value, true_t /*raw*/, Kind) {
+   return in.read(&value, sizeof(T));
+}
+
+inline void assign_string(StringView &value, const char *chars, std::size_t size) {
+   value = StringView{chars, size};
+}
+
+template <typename... Ts>
+void assign_string(std::basic_string<char, Ts...> &value,
+                   const char *chars,
+                   std::size_t size) {
+   value.assign(chars, size);
+}
+
+template <typename T>
+bool decode_value(wire_reader_t &in, T &value, false_t, wire_kind_t<WireKind::String>) {
+   wire_length_t length;
+   if (!in.read(&length, sizeof(length))) {
+      return false;
+   }
+   auto chars = in.take(length);
+   if (DdsUnlikely(!chars)) {
+      return false;
+   }
+   assign_string(value, chars, length);
+   return true;
+}
+
+// false when the input buffer of a view is not aligned
+template <typename E>
+bool assign_elements(span_t<E> &value, const char *data, std::size_t count) {
+   static_assert(std::is_const<E>::value, "Views of the input are span_t<const T>");
+   if (DdsUnlikely(reinterpret_cast<std::uintptr_t>(data) % alignof(E))) {
+      return false;
+   }
+   value = span_t<E>{reinterpret_cast<E *>(data), count};
+   return true;
+}
+
+template <typename E, typename A>
+bool assign_elements(std::vector<E, A> &value, const char *data, std::size_t count) {
+   value.resize(count);
+   if (count) {
+      std::memcpy(value.data(), data, count * sizeof(E));
+   }
+   return true;
+}
+
+template <typename T>
+bool decode_elements(wire_reader_t &in, T &value, std::size_t count, true_t /*raw*/) {
+   using element = typename wire_sequence_t<T>::element;
+   if (!in.align(alignof(element)) || count > (in.end - in.pos) / sizeof(element)) {
+      return false;
+   }
+   return assign_elements(value, in.take(count * sizeof(element)), count);
+}
+
+template <typename E>
+bool decode_elements(wire_reader_t &, span_t<E> &, std::size_t, false_t) {
+   static_assert(wire_raw_t<std::remove_const_t<E>>::value,
+                 "Only sequences of trivially copyable values are decoded as views");
+   return false;
+}
+
+template <typename E, typename A>
+bool decode_elements(wire_reader_t &in,
+                     std::vector<E, A> &value,
+                     std::size_t count,
+                     false_t) {
+   // every element takes at least min_size, a corrupted count doesn't allocate
+   const std::size_t min_size = wire_traits_t<E>::min_size;
+   static_assert(min_size > 0,
+                 "Elements encoded in no bytes, their count isn't bounded by the input");
+   if (count > (in.end - in.pos) / min_size) {
+      return false;
+   }
+   value.resize(count);
+   for (auto &element : value) {
+      if (!decode_value(in, element)) {
+         return false;
+      }
+   }
+   return true;
+}
+
+template <typename T>
+bool decode_value(wire_reader_t &in, T &value, false_t, wire_kind_t<WireKind::Sequence>) {
+   using element = typename wire_sequence_t<T>::element;
+   wire_length_t count;
+   if (!in.read(&count, sizeof(count))) {
+      return false;
+   }
+   return decode_elements(in, value, count, wire_raw_t<element>{});
+}
+
+template <typename T>
+bool decode_value(wire_reader_t &in, T &value, false_t, wire_kind_t<WireKind::Array>) {
+   for (auto &element : value) {
+      if (!decode_value(in, element)) {
+         return false;
+      }
+   }
+   return true;
+}
+
+template <typename T>
+bool decode_value(wire_reader_t &in, T &value, false_t, wire_kind_t<WireKind::Fields>) {
+   bool ret = true;
+   for_each_field(value, [&](auto &field) { ret = ret && decode_value(in, field); });
+   return ret;
+}
+
+template <typename T>
+bool decode_value(wire_reader_t &in, T &value) {
+   return decode_value(in, value, wire_raw_t<T>{}, wire_kind_of_t<T>{});
+}
+} // namespace detail
+
+/*
+ * Whether every value of T has the same encoded size.
+ */
+template <typename T>
+using has_fixed_size_t = detail::wire_fixed_t<T>;
+
+/*
+ * Encoded size of any value of T, for types of a fixed size.
+ */
+template <typename T>
+struct max_encoded_size_t
+   : std::integral_constant<std::size_t, detail::wire_traits_t<T>::fixed_size> {
+   static_assert(has_fixed_size_t<T>::value,
+                 "Encoded size of the type depends on the value, use encoded_size()");
+};
+
+/*
+ * Size of the encoding of `value`, it is constant for types of a fixed size.
+ */
+template <typename T>
+std::size_t encoded_size(const T &value) {
+   return detail::encoded_end(0, value);
+}
+
+/*
+ * Encodes `value` at the start of `buffer`, returns the size of the encoding or 0 when
+ * the buffer is shorter than encoded_size(value) or a length doesn't fit 32 bits. The
+ * buffer is then partially written.
+ */
+template <typename T>
+std::size_t encode(const T &value, span_t<char> buffer) {
+   detail::wire_writer_t out{buffer.data(), buffer.size(), 0};
+   return detail::encode_value(out, value) ? out.pos : 0;
+}
+
+/*
+ * Decodes `value` from the start of `buffer`, views in `value` refer to the buffer.
+ * Returns false if the buffer is shorter than the encoding or a view of a sequence isn't
+ * aligned, `value` is then partially decoded.
+ */
+template <typename T>
+bool decode(span_t<const char> buffer, T &value) {
+   detail::wire_reader_t in{buffer.data(), buffer.size(), 0};
+   return detail::decode_value(in, value);
+}
+
+} // namespace DDS_MPL_NAMESPACE
+} // namespace DDS_ROOT_NAMESPACE
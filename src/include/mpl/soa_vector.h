@@ -0,0 +1,267 @@
+#pragma once
+
+#include <common/common.h>
+#include <mpl/config.h>
+#include <mpl/span.h>
+#include <mpl/static_for.h>
+#include <mpl/type_list.h>
+
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <new>
+#include <tuple>
+#include <type_traits>
+#include <utility>
+
+namespace DDS_ROOT_NAMESPACE {
+namespace DDS_MPL_NAMESPACE {
+
+namespace detail {
+// columns start at a cache line, which is enough for aligned SIMD loads too
+const std::size_t soa_alignment = 64;
+
+constexpr std::size_t align_up(std::size_t value, std::size_t alignment) {
+   return (value + alignment - 1) / alignment * alignment;
+}
+} // namespace detail
+
+/*
+ * Row I of a soa_vector_t (`Soa` may be const), fields are references into the columns.
+ * It is valid until the vector is reallocated.
+ */
+template <typename Soa>
+class soa_row_t {
+public:
+   soa_row_t(Soa &soa_, std::size_t index_)
+      : soa{&soa_}
+      , idx{index_} {}
+
+   template <std::size_t I>
+   decltype(auto) get() const {
+      return soa->template column<I>()[idx];
+   }
+
+   template <typename T>
+   decltype(auto) get() const {
+      return soa->template column<T>()[idx];
+   }
+
+   std::size_t index() const { return idx; }
+
+private:
+   Soa *soa;
+   std::size_t idx;
+};
+
+/*
+ * Vector of records stored as a struct of arrays: a column of every field type, so a
+ * loop reading two fields of a wide record loads only those. All the columns share one
+ * size and one allocation, each column starts at a cache line. Fields must be
+ * nothrow move constructible, they are moved on reallocation.
+ */
+template <typename... Fields>
+class soa_vector_t {
+   using types = type_list_t<Fields...>;
+
+   static_assert(sizeof...(Fields) > 0, "soa_vector_t expects fields");
+   static_assert(detail::all_of<std::is_nothrow_move_constructible<Fields>::value...>(),
+                 "Fields must be nothrow move constructible");
+
+public:
+   static constexpr std::size_t columns = sizeof...(Fields);
+
+   template <std::size_t I>
+   using field_t = at_t<types, I>;
+
+   using row_t = soa_row_t<soa_vector_t>;
+   using const_row_t = soa_row_t<const soa_vector_t>;
+
+   soa_vector_t() = default;
+
+   soa_vector_t(const soa_vector_t &other) {
+      reserve(other.size());
+      for (std::size_t i = 0; i < other.size(); ++i) {
+         other.with_row(i, [&](const Fields &...values) { push_back(values...); });
+      }
+   }
+
+   soa_vector_t(soa_vector_t &&other) noexcept { swap(other); }
+
+   ~soa_vector_t() { clear(); }
+
+   soa_vector_t &operator=(soa_vector_t other) noexcept {
+      swap(other);
+      return *this;
+   }
+
+   void swap(soa_vector_t &other) noexcept {
+      std::swap(block, other.block);
+      std::swap(data, other.data);
+      std::swap(count, other.count);
+      std::swap(cap, other.cap);
+   }
+
+   std::size_t size() const { return count; }
+   std::size_t capacity() const { return cap; }
+   bool empty() const { return 0 == count; }
+
+   // a single allocation for all the columns
+   void reserve(std::size_t capacity) {
+      if (capacity > cap) {
+         reallocate(capacity);
+      }
+   }
+
+   // new rows are value-initialized
+   void resize(std::size_t size) {
+      static_assert(
+         detail::all_of<std::is_nothrow_default_constructible<Fields>::value...>(),
+         "resize without values expects nothrow default constructible fields");
+      reserve(size);
+      static_for<0, columns>([&](auto i) {
+         using T = field_t<i>;
+         auto *column = std::get<i>(data);
+         for (auto row = count; row < size; ++row) {
+            new (column + row) T();
+         }
+         for (auto row = size; row < count; ++row) {
+            column[row].~T();
+         }
+      });
+      count = size;
+   }
+
+   // new rows are copies of `values`
+   void resize(std::size_t size, const Fields &...values) {
+      while (count > size) {
+         pop_back();
+      }
+      reserve(size);
+      while (count < size) {
+         push_back(values...);
+      }
+   }
+
+   // values are taken by value, so a throwing copy happens before the vector changes
+   void push_back(Fields... values) {
+      if (count == cap) {
+         reallocate(cap ? 2 * cap : 16);
+      }
+      auto args = std::forward_as_tuple(values...);
+      static_for<0, columns>([&](auto i) {
+         new (std::get<i>(data) + count) field_t<i>(std::move(std::get<i>(args)));
+      });
+      ++count;
+   }
+
+   void pop_back() {
+      DdsVerify(count > 0 && "pop_back of an empty soa_vector_t");
+      --count;
+      static_for<0, columns>([&](auto i) {
+         using T = field_t<i>;
+         std::get<i>(data)[count].~T();
+      });
+   }
+
+   void clear() {
+      static_for<0, columns>([&](auto i) {
+         using T = field_t<i>;
+         auto *column = std::get<i>(data);
+         for (std::size_t row = 0; row < count; ++row) {
+            column[row].~T();
+         }
+      });
+      count = 0;
+   }
+
+   // contiguous values of field I of all the rows
+   template <std::size_t I>
+   span_t<field_t<I>> column() {
+      return {std::get<I>(data), count};
+   }
+
+   template <std::size_t I>
+   span_t<const field_t<I>> column() const {
+      return {std::get<I>(data), count};
+   }
+
+   template <typename T>
+   span_t<T> column() {
+      return column<index_of_t<types, T>::value>();
+   }
+
+   template <typename T>
+   span_t<const T> column() const {
+      return column<index_of_t<types, T>::value>();
+   }
+
+   row_t operator[](std::size_t index) { return {*this, index}; }
+   const_row_t operator[](std::size_t index) const { return {*this, index}; }
+
+   // f(fields of row `index`...)
+   template <typename F>
+   decltype(auto) with_row(std::size_t index, F &&f) {
+      return with_row_impl(
+         *this, index, static_cast<F &&>(f), std::index_sequence_for<Fields...>{});
+   }
+
+   template <typename F>
+   decltype(auto) with_row(std::size_t index, F &&f) const {
+      return with_row_impl(
+         *this, index, static_cast<F &&>(f), std::index_sequence_for<Fields...>{});
+   }
+
+private:
+   template <typename Soa, typename F, std::size_t... Is>
+   static decltype(auto) with_row_impl(Soa &soa,
+                                       std::size_t index,
+                                       F &&f,
+                                       std::index_sequence<Is...>) {
+      return static_cast<F &&>(f)(soa.template column<Is>()[index]...);
+   }
+
+   // columns in the order of Fields, each aligned to a cache line
+   void reallocate(std::size_t capacity) {
+      constexpr std::size_t alignment =
+         detail::max_of({detail::soa_alignment, alignof(Fields)...});
+      constexpr std::size_t sizes[] = {sizeof(Fields)...};
+      std::size_t offsets[columns]{};
+      std::size_t bytes{};
+      for (std::size_t i = 0; i < columns; ++i) {
+         offsets[i] = detail::align_up(bytes, alignment);
+         bytes = offsets[i] + capacity * sizes[i];
+      }
+      std::unique_ptr<char[]> new_block{new char[bytes + alignment - 1]};
+      auto *base = reinterpret_cast<char *>(
+         detail::align_up(reinterpret_cast<std::uintptr_t>(new_block.get()), alignment));
+      static_for<0, columns>([&](auto i) {
+         using T = field_t<i>;
+         auto *column = reinterpret_cast<T *>(base + offsets[i]);
+         auto *old = std::get<i>(data);
+         for (std::size_t row = 0; row < count; ++row) {
+            new (column + row) T(std::move(old[row]));
+            old[row].~T();
+         }
+         std::get<i>(data) = column;
+      });
+      block = std::move(new_block);
+      cap = capacity;
+   }
+
+   std::unique_ptr<char[]> block;
+   std::tuple<Fields *...> data;
+   std::size_t count{};
+   std::size_t cap{};
+};
+
+template <typename... Fields>
+constexpr std::size_t soa_vector_t<Fields...>::columns;
+
+template <std::size_t I, typename Soa>
+decltype(auto) get(const soa_row_t<Soa> &row) {
+   return row.template get<I>();
+}
+
+} // namespace DDS_MPL_NAMESPACE
+} // namespace DDS_ROOT_NAMESPACE
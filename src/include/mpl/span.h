@@ -0,0 +1,36 @@
+#pragma once
+
+#include <mpl/config.h>
+
+#include <cstddef>
+
+namespace DDS_ROOT_NAMESPACE {
+namespace DDS_MPL_NAMESPACE {
+
+/*
+ * Non-owning view of `size` contiguous values of T, until switch to C++20 std::span.
+ */
+template <typename T>
+class span_t {
+public:
+   constexpr span_t() = default;
+   constexpr span_t(T *data_, std::size_t size_)
+      : ptr{data_}
+      , count{size_} {}
+
+   constexpr T *data() const { return ptr; }
+   constexpr std::size_t size() const { return count; }
+   constexpr bool empty() const { return 0 == count; }
+
+   constexpr T *begin() const { return ptr; }
+   constexpr T *end() const { return ptr + count; }
+
+   constexpr T &operator[](std::size_t index) const { return ptr[index]; }
+
+private:
+   T *ptr{};
+   std::size_t count{};
+};
+
+} // namespace DDS_MPL_NAMESPACE
+} // namespace DDS_ROOT_NAMESPACE
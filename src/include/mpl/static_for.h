@@ -0,0 +1,103 @@
+#pragma once
+
+#include <mpl/config.h>
+#include <mpl/type_tag.h>
+
+#include <cstddef>
+#include <initializer_list>
+#include <type_traits>
+#include <utility>
+
+namespace DDS_ROOT_NAMESPACE {
+namespace DDS_MPL_NAMESPACE {
+
+namespace detail {
+// number of values of [Begin, End) with Step, which may be negative
+constexpr std::size_t range_count(int begin, int end, int step) {
+   if (step > 0) {
+      return end > begin ? static_cast<std::size_t>((end - begin + step - 1) / step) : 0;
+   }
+   return begin > end ? static_cast<std::size_t>((begin - end - step - 1) / -step) : 0;
+}
+
+template <int Begin, int Step, typename Seq>
+struct integer_range_impl_t;
+
+template <int Begin, int Step, std::size_t... Is>
+struct integer_range_impl_t<Begin, Step, std::index_sequence<Is...>> {
+   using type = std::integer_sequence<int, Begin + static_cast<int>(Is) * Step...>;
+};
+
+template <typename F, int... Is>
+constexpr void static_for_impl(F &&f, std::integer_sequence<int, Is...>) {
+   (void)f; // unused for an empty range
+   (void)std::initializer_list<int>{(f(std::integral_constant<int, Is>{}), 0)...};
+}
+} // namespace detail
+
+/*
+ * std::integer_sequence<int, Begin, Begin + Step, ...> of values in [Begin, End).
+ */
+template <int Begin, int End, int Step = 1>
+using integer_range_t = typename detail::integer_range_impl_t<
+   Begin,
+   Step,
+   std::make_index_sequence<detail::range_count(Begin, End, Step)>>::type;
+
+/*
+ * Calls `f(std::integral_constant<int, i>{})` for i in [Begin, End) with Step. The calls
+ * are expanded in place, no recursion.
+ */
+template <int Begin, int End, int Step = 1, typename F>
+constexpr void static_for(F &&f) {
+   static_assert(Step != 0, "static_for step must not be zero");
+   detail::static_for_impl(static_cast<F &&>(f), integer_range_t<Begin, End, Step>{});
+}
+
+/*
+ * Index of an unrolled loop: converts to the runtime index, `lane` is its position in
+ * the unrolled block as a constant, so it can select one of independent accumulators.
+ */
+template <std::size_t Lane>
+struct unroll_index_t {
+   static constexpr std::size_t lane = Lane;
+
+   constexpr operator std::size_t() const { return value; }
+
+   std::size_t value;
+};
+
+template <std::size_t Lane>
+constexpr std::size_t unroll_index_t<Lane>::lane;
+
+/*
+ * Calls `f(i)` for i in [0, count) in blocks of N calls expanded in place, the remainder
+ * is expanded too. `i` is unroll_index_t, see above.
+ */
+template <std::size_t N, typename F>
+void unroll(std::size_t count, F &&f) {
+   static_assert(N > 0, "unroll expects a positive block size");
+   std::size_t i{};
+   for (; i + N <= count; i += N) {
+      static_for<0, static_cast<int>(N)>(
+         [&](auto lane) { f(unroll_index_t<decltype(lane)::value>{i + lane}); });
+   }
+   auto rest = count - i;
+   static_for<0, static_cast<int>(N) - 1>([&](auto lane) {
+      if (lane < rest) {
+         f(unroll_index_t<decltype(lane)::value>{i + lane});
+      }
+   });
+}
+
+/*
+ * Calls `f(type_tag_t<T>{})` for every T of Ts.
+ */
+template <typename... Ts, typename F>
+constexpr void for_each_type(F &&f) {
+   (void)f; // unused for no types
+   (void)std::initializer_list<int>{(f(type_tag_t<Ts>{}), 0)...};
+}
+
+} // namespace DDS_MPL_NAMESPACE
+} // namespace DDS_ROOT_NAMESPACE
@@ -0,0 +1,313 @@
+#pragma once
+
+#include <common/common.h>
+#include <mpl/config.h>
+
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <type_traits>
+
+namespace DDS_ROOT_NAMESPACE {
+namespace DDS_MPL_NAMESPACE {
+
+/*
+ * 64-bit FNV-1a of a string, a compile time constant for literals.
+ */
+constexpr std::uint64_t string_hash(const char *str) noexcept {
+   std::size_t size{};
+   while (str[size]) {
+      ++size;
+   }
+   return ::DDS_ROOT_NAMESPACE::detail::fnv1a(str, size);
+}
+
+inline std::uint64_t string_hash(StringView str) noexcept {
+   return ::DDS_ROOT_NAMESPACE::detail::fnv1a(str.data(), str.size());
+}
+
+namespace detail {
+// table at most half full, so a free slot for a key is found in about two tries
+constexpr std::size_t static_map_slots(std::size_t count) {
+   std::size_t ret{1};
+   while (ret < 2 * count) {
+      ret *= 2;
+   }
+   return ret;
+}
+
+// keys are split to buckets of 4 keys on average (at least 2 buckets to keep the shift
+// below 64), each one has its displacement
+constexpr std::size_t static_map_buckets(std::size_t count) {
+   std::size_t ret{2};
+   while (4 * ret < count) {
+      ret *= 2;
+   }
+   return ret;
+}
+
+constexpr unsigned static_map_shift(std::size_t slots) {
+   unsigned ret{64};
+   for (; slots > 1; slots /= 2) {
+      --ret;
+   }
+   return ret;
+}
+
+constexpr std::uint64_t static_map_byte(const char *str, unsigned index) {
+   return std::uint64_t{static_cast<unsigned char>(str[index])} << (8 * index);
+}
+
+// little endian loads written out byte by byte, constexpr and still a single load
+constexpr std::uint64_t static_map_load32(const char *str) {
+   return static_map_byte(str, 0) | static_map_byte(str, 1) | static_map_byte(str, 2) |
+          static_map_byte(str, 3);
+}
+
+constexpr std::uint64_t static_map_load64(const char *str) {
+   return static_map_load32(str) | static_map_load32(str + 4) << 32;
+}
+
+constexpr std::uint64_t static_map_mix(std::uint64_t hash, std::uint64_t word) {
+   hash = (hash ^ word) * 0xff51afd7ed558ccdull;
+   return hash ^ (hash >> 32);
+}
+
+// hash of the keys, 8 bytes in a step unlike string_hash, the last step overlaps
+constexpr std::uint64_t static_map_hash(const char *str, std::size_t size) {
+   std::uint64_t ret{size * 0x9e3779b97f4a7c15ull};
+   if (size >= 8) {
+      for (std::size_t i = 0; i + 8 < size; i += 8) {
+         ret = static_map_mix(ret, static_map_load64(str + i));
+      }
+      return static_map_mix(ret, static_map_load64(str + size - 8));
+   }
+   if (size >= 4) {
+      auto word = static_map_load32(str) | static_map_load32(str + size - 4) << 32;
+      return static_map_mix(ret, word);
+   }
+   if (size) {
+      auto word = static_cast<unsigned char>(str[0]) |
+                  static_cast<unsigned char>(str[size / 2]) << 8 |
+                  static_cast<unsigned char>(str[size - 1]) << 16;
+      return static_map_mix(ret, static_cast<std::uint64_t>(word));
+   }
+   return static_map_mix(ret, 0);
+}
+
+constexpr std::size_t
+static_map_slot(std::uint64_t hash, std::uint64_t seed, unsigned shift) {
+   return static_cast<std::size_t>(((hash ^ seed) * 0x9e3779b97f4a7c15ull) >> shift);
+}
+
+// bucket of a key, independent of its slot
+constexpr std::size_t
+static_map_bucket(std::uint64_t hash, std::uint64_t seed, unsigned shift) {
+   return static_cast<std::size_t>(((hash + seed) * 0xc2b2ae3d27d4eb4full) >> shift);
+}
+
+// seed of the slots of a bucket with `displacement`
+constexpr std::uint64_t static_map_displace(std::uint16_t displacement) {
+   return displacement * 0xd6e8feb86659fd93ull;
+}
+
+constexpr bool static_map_equal(StringView lhs, StringView rhs) {
+   if (lhs.size() != rhs.size()) {
+      return false;
+   }
+   for (std::size_t i = 0; i < lhs.size(); ++i) {
+      if (lhs[i] != rhs[i]) {
+         return false;
+      }
+   }
+   return true;
+}
+
+// seeds of the buckets tried before the keys are reported as not hashable (it takes
+// keys with the same 64-bit hash)
+const std::uint64_t static_map_max_seeds = 1 << 4;
+// displacements tried for a bucket before a new seed of the buckets is tried
+const std::uint32_t static_map_max_displacement = 1 << 12;
+} // namespace detail
+
+template <typename V>
+struct static_map_entry_t {
+   constexpr static_map_entry_t() = default;
+
+   template <std::size_t N>
+   constexpr static_map_entry_t(const char (&key_)[N], V value_)
+      : key{key_, N - 1}
+      , value{value_} {}
+
+   StringView key;
+   V value{};
+};
+
+/*
+ * Map of N string keys known at compile time to values of a literal type V. A perfect
+ * hash is found when the map is built (hash and displace): keys are split to buckets,
+ * the largest buckets are placed first and every bucket gets the first displacement
+ * which moves all its keys to free slots. Both tables take O(N) memory, a lookup is one
+ * hash of the key, two loads and one compare of the sizes and the bytes. Made by
+ * make_static_map, in a constexpr variable the tables are built by the compiler.
+ */
+template <typename V, std::size_t N>
+class static_map_t {
+   static_assert(N > 0 && N < 0xffff, "static_map_t expects 1 to 65534 keys");
+   using index_t = std::conditional_t<(N < 0xff), std::uint8_t, std::uint16_t>;
+
+public:
+   static constexpr std::size_t slot_count = detail::static_map_slots(N);
+   static constexpr std::size_t bucket_count = detail::static_map_buckets(N);
+
+   constexpr explicit static_map_t(const static_map_entry_t<V> (&entries_)[N]) {
+      for (std::size_t i = 0; i < N; ++i) {
+         entries[i] = entries_[i];
+         const auto &key = entries[i].key;
+         hashes[i] = detail::static_map_hash(key.data(), key.size());
+      }
+      for (; seed < detail::static_map_max_seeds; ++seed) {
+         if (place()) {
+            return;
+         }
+      }
+      DdsVerify(!"No perfect hash of the keys of static_map_t");
+   }
+
+   constexpr std::size_t size() const noexcept { return N; }
+
+   // value of `key`, nullptr if it is not a key
+   const V *find(StringView key) const noexcept {
+      auto hash = detail::static_map_hash(key.data(), key.size());
+      auto index = slots[slot(hash)];
+      if (index < N && hashes[index] == hash && entries[index].key.size() == key.size() &&
+          0 == std::memcmp(entries[index].key.data(), key.data(), key.size())) {
+         return &entries[index].value;
+      }
+      return nullptr;
+   }
+
+   bool contains(StringView key) const noexcept { return find(key) != nullptr; }
+
+   const static_map_entry_t<V> *begin() const noexcept { return entries; }
+   const static_map_entry_t<V> *end() const noexcept { return entries + N; }
+
+private:
+   static constexpr unsigned shift = detail::static_map_shift(slot_count);
+   static constexpr unsigned bucket_shift = detail::static_map_shift(bucket_count);
+
+   constexpr std::size_t bucket(std::uint64_t hash) const {
+      return detail::static_map_bucket(hash, seed, bucket_shift);
+   }
+
+   constexpr std::size_t slot(std::uint64_t hash) const {
+      auto displacement = displacements[bucket(hash)];
+      return detail::static_map_slot(
+         hash, detail::static_map_displace(displacement), shift);
+   }
+
+   // slots of all keys with the current seed of the buckets, false when a bucket has
+   // no displacement
+   constexpr bool place() {
+      for (auto &slot : slots) {
+         slot = N;
+      }
+      // keys sorted by their bucket, bucket b has keys [starts[b], starts[b + 1])
+      std::size_t starts[bucket_count + 1]{};
+      index_t keys[N]{};
+      std::size_t largest{};
+      for (std::size_t i = 0; i < N; ++i) {
+         ++starts[bucket(hashes[i]) + 1];
+      }
+      for (std::size_t b = 0; b < bucket_count; ++b) {
+         largest = starts[b + 1] > largest ? starts[b + 1] : largest;
+         starts[b + 1] += starts[b];
+      }
+      std::size_t filled[bucket_count]{};
+      for (std::size_t i = 0; i < N; ++i) {
+         auto b = bucket(hashes[i]);
+         keys[starts[b] + filled[b]++] = static_cast<index_t>(i);
+      }
+      // keys with the same hash are in the same bucket, duplicates among them
+      for (std::size_t b = 0; b < bucket_count; ++b) {
+         if (!distinct(keys + starts[b], keys + starts[b + 1])) {
+            return false;
+         }
+      }
+      for (auto size = largest; size > 0; --size) {
+         for (std::size_t b = 0; b < bucket_count; ++b) {
+            if (starts[b + 1] - starts[b] == size &&
+                !displace(b, keys + starts[b], keys + starts[b + 1])) {
+               return false;
+            }
+         }
+      }
+      return true;
+   }
+
+   // false when two keys have the same hash, no displacement separates them
+   constexpr bool distinct(const index_t *first, const index_t *last) const {
+      for (auto *i = first; i != last; ++i) {
+         for (auto *j = first; j != i; ++j) {
+            if (hashes[*i] == hashes[*j]) {
+               DdsVerify(!detail::static_map_equal(entries[*i].key, entries[*j].key) &&
+                         "Duplicate key of static_map_t");
+               return false;
+            }
+         }
+      }
+      return true;
+   }
+
+   // first displacement of bucket `b` moving keys [first, last) to free slots
+   constexpr bool displace(std::size_t b, const index_t *first, const index_t *last) {
+      for (std::uint32_t d = 0; d < detail::static_map_max_displacement; ++d) {
+         displacements[b] = static_cast<std::uint16_t>(d);
+         auto *key = first;
+         for (; key != last; ++key) {
+            auto &slot = slots[this->slot(hashes[*key])];
+            if (slot != N) {
+               break;
+            }
+            slot = *key;
+         }
+         if (key == last) {
+            return true;
+         }
+         // keys of the bucket placed with this displacement are removed again
+         for (auto *placed = first; placed != key; ++placed) {
+            slots[this->slot(hashes[*placed])] = N;
+         }
+      }
+      return false;
+   }
+
+   static_map_entry_t<V> entries[N]{};
+   std::uint64_t hashes[N]{};
+   std::uint64_t seed{};
+   std::uint16_t displacements[bucket_count]{};
+   index_t slots[slot_count]{};
+};
+
+template <typename V, std::size_t N>
+constexpr std::size_t static_map_t<V, N>::slot_count;
+
+template <typename V, std::size_t N>
+constexpr std::size_t static_map_t<V, N>::bucket_count;
+
+template <typename V, std::size_t N>
+constexpr unsigned static_map_t<V, N>::shift;
+
+template <typename V, std::size_t N>
+constexpr unsigned static_map_t<V, N>::bucket_shift;
+
+/*
+ * constexpr auto colors = make_static_map<int>({{"red", 1}, {"green", 2}});
+ */
+template <typename V, std::size_t N>
+constexpr static_map_t<V, N> make_static_map(const static_map_entry_t<V> (&entries)[N]) {
+   return static_map_t<V, N>{entries};
+}
+
+} // namespace DDS_MPL_NAMESPACE
+} // namespace DDS_ROOT_NAMESPACE
@@ -0,0 +1,116 @@
+#pragma once
+
+#include <mpl/config.h>
+#include <mpl/if_static.h>
+#include <mpl/nth_arg.h>
+
+#include <cstddef>
+#include <type_traits>
+
+namespace DDS_ROOT_NAMESPACE {
+namespace DDS_MPL_NAMESPACE {
+
+/*
+ * Branch of switch_static, created by case_static<K>(f) or default_static(f). It keeps
+ * a reference to `f`, so it must not outlive the full expression.
+ */
+template <long long K, typename F, bool Default = false>
+struct case_static_t {
+   static constexpr long long key = K;
+   static constexpr bool is_default = Default;
+
+   F &&f;
+};
+
+template <long long K, typename F>
+constexpr case_static_t<K, F> case_static(F &&f) {
+   return {static_cast<F &&>(f)};
+}
+
+template <typename F>
+constexpr case_static_t<0, F, true> default_static(F &&f) {
+   return {static_cast<F &&>(f)};
+}
+
+namespace detail {
+template <std::size_t N>
+struct switch_static_cases_t {
+   long long keys[N];
+   bool is_default[N];
+};
+
+// number of pairs of cases with the same key or of default cases
+template <std::size_t N>
+constexpr std::size_t switch_static_duplicates(const switch_static_cases_t<N> &cases) {
+   std::size_t ret{};
+   for (std::size_t i = 0; i < N; ++i) {
+      for (std::size_t j = i + 1; j < N; ++j) {
+         ret += cases.is_default[i] == cases.is_default[j] &&
+                (cases.is_default[i] || cases.keys[i] == cases.keys[j]);
+      }
+   }
+   return ret;
+}
+
+// index of the case with `key`, of the default case if none matches, N if no default
+template <std::size_t N>
+constexpr std::size_t switch_static_index(const switch_static_cases_t<N> &cases,
+                                          long long key) {
+   std::size_t ret = N;
+   for (std::size_t i = 0; i < N; ++i) {
+      if (cases.is_default[i]) {
+         ret = i;
+      } else if (cases.keys[i] == key) {
+         return i;
+      }
+   }
+   return ret;
+}
+
+// checks of the cases which don't depend on the key, done once for all keys
+template <typename... Cases>
+struct switch_static_info_t {
+   static constexpr switch_static_cases_t<sizeof...(Cases)> cases{
+      {std::decay_t<Cases>::key...}, {std::decay_t<Cases>::is_default...}};
+
+   static_assert(sizeof...(Cases) > 0, "switch_static expects cases");
+   static_assert(switch_static_duplicates(cases) == 0,
+                 "switch_static has duplicate keys or several default cases");
+};
+
+template <typename... Cases>
+constexpr switch_static_cases_t<sizeof...(Cases)> switch_static_info_t<Cases...>::cases;
+
+template <long long Key, typename... Cases>
+struct switch_static_select_t {
+   static constexpr std::size_t count = sizeof...(Cases);
+   static constexpr std::size_t index =
+      switch_static_index(switch_static_info_t<Cases...>::cases, Key);
+
+   static_assert(index < count, "switch_static has no case for the key and no default");
+
+   // valid index, so a missing case reports only the assert above
+   static constexpr std::size_t branch = index < count ? index : 0;
+
+   using branch_t = std::decay_t<nth_arg_t<branch, Cases...>>;
+   using type = forwarded_t<decltype(std::declval<branch_t>().f)>;
+};
+} // namespace detail
+
+/*
+ * N-way compile-time switch:
+ *    switch_static<Key>(case_static<K1>(f1), case_static<K2>(f2), ..., default_static(f))
+ * selects the branch of the case with `Key` (the default one when no case matches) and
+ * forwards it as if_static does. The case is found by a constexpr loop, so the
+ * instantiation depth doesn't grow with the number of cases.
+ */
+template <long long Key, typename... Cases>
+constexpr typename detail::switch_static_select_t<Key, Cases...>::type
+switch_static(Cases &&... cases) {
+   using Select = detail::switch_static_select_t<Key, Cases...>;
+   return static_cast<typename Select::type &&>(
+      nth_arg<Select::branch>(static_cast<Cases &&>(cases)...).f);
+}
+
+} // namespace DDS_MPL_NAMESPACE
+} // namespace DDS_ROOT_NAMESPACE
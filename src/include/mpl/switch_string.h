@@ -0,0 +1,58 @@
+#pragma once
+
+#include <common/common.h>
+#include <mpl/config.h>
+
+#include <cstddef>
+#include <cstring>
+#include <initializer_list>
+
+namespace DDS_ROOT_NAMESPACE {
+namespace DDS_MPL_NAMESPACE {
+
+/*
+ * Case of switch_string, the size of its literal key is a constant.
+ */
+template <typename F>
+struct string_case_t {
+   StringView key;
+   F f;
+};
+
+template <std::size_t N, typename F>
+constexpr string_case_t<F> case_(const char (&key)[N], F f) {
+   return {StringView{key, N - 1}, f};
+}
+
+namespace detail {
+template <typename F>
+bool string_case_call(StringView str, string_case_t<F> &c) {
+   if (str.size() != c.key.size() || std::memcmp(str.data(), c.key.data(), str.size())) {
+      return false;
+   }
+   c.f();
+   return true;
+}
+} // namespace detail
+
+/*
+ * Calls `f()` of the first case whose key is `str` and returns true, false if there is
+ * none:
+ *
+ * switch_string(opt, case_("--list", [&] { list = true; }),
+ *                    case_("--bench", [&] { bench = true; }));
+ *
+ * Sizes of the keys are constants, so a case of another size costs a compare of two
+ * integers and the keys compare as a few word loads. A lookup in a larger set of keys
+ * is faster in static_map_t.
+ */
+template <typename... Fs>
+bool switch_string(StringView str, string_case_t<Fs>... cases) {
+   bool ret = false;
+   (void)std::initializer_list<int>{
+      (ret = ret || detail::string_case_call(str, cases), 0)...};
+   return ret;
+}
+
+} // namespace DDS_MPL_NAMESPACE
+} // namespace DDS_ROOT_NAMESPACE
@@ -0,0 +1,422 @@
+#pragma once
+
+#include <mpl/config.h>
+#include <mpl/if_static.h>
+#include <mpl/type_tag.h>
+
+#include <cstddef>
+#include <type_traits>
+#include <utility>
+
+namespace DDS_ROOT_NAMESPACE {
+namespace DDS_MPL_NAMESPACE {
+
+/*
+ * List of types for metaprogramming with hundreds or thousands of entries. Operations
+ * are pack expansions and constexpr loops, recursion steps over chunks of 32 types or
+ * groups of 8 lists but never over single types, so lists of thousands of types stay
+ * far below the instantiation depth limit.
+ */
+template <typename... Ts>
+struct type_list_t {
+   static constexpr std::size_t size = sizeof...(Ts);
+};
+
+template <typename... Ts>
+constexpr std::size_t type_list_t<Ts...>::size;
+
+namespace detail {
+/*
+ * Indexing: `indexed_t` derives from `leaf_t<I, T>` for every element and `select<I>`
+ * deduces T from the only matching base. Deduction looks through all the bases, so long
+ * lists are split into chunks of `chunk_size` and an element is selected in its chunk
+ * after the chunk is selected in the list of chunks.
+ */
+template <std::size_t I, typename T>
+struct leaf_t {};
+
+template <typename Seq, typename... Ts>
+struct indexed_t;
+
+template <std::size_t... Is, typename... Ts>
+struct indexed_t<std::index_sequence<Is...>, Ts...> : leaf_t<Is, Ts>... {};
+
+template <std::size_t I, typename T>
+type_tag_t<T> select(leaf_t<I, T>);
+
+template <typename L>
+struct indexed_of_t;
+
+template <typename... Ts>
+struct indexed_of_t<type_list_t<Ts...>> {
+   using type = indexed_t<std::index_sequence_for<Ts...>, Ts...>;
+};
+
+template <typename L, std::size_t I>
+using select_t =
+   typename decltype(detail::select<I>(typename indexed_of_t<L>::type{}))::type;
+
+const std::size_t chunk_size = 32;
+
+// appends chunks of `chunk_size` types of the first list to the second one
+template <typename L, typename Chunks>
+struct chunks_t;
+
+template <typename... Ts, typename... Cs>
+struct chunks_t<type_list_t<Ts...>, type_list_t<Cs...>> {
+   using type = type_list_t<Cs..., type_list_t<Ts...>>;
+};
+
+// clang-format off
+template <typename T0, typename T1, typename T2, typename T3, typename T4, typename T5,
+          typename T6, typename T7, typename T8, typename T9, typename T10, typename T11,
+          typename T12, typename T13, typename T14, typename T15, typename T16,
+          typename T17, typename T18, typename T19, typename T20, typename T21,
+          typename T22, typename T23, typename T24, typename T25, typename T26,
+          typename T27, typename T28, typename T29, typename T30, typename T31,
+          typename... Rest, typename... Cs>
+struct chunks_t<type_list_t<T0, T1, T2, T3, T4, T5, T6, T7, T8, T9, T10, T11, T12, T13,
+                            T14, T15, T16, T17, T18, T19, T20, T21, T22, T23, T24, T25,
+                            T26, T27, T28, T29, T30, T31, Rest...>,
+                type_list_t<Cs...>>
+   : chunks_t<type_list_t<Rest...>,
+              type_list_t<Cs...,
+                          type_list_t<T0, T1, T2, T3, T4, T5, T6, T7, T8, T9, T10, T11,
+                                      T12, T13, T14, T15, T16, T17, T18, T19, T20, T21,
+                                      T22, T23, T24, T25, T26, T27, T28, T29, T30,
+                                      T31>>> {};
+// clang-format on
+
+// list of the chunks of L, computed once per list
+template <typename L>
+using chunked_t = typename chunks_t<L, type_list_t<>>::type;
+
+// element I of the list split into `Chunks`
+template <typename Chunks, std::size_t I>
+using chunked_at_t = select_t<select_t<Chunks, I / chunk_size>, I % chunk_size>;
+
+// identity of a type comparable in constant expressions, unlike std::is_same it
+// doesn't instantiate a template per pair of compared types
+template <typename T>
+struct type_id_t {
+   static constexpr char id{};
+};
+
+template <typename T>
+constexpr char type_id_t<T>::id;
+
+// result of the filtering and sorting algorithms, positions of the selected elements
+template <std::size_t N>
+struct index_array_t {
+   std::size_t size;
+   std::size_t values[N ? N : 1];
+};
+
+// type_list_t of the elements of L at the positions given by `Indices::value`
+template <typename L, typename Indices, typename Seq = void>
+struct pick_t : pick_t<L, Indices, std::make_index_sequence<Indices::value.size>> {};
+
+template <typename L, typename Indices, std::size_t... Is>
+struct pick_t<L, Indices, std::index_sequence<Is...>> {
+   using chunks = chunked_t<L>;
+   using type = type_list_t<chunked_at_t<chunks, Indices::value.values[Is]>...>;
+};
+
+// keys are compared as the type of the first one
+template <template <typename> class Key, typename T, typename...>
+struct key_type_t {
+   using type = std::decay_t<decltype(Key<T>::value)>;
+};
+
+template <typename L, template <typename> class Key>
+struct sort_indices_t;
+
+template <typename... Ts, template <typename> class Key>
+struct sort_indices_t<type_list_t<Ts...>, Key> {
+   // stable bottom-up merge sort of the positions by key
+   static constexpr index_array_t<sizeof...(Ts)> compute() {
+      using key_t = typename key_type_t<Key, Ts...>::type;
+      constexpr key_t keys[] = {static_cast<key_t>(Key<Ts>::value)...};
+      constexpr auto size = sizeof...(Ts);
+      index_array_t<size> ret{size, {}};
+      index_array_t<size> tmp{size, {}};
+      for (std::size_t i = 0; i < size; ++i) {
+         ret.values[i] = i;
+      }
+      for (std::size_t width = 1; width < size; width *= 2) {
+         for (std::size_t begin = 0; begin < size; begin += 2 * width) {
+            auto mid = begin + width < size ? begin + width : size;
+            auto end = mid + width < size ? mid + width : size;
+            auto l = begin;
+            auto r = mid;
+            for (auto i = begin; i < end; ++i) {
+               auto take_left =
+                  l < mid && (r == end || !(keys[ret.values[r]] < keys[ret.values[l]]));
+               if (take_left) {
+                  tmp.values[i] = ret.values[l++];
+               } else {
+                  tmp.values[i] = ret.values[r++];
+               }
+            }
+         }
+         for (std::size_t i = 0; i < size; ++i) {
+            ret.values[i] = tmp.values[i];
+         }
+      }
+      return ret;
+   }
+
+   static constexpr index_array_t<sizeof...(Ts)> value = compute();
+};
+
+template <typename... Ts, template <typename> class Key>
+constexpr index_array_t<sizeof...(Ts)> sort_indices_t<type_list_t<Ts...>, Key>::value;
+
+template <template <typename> class Key>
+struct sort_indices_t<type_list_t<>, Key> {
+   static constexpr index_array_t<0> value{};
+};
+
+template <template <typename> class Key>
+constexpr index_array_t<0> sort_indices_t<type_list_t<>, Key>::value;
+
+template <typename L, typename T>
+struct index_of_impl_t;
+
+template <typename... Ts, typename T>
+struct index_of_impl_t<type_list_t<Ts...>, T> {
+   // a local array, reading a static one is slow in constant expressions of gcc
+   static constexpr std::size_t find() {
+      constexpr const char *ids[] = {&type_id_t<Ts>::id..., nullptr};
+      for (std::size_t i = 0; i < sizeof...(Ts); ++i) {
+         if (ids[i] == &type_id_t<T>::id) {
+            return i;
+         }
+      }
+      return sizeof...(Ts);
+   }
+
+   static constexpr std::size_t value = find();
+};
+
+template <typename L, template <typename> class F>
+struct transform_impl_t;
+
+template <typename... Ts, template <typename> class F>
+struct transform_impl_t<type_list_t<Ts...>, F> {
+   using type = type_list_t<F<Ts>...>;
+};
+
+template <typename... Ls>
+struct concat_impl_t;
+
+template <>
+struct concat_impl_t<> {
+   using type = type_list_t<>;
+};
+
+template <typename... Ts>
+struct concat_impl_t<type_list_t<Ts...>> {
+   using type = type_list_t<Ts...>;
+};
+
+template <typename... T1s, typename... T2s, typename... Ls>
+struct concat_impl_t<type_list_t<T1s...>, type_list_t<T2s...>, Ls...>
+   : concat_impl_t<type_list_t<T1s..., T2s...>, Ls...> {};
+
+// many lists are joined 8 at a time
+template <typename... T1s,
+          typename... T2s,
+          typename... T3s,
+          typename... T4s,
+          typename... T5s,
+          typename... T6s,
+          typename... T7s,
+          typename... T8s,
+          typename... Ls>
+struct concat_impl_t<type_list_t<T1s...>,
+                     type_list_t<T2s...>,
+                     type_list_t<T3s...>,
+                     type_list_t<T4s...>,
+                     type_list_t<T5s...>,
+                     type_list_t<T6s...>,
+                     type_list_t<T7s...>,
+                     type_list_t<T8s...>,
+                     Ls...>
+   : concat_impl_t<
+        type_list_t<T1s..., T2s..., T3s..., T4s..., T5s..., T6s..., T7s..., T8s...>,
+        Ls...> {};
+
+template <template <typename> class Pred>
+struct filter_chunk_t {
+   template <typename T>
+   using keep_t = std::conditional_t<Pred<T>::value, type_list_t<T>, type_list_t<>>;
+
+   template <typename Chunk>
+   struct apply_impl_t;
+
+   template <typename... Ts>
+   struct apply_impl_t<type_list_t<Ts...>> : concat_impl_t<keep_t<Ts>...> {};
+
+   template <typename Chunk>
+   using apply = typename apply_impl_t<Chunk>::type;
+};
+
+template <typename Ls>
+struct join_t;
+
+template <typename... Ls>
+struct join_t<type_list_t<Ls...>> : concat_impl_t<Ls...> {};
+
+// every chunk is filtered by concatenation of lists of 0 or 1 types, then the chunks
+// are joined, so neither concatenation is long
+template <typename L, template <typename> class Pred>
+using filter_impl_t = join_t<
+   typename transform_impl_t<chunked_t<L>, filter_chunk_t<Pred>::template apply>::type>;
+
+// class derived from type_tag_t<T> for every T of a list without duplicates
+template <typename L>
+struct type_set_t;
+
+template <typename... Ts>
+struct type_set_t<type_list_t<Ts...>> : type_tag_t<Ts>... {};
+
+template <typename Set>
+struct not_in_set_t {
+   template <typename T>
+   using apply = bool_t<!std::is_base_of<type_tag_t<T>, Set>::value>;
+};
+
+// A followed by the types of B which are not in A, both are without duplicates
+template <typename A, typename B>
+using merge_unique_t = concat_impl_t<
+   A,
+   typename filter_impl_t<B, not_in_set_t<type_set_t<A>>::template apply>::type>;
+
+/*
+ * Types are compared by the base lookup of std::is_base_of, constexpr comparisons of
+ * every pair are too slow for long lists. Lists without duplicates are merged in pairs
+ * until one is left, so the depth is log2 of their count.
+ */
+template <typename Ls, typename Seq = void>
+struct merge_all_t
+   : merge_all_t<Ls, std::make_index_sequence<(Ls::size + 1) / 2>> {};
+
+template <>
+struct merge_all_t<type_list_t<>, void> {
+   using type = type_list_t<>;
+};
+
+template <typename L>
+struct merge_all_t<type_list_t<L>, void> {
+   using type = L;
+};
+
+template <typename... Ls, std::size_t... Is>
+struct merge_all_t<type_list_t<Ls...>, std::index_sequence<Is...>> {
+   // the last list is merged with an empty one when the count is odd
+   using padded = type_list_t<Ls..., type_list_t<>>;
+   using type = typename merge_all_t<type_list_t<typename merge_unique_t<
+      select_t<padded, 2 * Is>,
+      select_t<padded, 2 * Is + 1>>::type...>>::type;
+};
+
+template <typename Chunk, typename Seq = void>
+struct unique_chunk_t : unique_chunk_t<Chunk, std::make_index_sequence<Chunk::size>> {};
+
+// types of a chunk are compared in pairs
+template <typename... Ts, std::size_t... Is>
+struct unique_chunk_t<type_list_t<Ts...>, std::index_sequence<Is...>> {
+   static constexpr bool is_first(std::size_t index) {
+      constexpr const char *ids[] = {&type_id_t<Ts>::id..., nullptr};
+      for (std::size_t i = 0; i < index; ++i) {
+         if (ids[i] == ids[index]) {
+            return false;
+         }
+      }
+      return true;
+   }
+
+   using type = typename concat_impl_t<
+      std::conditional_t<is_first(Is), type_list_t<Ts>, type_list_t<>>...>::type;
+};
+
+template <typename Chunk>
+using unique_chunk = typename unique_chunk_t<Chunk>::type;
+
+// chunks are made unique, then merged
+template <typename L>
+using unique_impl_t =
+   merge_all_t<typename transform_impl_t<chunked_t<L>, unique_chunk>::type>;
+
+// folds of packs, as constexpr loops over arrays
+template <std::size_t N>
+constexpr std::size_t max_of(const std::size_t (&values)[N]) {
+   std::size_t ret{};
+   for (auto value : values) {
+      ret = value > ret ? value : ret;
+   }
+   return ret;
+}
+
+template <std::size_t N>
+constexpr std::size_t sum_of(const std::size_t (&values)[N]) {
+   std::size_t ret{};
+   for (auto value : values) {
+      ret += value;
+   }
+   return ret;
+}
+
+template <bool... Bs>
+constexpr bool all_of() {
+   constexpr bool values[] = {Bs..., true};
+   for (auto value : values) {
+      if (!value) {
+         return false;
+      }
+   }
+   return true;
+}
+
+template <typename L, std::size_t I>
+struct at_impl_t {
+   static_assert(I < L::size, "Index out of range");
+
+   using type = chunked_at_t<chunked_t<L>, I>;
+};
+} // namespace detail
+
+// element I of L
+template <typename L, std::size_t I>
+using at_t = typename detail::at_impl_t<L, I>::type;
+
+// position of the first T in L, L::size when it isn't there
+template <typename L, typename T>
+using index_of_t =
+   std::integral_constant<std::size_t, detail::index_of_impl_t<L, T>::value>;
+
+template <typename L, typename T>
+using contains_t = bool_t<detail::index_of_impl_t<L, T>::value != L::size>;
+
+template <typename... Ls>
+using concat_t = typename detail::concat_impl_t<Ls...>::type;
+
+// list of F<T> for every T of L, F is an alias like std::add_pointer_t
+template <typename L, template <typename> class F>
+using transform_t = typename detail::transform_impl_t<L, F>::type;
+
+// elements T of L with Pred<T>::value true, in their order
+template <typename L, template <typename> class Pred>
+using filter_t = typename detail::filter_impl_t<L, Pred>::type;
+
+// first occurrences of the types of L
+template <typename L>
+using unique_t = typename detail::unique_impl_t<L>::type;
+
+// L stably sorted by Key<T>::value
+template <typename L, template <typename> class Key>
+using sort_by_t = typename detail::pick_t<L, detail::sort_indices_t<L, Key>>::type;
+
+} // namespace DDS_MPL_NAMESPACE
+} // namespace DDS_ROOT_NAMESPACE
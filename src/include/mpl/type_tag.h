@@ -0,0 +1,17 @@
+#pragma once
+
+#include <mpl/config.h>
+
+namespace DDS_ROOT_NAMESPACE {
+namespace DDS_MPL_NAMESPACE {
+
+/*
+ * Type passed as a value, to a generic lambda for example: `f(type_tag_t<T>{})`.
+ */
+template <typename T>
+struct type_tag_t {
+   using type = T;
+};
+
+} // namespace DDS_MPL_NAMESPACE
+} // namespace DDS_ROOT_NAMESPACE
@@ -0,0 +1,304 @@
+#pragma once
+
+#include <common/common.h>
+#include <mpl/config.h>
+#include <mpl/dispatch_static.h>
+#include <mpl/if_static.h>
+#include <mpl/type_list.h>
+
+#include <cstddef>
+#include <cstdint>
+#include <new>
+#include <type_traits>
+#include <utility>
+
+namespace DDS_ROOT_NAMESPACE {
+namespace DDS_MPL_NAMESPACE {
+
+namespace detail {
+// up to this many alternatives a chain of comparisons of the index is faster than the
+// indirect call of dispatch_static (it is inlined and predicted per alternative)
+constexpr std::size_t variant_chain_max = 8;
+
+// smallest unsigned type for N alternatives
+template <std::size_t N>
+using variant_index_t =
+   std::conditional_t<N <= 0xff,
+                      std::uint8_t,
+                      std::conditional_t<N <= 0xffff, std::uint16_t, std::uint32_t>>;
+} // namespace detail
+
+/*
+ * Tagged union of distinct types Ts without heap allocation, the C++14 counterpart of
+ * std::variant. It always holds one of the alternatives: the first one is default
+ * constructed and the alternatives must be nothrow move constructible, so an
+ * assignment which throws keeps the previous value. The index is the smallest unsigned
+ * type for sizeof...(Ts) values. A value converts only to the alternative of its own
+ * type, there is no overload resolution between the alternatives.
+ */
+template <typename... Ts>
+class variant_t {
+   using types = type_list_t<Ts...>;
+
+   static_assert(sizeof...(Ts) > 0, "variant_t expects alternatives");
+   static_assert(unique_t<types>::size == sizeof...(Ts), "Duplicate alternatives");
+   static_assert(detail::all_of<std::is_nothrow_move_constructible<Ts>::value...>(),
+                 "Alternatives must be nothrow move constructible");
+
+   template <typename T>
+   using enable_alternative_t =
+      std::enable_if_t<contains_t<types, std::decay_t<T>>::value>;
+
+public:
+   using index_type = detail::variant_index_t<sizeof...(Ts)>;
+
+   static constexpr std::size_t size = sizeof...(Ts);
+
+   template <std::size_t I>
+   using alternative_t = at_t<types, I>;
+
+   template <typename T>
+   using index_of_alternative_t = index_of_t<types, T>;
+
+   variant_t() noexcept(std::is_nothrow_default_constructible<alternative_t<0>>::value) {
+      construct<0>();
+   }
+
+   template <typename T, typename = enable_alternative_t<T>>
+   variant_t(T &&value) noexcept(
+      std::is_nothrow_constructible<std::decay_t<T>, T &&>::value) {
+      construct<index_of_alternative_t<std::decay_t<T>>::value>(static_cast<T &&>(value));
+   }
+
+   variant_t(const variant_t &other) {
+      other.with_index([&](auto i) { construct<i>(other.template get_unchecked<i>()); });
+   }
+
+   variant_t(variant_t &&other) noexcept {
+      other.with_index([&](auto i) {
+         construct<i>(std::move(other).template get_unchecked<i>());
+      });
+   }
+
+   ~variant_t() { destroy(); }
+
+   variant_t &operator=(const variant_t &other) {
+      if (this != &other) {
+         if (index_ == other.index_) {
+            with_index(
+               [&](auto i) { get_unchecked<i>() = other.template get_unchecked<i>(); });
+         } else {
+            // copied first, so a throwing copy leaves this unchanged
+            *this = variant_t{other};
+         }
+      }
+      return *this;
+   }
+
+   variant_t &operator=(variant_t &&other) noexcept(
+      detail::all_of<std::is_nothrow_move_assignable<Ts>::value...>()) {
+      if (this != &other) {
+         if (index_ == other.index_) {
+            with_index([&](auto i) {
+               get_unchecked<i>() = std::move(other).template get_unchecked<i>();
+            });
+         } else {
+            destroy();
+            other.with_index([&](auto i) {
+               construct<i>(std::move(other).template get_unchecked<i>());
+            });
+         }
+      }
+      return *this;
+   }
+
+   template <typename T, typename = enable_alternative_t<T>>
+   variant_t &operator=(T &&value) {
+      constexpr auto index = index_of_alternative_t<std::decay_t<T>>::value;
+      if (index == index_) {
+         get_unchecked<index>() = static_cast<T &&>(value);
+      } else {
+         emplace<std::decay_t<T>>(static_cast<T &&>(value));
+      }
+      return *this;
+   }
+
+   /*
+    * Replaces the value by T constructed from `args`. It is constructed in a temporary
+    * first when the constructor may throw.
+    */
+   template <typename T, typename... Args>
+   T &emplace(Args &&...args) {
+      constexpr auto index = index_of_alternative_t<T>::value;
+      static_assert(index < size, "Not an alternative");
+      if (std::is_nothrow_constructible<T, Args &&...>::value) {
+         destroy();
+         construct<index>(static_cast<Args &&>(args)...);
+      } else {
+         T value(static_cast<Args &&>(args)...);
+         destroy();
+         construct<index>(std::move(value));
+      }
+      return get_unchecked<index>();
+   }
+
+   std::size_t index() const noexcept { return index_; }
+
+   // value of alternative I, which must be the held one
+   template <std::size_t I>
+   alternative_t<I> &get_unchecked() & noexcept {
+      return *reinterpret_cast<alternative_t<I> *>(&storage);
+   }
+
+   template <std::size_t I>
+   const alternative_t<I> &get_unchecked() const & noexcept {
+      return *reinterpret_cast<const alternative_t<I> *>(&storage);
+   }
+
+   template <std::size_t I>
+   alternative_t<I> &&get_unchecked() && noexcept {
+      return std::move(*reinterpret_cast<alternative_t<I> *>(&storage));
+   }
+
+   // f(int_t<index()>{}) through a chain of comparisons or a table of functions
+   template <typename F>
+   decltype(auto) with_index(F &&f) const {
+      using chain = bool_t<(size <= detail::variant_chain_max)>;
+      return with_index(static_cast<F &&>(f), chain{});
+   }
+
+private:
+   template <typename F>
+   decltype(auto) with_index(F &&f, true_t /*chain*/) const {
+      return with_index_chain<0>(static_cast<F &&>(f), bool_t<1 == size>{});
+   }
+
+   template <typename F>
+   decltype(auto) with_index(F &&f, false_t /*chain*/) const {
+      return dispatch_static<0, static_cast<int>(size) - 1>(static_cast<int>(index_),
+                                                               static_cast<F &&>(f));
+   }
+
+   // the last alternative is held when none of the previous ones is
+   template <int I, typename F>
+   decltype(auto) with_index_chain(F &&f, true_t /*last*/) const {
+      return static_cast<F &&>(f)(int_t<I>{});
+   }
+
+   template <int I, typename F>
+   decltype(auto) with_index_chain(F &&f, false_t /*last*/) const {
+      if (I == index_) {
+         return static_cast<F &&>(f)(int_t<I>{});
+      }
+      return with_index_chain<I + 1>(static_cast<F &&>(f),
+                                     bool_t<I + 2 == static_cast<int>(size)>{});
+   }
+
+   template <std::size_t I, typename... Args>
+   void construct(Args &&...args) {
+      new (&storage) alternative_t<I>(static_cast<Args &&>(args)...);
+      index_ = static_cast<index_type>(I);
+   }
+
+   void destroy() noexcept {
+      if (!detail::all_of<std::is_trivially_destructible<Ts>::value...>()) {
+         with_index([&](auto i) {
+            using T = alternative_t<decltype(i)::value>;
+            get_unchecked<i>().~T();
+         });
+      }
+   }
+
+   alignas(Ts...) unsigned char storage[detail::max_of({sizeof(Ts)...})];
+   index_type index_{};
+};
+
+template <typename... Ts>
+constexpr std::size_t variant_t<Ts...>::size;
+
+template <typename T, typename... Ts>
+bool holds_alternative(const variant_t<Ts...> &v) noexcept {
+   return index_of_t<type_list_t<Ts...>, T>::value == v.index();
+}
+
+/*
+ * Value of alternative I or of type T, which must be the held one.
+ */
+template <std::size_t I, typename... Ts>
+decltype(auto) get(variant_t<Ts...> &v) {
+   DdsVerify(I == v.index() && "Alternative is not held");
+   return v.template get_unchecked<I>();
+}
+
+template <std::size_t I, typename... Ts>
+decltype(auto) get(const variant_t<Ts...> &v) {
+   DdsVerify(I == v.index() && "Alternative is not held");
+   return v.template get_unchecked<I>();
+}
+
+template <std::size_t I, typename... Ts>
+decltype(auto) get(variant_t<Ts...> &&v) {
+   DdsVerify(I == v.index() && "Alternative is not held");
+   return std::move(v).template get_unchecked<I>();
+}
+
+template <typename T, typename V>
+decltype(auto) get(V &&v) {
+   using index = typename std::decay_t<V>::template index_of_alternative_t<T>;
+   return get<index::value>(static_cast<V &&>(v));
+}
+
+// pointer to the value of type T, nullptr when another alternative is held
+template <typename T, typename... Ts>
+T *get_if(variant_t<Ts...> *v) noexcept {
+   return v && holds_alternative<T>(*v)
+             ? &v->template get_unchecked<index_of_t<type_list_t<Ts...>, T>::value>()
+             : nullptr;
+}
+
+template <typename T, typename... Ts>
+const T *get_if(const variant_t<Ts...> *v) noexcept {
+   return v && holds_alternative<T>(*v)
+             ? &v->template get_unchecked<index_of_t<type_list_t<Ts...>, T>::value>()
+             : nullptr;
+}
+
+/*
+ * Calls `f` with the held values of `vs`, which keep their value category. The held
+ * alternative of a single variant with up to `variant_chain_max` alternatives is found
+ * by comparisons of the index. Otherwise a single indirect call selects the
+ * instantiation for the combination of the held alternatives (see
+ * dispatch_static_product). All the instantiations must return the same type.
+ */
+template <typename F, typename V>
+decltype(auto) visit(F &&f, V &&v) {
+   return v.with_index([&](auto i) -> decltype(auto) {
+      return static_cast<F &&>(f)(static_cast<V &&>(v).template get_unchecked<i>());
+   });
+}
+
+template <typename F, typename... Vs>
+decltype(auto) visit(F &&f, Vs &&...vs) {
+   static_assert(sizeof...(Vs) > 0, "visit expects variants");
+   return dispatch_static_product<
+      static_range_t<0, static_cast<int>(std::decay_t<Vs>::size) - 1>...>(
+      {static_cast<int>(vs.index())...}, [&](auto... is) -> decltype(auto) {
+         return static_cast<F &&>(f)(
+            static_cast<Vs &&>(vs).template get_unchecked<decltype(is)::value>()...);
+      });
+}
+
+template <typename... Ts>
+bool operator==(const variant_t<Ts...> &lhs, const variant_t<Ts...> &rhs) {
+   return lhs.index() == rhs.index() && lhs.with_index([&](auto i) {
+      return lhs.template get_unchecked<i>() == rhs.template get_unchecked<i>();
+   });
+}
+
+template <typename... Ts>
+bool operator!=(const variant_t<Ts...> &lhs, const variant_t<Ts...> &rhs) {
+   return !(lhs == rhs);
+}
+
+} // namespace DDS_MPL_NAMESPACE
+} // namespace DDS_ROOT_NAMESPACE
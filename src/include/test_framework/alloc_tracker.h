@@ -0,0 +1,136 @@
+#pragma once
+
+/*
+ * Heap allocation accounting for the tiny test framework.
+ *
+ * It is enabled by defining DDS_TINYTEST_TRACK_ALLOCS before including
+ * <test_framework/tiny_framework.h> in the file which uses TESTS_BEGIN(). Then the
+ * global operator new/delete of the test binary are replaced and every allocation is
+ * counted for the thread which does it. Test runner attributes allocations done by the
+ * thread running a test case to that test case, so allocations from threads started by
+ * the test case itself are not included.
+ */
+
+#include <common/common.h>
+#include <test_framework/config.h>
+
+#include <cstddef>
+#include <cstdlib>
+
+namespace DDS_ROOT_NAMESPACE {
+namespace DDS_TINYTEST_NAMESPACE {
+
+// allocation counters of a thread
+struct __alloc_counters_t {
+   std::size_t count;     // number of allocations
+   std::size_t bytes;     // allocated bytes
+   std::ptrdiff_t live;   // currently allocated bytes
+   std::ptrdiff_t peak;   // maximum of `live`
+};
+
+inline __alloc_counters_t &__alloc_counters() {
+   static thread_local __alloc_counters_t counters{};
+   return counters;
+}
+
+// set when operator new/delete are replaced (DDS_TINYTEST_TRACK_ALLOCS)
+inline bool &__alloc_tracking_enabled() {
+   static bool enabled{};
+   return enabled;
+}
+
+/*
+ * Every block starts with a header holding its size, so `free` knows how many bytes
+ * are released. Header keeps the fundamental alignment of the returned pointer.
+ */
+union __alloc_header_t {
+   std::size_t size;
+   std::max_align_t align;
+};
+
+inline void *__tracked_alloc(std::size_t size) {
+   auto *header = static_cast<__alloc_header_t *>(
+      std::malloc(sizeof(__alloc_header_t) + (size ? size : 1)));
+   if (!header) {
+      return nullptr;
+   }
+   header->size = size;
+   auto &counters = __alloc_counters();
+   ++counters.count;
+   counters.bytes += size;
+   counters.live += static_cast<std::ptrdiff_t>(size);
+   if (counters.live > counters.peak) {
+      counters.peak = counters.live;
+   }
+   return header + 1;
+}
+
+inline void __tracked_free(void *ptr) {
+   if (!ptr) {
+      return;
+   }
+   auto *header = static_cast<__alloc_header_t *>(ptr) - 1;
+   __alloc_counters().live -= static_cast<std::ptrdiff_t>(header->size);
+   std::free(header);
+}
+
+// allocations done by a test case
+struct __alloc_stats_t {
+   std::size_t count{};
+   std::size_t bytes{};
+   std::size_t peak{}; // peak of live bytes allocated during the test case
+};
+
+/*
+ * Measures allocations of the current thread from construction till `stats()`.
+ */
+class __alloc_probe_t {
+public:
+   __alloc_probe_t()
+      : start{__alloc_counters()} {
+      // peak is measured relative to the memory live at the start
+      __alloc_counters().peak = start.live;
+   }
+
+   __alloc_stats_t stats() const {
+      auto &now = __alloc_counters();
+      __alloc_stats_t ret;
+      ret.count = now.count - start.count;
+      ret.bytes = now.bytes - start.bytes;
+      ret.peak = static_cast<std::size_t>(now.peak - start.live);
+      return ret;
+   }
+
+private:
+   __alloc_counters_t start;
+};
+
+/*
+ * State of TEST_CHECK_ALLOCS_AT_MOST scope, which is implemented as a loop running its
+ * body once.
+ */
+class __alloc_scope_t {
+public:
+   explicit __alloc_scope_t(std::size_t limit_)
+      : limit{limit_} {}
+
+   bool enter() {
+      if (entered) {
+         return false;
+      }
+      entered = true;
+      start = __alloc_counters().count;
+      return true;
+   }
+
+   std::size_t allocations() const { return __alloc_counters().count - start; }
+
+   const std::size_t limit;
+
+private:
+   bool entered{};
+   std::size_t start{};
+};
+
+} // namespace DDS_TINYTEST_NAMESPACE
+} // namespace DDS_ROOT_NAMESPACE
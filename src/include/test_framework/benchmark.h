@@ -0,0 +1,316 @@
+#pragma once
+
+/*
+ * Micro-benchmark support for the tiny test framework (see TEST_BENCHMARK).
+ *
+ * Benchmark body is called several times. Every call runs TEST_BENCHMARK_LOOP with a
+ * number of iterations chosen by the framework and only the loop itself is timed, so
+ * setup code before the loop is not measured:
+ *
+ * TEST_BENCHMARK(vector_sum) {
+ *    std::vector<int> v(1024, 1);
+ *    TEST_BENCHMARK_ITEMS(v.size());
+ *    TEST_BENCHMARK_LOOP {
+ *       auto sum = std::accumulate(v.begin(), v.end(), 0);
+ *       dds::tiny_test::do_not_optimize(sum);
+ *    }
+ * }
+ */
+
+#include <common/common.h>
+#include <common/function_ref.h>
+#include <test_framework/config.h>
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cmath>
+#include <cstddef>
+#include <vector>
+
+namespace DDS_ROOT_NAMESPACE {
+namespace DDS_TINYTEST_NAMESPACE {
+
+#if defined(__GNUC__) || defined(__clang__)
+/*
+ * Force `value` to be computed and kept, so the compiler can't drop the benchmarked
+ * code as unused.
+ */
+template <typename T>
+inline void do_not_optimize(const T &value) {
+   asm volatile("" : : "r,m"(value) : "memory");
+}
+
+template <typename T>
+inline void do_not_optimize(T &value) {
+   asm volatile("" : "+r,m"(value) : : "memory");
+}
+
+/*
+ * Force all pending writes to memory to be done at this point.
+ */
+inline void clobber_memory() { asm volatile("" : : : "memory"); }
+#else
+template <typename T>
+inline void do_not_optimize(const T &value) {
+   const volatile void *volatile sink = &value;
+   (void)sink;
+}
+
+inline void clobber_memory() { std::atomic_signal_fence(std::memory_order_acq_rel); }
+#endif
+
+/*
+ * State of a single call of a benchmark body. It is iterated by TEST_BENCHMARK_LOOP,
+ * timer runs from the start to the end of the loop.
+ */
+class __bench_state_t {
+public:
+   using clock_t = std::chrono::steady_clock;
+
+   // value of the loop variable, marked as unused to avoid warnings
+#if defined(__GNUC__) || defined(__clang__)
+   struct __attribute__((unused)) value_t {};
+#else
+   struct value_t {};
+#endif
+
+   struct iterator {
+      bool operator!=(const iterator &) {
+         if (remaining) {
+            return true;
+         }
+         state->stop();
+         return false;
+      }
+      iterator &operator++() {
+         --remaining;
+         return *this;
+      }
+      value_t operator*() const { return {}; }
+
+      __bench_state_t *state;
+      std::size_t remaining;
+   };
+
+   explicit __bench_state_t(std::size_t iterations_)
+      : iterations{iterations_} {}
+
+   iterator begin() {
+      start_time = clock_t::now();
+      return {this, iterations};
+   }
+   iterator end() { return {this, 0}; }
+
+   const std::size_t iterations;
+   bool measured{};
+   clock_t::duration elapsed{};
+   double items_per_iteration{};
+   double bytes_per_iteration{};
+
+private:
+   void stop() {
+      elapsed = clock_t::now() - start_time;
+      measured = true;
+   }
+
+   clock_t::time_point start_time;
+};
+
+struct __bench_options_t {
+   unsigned samples{10};
+   std::chrono::nanoseconds sample_time{std::chrono::milliseconds{5}};
+};
+
+struct __bench_stats_t {
+   std::size_t iterations{}; // iterations per sample
+   std::vector<double> samples; // nanoseconds per iteration
+   double min{};
+   double median{};
+   double mean{};
+   double stddev{};
+   double items_per_iteration{};
+   double bytes_per_iteration{};
+
+   void compute() {
+      if (samples.empty()) {
+         return;
+      }
+      auto sorted = samples;
+      std::sort(sorted.begin(), sorted.end());
+      auto n = sorted.size();
+      min = sorted.front();
+      median = n % 2 ? sorted[n / 2] : (sorted[n / 2 - 1] + sorted[n / 2]) / 2;
+      double sum{};
+      for (auto s : sorted) {
+         sum += s;
+      }
+      mean = sum / n;
+      double sq{};
+      for (auto s : sorted) {
+         sq += (s - mean) * (s - mean);
+      }
+      stddev = n > 1 ? std::sqrt(sq / (n - 1)) : 0.0;
+   }
+};
+
+/*
+ * Summary of benchmark samples as stored in a baseline file.
+ */
+struct __bench_summary_t {
+   std::size_t samples{};
+   double mean{};
+   double stddev{};
+};
+
+/*
+ * Regularized incomplete beta function I_x(a, b), evaluated by continued fraction.
+ */
+inline double __incomplete_beta(double a, double b, double x) {
+   if (x <= 0) {
+      return 0;
+   }
+   if (x >= 1) {
+      return 1;
+   }
+   if (x > (a + 1) / (a + b + 2)) {
+      return 1 - __incomplete_beta(b, a, 1 - x);
+   }
+   const double tiny = 1e-300;
+   auto front = std::exp(std::lgamma(a + b) - std::lgamma(a) - std::lgamma(b) +
+                         a * std::log(x) + b * std::log(1 - x)) /
+                a;
+   double f = 1, c = 1, d = 0;
+   for (int i = 0; i <= 400; ++i) {
+      int m = i / 2;
+      double numerator;
+      if (i == 0) {
+         numerator = 1;
+      } else if (i % 2) {
+         numerator = -((a + m) * (a + b + m) * x) / ((a + 2 * m) * (a + 2 * m + 1));
+      } else {
+         numerator = (m * (b - m) * x) / ((a + 2 * m - 1) * (a + 2 * m));
+      }
+      d = 1 + numerator * d;
+      d = 1 / (std::fabs(d) < tiny ? tiny : d);
+      c = 1 + numerator / c;
+      c = std::fabs(c) < tiny ? tiny : c;
+      f *= c * d;
+      if (std::fabs(1 - c * d) < 1e-12) {
+         return front * (f - 1);
+      }
+   }
+   return front * (f - 1);
+}
+
+/*
+ * Quantile of Student's t-distribution with `df` degrees of freedom, for p > 0.5.
+ */
+inline double __student_t_quantile(double p, double df) {
+   auto cdf = [df](double t) {
+      return 1 - 0.5 * __incomplete_beta(df / 2, 0.5, df / (df + t * t));
+   };
+   double low = 0, high = 1e3;
+   for (int i = 0; i < 100; ++i) {
+      auto mid = (low + high) / 2;
+      (cdf(mid) < p ? low : high) = mid;
+   }
+   return (low + high) / 2;
+}
+
+/*
+ * Welch's t-test of `current` against `baseline`. Change of the mean time and its
+ * confidence interval are relative to the baseline mean (0.1 means 10% slower).
+ */
+struct __bench_compare_t {
+   double change{};
+   double low{};
+   double high{};
+   bool significant{};
+
+   __bench_compare_t(const __bench_summary_t &baseline,
+                     const __bench_summary_t &current,
+                     double confidence) {
+      if (baseline.mean <= 0 || !baseline.samples || !current.samples) {
+         return;
+      }
+      auto diff = current.mean - baseline.mean;
+      auto vb = baseline.stddev * baseline.stddev / baseline.samples;
+      auto vc = current.stddev * current.stddev / current.samples;
+      auto se = std::sqrt(vb + vc);
+      double margin{};
+      if (se > 0) {
+         // Welch-Satterthwaite degrees of freedom
+         double denominator{};
+         if (baseline.samples > 1) {
+            denominator += vb * vb / (baseline.samples - 1);
+         }
+         if (current.samples > 1) {
+            denominator += vc * vc / (current.samples - 1);
+         }
+         auto df = denominator > 0 ? (vb + vc) * (vb + vc) / denominator : 1.0;
+         margin = __student_t_quantile(1 - (1 - confidence) / 2, std::max(df, 1.0)) * se;
+      }
+      change = diff / baseline.mean;
+      low = (diff - margin) / baseline.mean;
+      high = (diff + margin) / baseline.mean;
+      significant = low > 0 || high < 0;
+   }
+
+   // the change is real and larger than `threshold` of the baseline mean
+   bool exceeds(double threshold) const {
+      return significant && std::fabs(change) > threshold;
+   }
+};
+
+/*
+ * Calibrate the number of iterations so a sample takes at least `sample_time`, run one
+ * warm-up sample and then measure `samples` samples of `body(__bench_state_t &)`.
+ * Returns false if `body` didn't finish its loop (e.g. failed TEST_REQUIRE).
+ */
+inline bool __measure_benchmark(function_ref_t<void(__bench_state_t &)> body,
+                                const __bench_options_t &options,
+                                __bench_stats_t &stats) {
+   using ns_t = std::chrono::nanoseconds;
+   const auto target = std::max<ns_t::rep>(options.sample_time.count(), 1);
+   const std::size_t max_iterations = std::size_t{1} << 40;
+
+   std::size_t iterations{1};
+   for (;;) {
+      __bench_state_t state{iterations};
+      body(state);
+      if (!state.measured) {
+         return false;
+      }
+      auto elapsed = std::chrono::duration_cast<ns_t>(state.elapsed).count();
+      if (elapsed >= target || iterations >= max_iterations) {
+         break;
+      }
+      // aim a bit above the target, but grow at most 100 times per step
+      auto scale = 1.2 * target / std::max<ns_t::rep>(elapsed, 1);
+      iterations = static_cast<std::size_t>(
+         iterations * std::min(std::max(scale, 2.0), 100.0));
+   }
+
+   __bench_state_t warm_up{iterations};
+   body(warm_up);
+
+   stats.iterations = iterations;
+   stats.samples.clear();
+   for (unsigned i = 0; i < std::max(options.samples, 1u); ++i) {
+      __bench_state_t state{iterations};
+      body(state);
+      if (!state.measured) {
+         return false;
+      }
+      auto elapsed = std::chrono::duration_cast<ns_t>(state.elapsed).count();
+      stats.samples.push_back(static_cast<double>(elapsed) / iterations);
+      stats.items_per_iteration = state.items_per_iteration;
+      stats.bytes_per_iteration = state.bytes_per_iteration;
+   }
+   stats.compute();
+   return true;
+}
+
+} // namespace DDS_TINYTEST_NAMESPACE
+} // namespace DDS_ROOT_NAMESPACE
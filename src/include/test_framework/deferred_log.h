@@ -0,0 +1,673 @@
+#pragma once
+
+/*
+ * Deferred print/println: the calling thread copies only the raw bytes of the arguments
+ * to its own ring buffer, and they are converted to text later by a background thread.
+ *
+ *    deferred_println("request", id, "took", elapsed_ns);
+ *
+ * Output is the same as of println with the same arguments and goes to the same
+ * `StreamGetter<Stream>`. Every call signature (stream, newline, argument types) has a
+ * static descriptor, which is the ID of its records. Arguments may be arithmetic types,
+ * pointers and strings, which are copied; other types would need the text conversion
+ * on the calling thread, so they are rejected at compile time.
+ *
+ * Lines of one thread keep their order, lines of different threads are ordered only
+ * by the time the background thread collects them. When the ring of a thread is full
+ * the line is dropped and counted. deferred_log_flush() converts everything logged so
+ * far. Instead of converting, records can be written to a binary log with
+ * deferred_log_binary(), which is converted to text after the run with
+ * deferred_log_decode().
+ */
+
+#include <common/common.h>
+#include <test_framework/format.h>
+#include <test_framework/tools.h>
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <istream>
+#include <memory>
+#include <mutex>
+#include <ostream>
+#include <string>
+#include <thread>
+#include <tuple>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+namespace print_detail {
+
+struct DeferredSite;
+
+/*
+ * Single producer (the logging thread), single consumer ring of records. Record is
+ * contiguous: when it doesn't fit before the end of the buffer, the rest of the buffer
+ * is skipped with a padding record, or without one when it's shorter than a header.
+ */
+class DeferredRing {
+public:
+   struct Header {
+      std::uint32_t size; // whole record including the header, multiple of 8
+      char sep;
+      const DeferredSite *site; // nullptr - padding
+   };
+
+   static constexpr std::size_t header_size = (sizeof(Header) + 7) & ~std::size_t{7};
+
+   explicit DeferredRing(std::size_t capacity_)
+      : capacity{round_capacity(capacity_)}
+      , buffer{new char[capacity]} {}
+
+   // space for a record with `payload` bytes or nullptr when the ring is full
+   char *try_reserve(std::size_t payload, std::size_t &size) {
+      size = (header_size + payload + 7) & ~std::size_t{7};
+      auto pos = head.load(std::memory_order_relaxed);
+      auto offset = pos & (capacity - 1);
+      auto padding = offset + size > capacity ? capacity - offset : 0;
+      if (padding + size > capacity - (pos - tail_cache)) {
+         tail_cache = tail.load(std::memory_order_acquire);
+         if (padding + size > capacity - (pos - tail_cache)) {
+            dropped.fetch_add(1, std::memory_order_relaxed);
+            return nullptr;
+         }
+      }
+      if (padding) {
+         if (padding >= header_size) {
+            Header pad{static_cast<std::uint32_t>(padding), 0, nullptr};
+            std::memcpy(buffer.get() + offset, &pad, sizeof(pad));
+         }
+         head.store(pos + padding, std::memory_order_release);
+         offset = 0;
+      }
+      return buffer.get() + offset;
+   }
+
+   void commit(std::size_t size) {
+      head.store(head.load(std::memory_order_relaxed) + size, std::memory_order_release);
+   }
+
+   // calls `cb(header, payload)` for every committed record
+   template <typename Cb>
+   void drain(Cb &&cb) {
+      auto pos = tail.load(std::memory_order_relaxed);
+      auto end = head.load(std::memory_order_acquire);
+      while (pos != end) {
+         auto offset = pos & (capacity - 1);
+         if (capacity - offset < header_size) {
+            // records are at least a header, the end of the buffer was skipped
+            pos += capacity - offset;
+            continue;
+         }
+         const char *record = buffer.get() + offset;
+         Header header;
+         std::memcpy(&header, record, sizeof(header));
+         if (header.site) {
+            cb(header, record + header_size);
+         }
+         pos += header.size;
+      }
+      tail.store(pos, std::memory_order_release);
+   }
+
+   bool empty() const {
+      return head.load(std::memory_order_acquire) == tail.load(std::memory_order_relaxed);
+   }
+
+   std::atomic<std::size_t> dropped{0};
+   std::atomic<bool> closed{false}; // the thread has exited
+
+private:
+   static std::size_t round_capacity(std::size_t capacity) {
+      std::size_t ret = 4096;
+      while (ret < capacity) {
+         ret *= 2;
+      }
+      return ret;
+   }
+
+   const std::size_t capacity;
+   std::unique_ptr<char[]> buffer;
+   alignas(64) std::atomic<std::size_t> head{0}; // written by the producer
+   std::size_t tail_cache{0};                    // producer's copy of `tail`
+   alignas(64) std::atomic<std::size_t> tail{0}; // written by the consumer
+};
+
+/*
+ * Static descriptor of a deferred call signature.
+ */
+struct DeferredSite {
+   bool newline;
+   std::size_t count;
+   const ArgKind *kinds;
+   const std::uint8_t *sizes;
+   // converts the payload to text and commits it to the stream
+   void (*print)(const char *payload, char sep);
+};
+
+// byte layout of the arguments in the payload
+template <typename T>
+constexpr bool is_deferred_string() {
+   return ArgKind::CString == arg_kind<T>() || ArgKind::String == arg_kind<T>();
+}
+
+template <typename T>
+using deferred_t =
+   std::conditional_t<is_deferred_string<T>(), std::string, std::decay_t<T>>;
+
+inline std::size_t string_size(const char *str) { return str ? std::strlen(str) : 0; }
+inline std::size_t string_size(const std::string &str) { return str.size(); }
+inline const char *string_data(const char *str) { return str ? str : ""; }
+inline const char *string_data(const std::string &str) { return str.data(); }
+
+// strings are stored with u32 length, other values as their bytes
+template <typename T>
+std::size_t deferred_size(const T &value, std::true_type /*string*/) {
+   return sizeof(std::uint32_t) + string_size(value);
+}
+
+template <typename T>
+constexpr std::size_t deferred_size(const T &, std::false_type /*string*/) {
+   return sizeof(std::decay_t<T>);
+}
+
+template <typename T>
+char *deferred_write(char *out, const T &value, std::true_type /*string*/) {
+   auto size = static_cast<std::uint32_t>(string_size(value));
+   std::memcpy(out, &size, sizeof(size));
+   std::memcpy(out + sizeof(size), string_data(value), size);
+   return out + sizeof(size) + size;
+}
+
+template <typename T>
+char *deferred_write(char *out, const T &value, std::false_type /*string*/) {
+   const std::decay_t<T> stored = value; // arrays are stored as pointers
+   std::memcpy(out, &stored, sizeof(stored));
+   return out + sizeof(stored);
+}
+
+template <typename T>
+using is_string_t = std::integral_constant<bool, is_deferred_string<T>()>;
+
+inline const char *deferred_read(const char *in, std::string &str) {
+   std::uint32_t size;
+   std::memcpy(&size, in, sizeof(size));
+   str.assign(in + sizeof(size), size);
+   return in + sizeof(size) + size;
+}
+
+// the same reading a string of a binary log, nullptr when it runs past `end`
+inline const char *deferred_read(const char *in, const char *end, std::string &str) {
+   std::uint32_t size;
+   if (static_cast<std::size_t>(end - in) < sizeof(size)) {
+      return nullptr;
+   }
+   std::memcpy(&size, in, sizeof(size));
+   if (size > static_cast<std::size_t>(end - in) - sizeof(size)) {
+      return nullptr;
+   }
+   return deferred_read(in, str);
+}
+
+template <typename T>
+const char *deferred_read(const char *in, T &value) {
+   std::memcpy(&value, in, sizeof(T));
+   return in + sizeof(T);
+}
+
+template <typename Stream, bool Newline, typename... Ts>
+struct DeferredSiteOf {
+   template <std::size_t... I>
+   static void print(const char *payload, char sep, std::index_sequence<I...>) {
+      (void)payload;
+      std::tuple<deferred_t<Ts>...> values;
+      (void)std::initializer_list<int>{
+         (payload = deferred_read(payload, std::get<I>(values)), 0)...};
+      LineStreamGuard line;
+      PrintBaseT<Stream>::write(line.stream(), sep, std::get<I>(values)...);
+      if (Newline) {
+         line.stream() << '\n';
+      }
+      LineSink<Stream>::commit(line.buffer().data(), line.buffer().size());
+   }
+
+   static void print(const char *payload, char sep) {
+      print(payload, sep, std::index_sequence_for<Ts...>{});
+   }
+
+   static constexpr ArgKind kinds[] = {arg_kind<Ts>()..., ArgKind::None};
+   static constexpr std::uint8_t sizes[] = {
+      static_cast<std::uint8_t>(is_deferred_string<Ts>() ? 0 : sizeof(Ts))..., 0};
+   static const DeferredSite site;
+};
+
+template <typename Stream, bool Newline, typename... Ts>
+constexpr ArgKind DeferredSiteOf<Stream, Newline, Ts...>::kinds[];
+
+template <typename Stream, bool Newline, typename... Ts>
+constexpr std::uint8_t DeferredSiteOf<Stream, Newline, Ts...>::sizes[];
+
+template <typename Stream, bool Newline, typename... Ts>
+const DeferredSite DeferredSiteOf<Stream, Newline, Ts...>::site = {
+   Newline, sizeof...(Ts), kinds, sizes, &DeferredSiteOf::print};
+
+/*
+ * Binary log: a magic line followed by entries starting with a tag byte
+ *  - 'S' site: u32 id, u8 newline, u32 count, count x (u8 kind, u8 size)
+ *  - 'R' record: u32 site id, char separator, u32 size, payload
+ *  - 'D' dropped records: u64 count
+ * Numbers are in the byte order of the machine which wrote the log.
+ */
+constexpr const char *deferred_magic = "tiny_test deferred log 1\n";
+
+/*
+ * Owner of the rings of all threads and the background thread converting them.
+ */
+class DeferredLogger {
+public:
+   static DeferredLogger &instance() {
+      static DeferredLogger logger;
+      return logger;
+   }
+
+   // logger which has been started, nullptr otherwise
+   static DeferredLogger *started() { return started_logger().load(); }
+
+   static std::size_t &ring_size() {
+      static std::size_t size = 1 << 20;
+      return size;
+   }
+
+   DeferredRing &thread_ring() {
+      static thread_local DeferredRing *ring = nullptr;
+      if (DdsUnlikely(!ring)) {
+         ring = add_ring();
+      }
+      return *ring;
+   }
+
+   void flush() {
+      std::lock_guard<std::mutex> lock{drain_mtx};
+      drain();
+   }
+
+   // write records to `out` (nullptr - convert them to text again)
+   void set_binary(std::ostream *out) {
+      std::lock_guard<std::mutex> lock{drain_mtx};
+      drain();
+      if (out && out != binary) {
+         auto size = std::strlen(deferred_magic);
+         out->write(deferred_magic, static_cast<std::streamsize>(size));
+      }
+      binary = out;
+      site_ids.clear();
+   }
+
+   ~DeferredLogger() {
+      {
+         std::lock_guard<std::mutex> lock{mtx};
+         done = true;
+      }
+      cv.notify_all();
+      thread.join();
+      flush();
+      started_logger().store(nullptr);
+   }
+
+private:
+   struct ThreadOwner {
+      std::shared_ptr<DeferredRing> ring;
+      ~ThreadOwner() { ring->closed.store(true); }
+   };
+
+   DeferredLogger() {
+      thread = std::thread{[this] { run(); }};
+      started_logger().store(this);
+   }
+
+   static std::atomic<DeferredLogger *> &started_logger() {
+      static std::atomic<DeferredLogger *> logger{nullptr};
+      return logger;
+   }
+
+   DeferredRing *add_ring() {
+      static thread_local ThreadOwner owner;
+      owner.ring = std::make_shared<DeferredRing>(ring_size());
+      std::lock_guard<std::mutex> lock{mtx};
+      rings.push_back(owner.ring);
+      return owner.ring.get();
+   }
+
+   void run() {
+      std::unique_lock<std::mutex> lock{mtx};
+      while (!cv.wait_for(lock, std::chrono::milliseconds{10}, [this] { return done; })) {
+         lock.unlock();
+         flush();
+         lock.lock();
+      }
+   }
+
+   // called under `drain_mtx`
+   void drain() {
+      std::vector<std::shared_ptr<DeferredRing>> current;
+      {
+         std::lock_guard<std::mutex> lock{mtx};
+         current = rings;
+      }
+      for (auto &ring : current) {
+         bool closed = ring->closed.load();
+         ring->drain([this](const DeferredRing::Header &header, const char *payload) {
+            if (binary) {
+               write_record(header, payload);
+            } else {
+               header.site->print(payload, header.sep);
+            }
+         });
+         report_dropped(ring->dropped.exchange(0));
+         if (closed) {
+            std::lock_guard<std::mutex> lock{mtx};
+            rings.erase(std::remove(rings.begin(), rings.end(), ring), rings.end());
+         }
+      }
+      if (binary) {
+         binary->flush();
+      }
+   }
+
+   void report_dropped(std::size_t count) {
+      if (!count) {
+         return;
+      }
+      if (binary) {
+         binary->put('D');
+         put(static_cast<std::uint64_t>(count));
+      } else {
+         println("[deferred log]", count, "lines dropped, ring buffer was full");
+      }
+   }
+
+   template <typename T>
+   void put(const T &value) {
+      binary->write(reinterpret_cast<const char *>(&value), sizeof(value));
+   }
+
+   void write_record(const DeferredRing::Header &header, const char *payload) {
+      auto found = std::find(site_ids.begin(), site_ids.end(), header.site);
+      auto id = static_cast<std::uint32_t>(found - site_ids.begin());
+      auto &site = *header.site;
+      if (found == site_ids.end()) {
+         site_ids.push_back(header.site);
+         binary->put('S');
+         put(id);
+         put(static_cast<std::uint8_t>(site.newline));
+         put(static_cast<std::uint32_t>(site.count));
+         for (std::size_t i = 0; i < site.count; ++i) {
+            put(static_cast<std::uint8_t>(site.kinds[i]));
+            put(site.sizes[i]);
+         }
+      }
+      auto size = static_cast<std::uint32_t>(header.size - DeferredRing::header_size);
+      binary->put('R');
+      put(id);
+      binary->put(header.sep);
+      put(size);
+      binary->write(payload, size);
+   }
+
+   std::mutex mtx; // guards `rings` and `done`
+   std::condition_variable cv;
+   bool done{};
+   std::vector<std::shared_ptr<DeferredRing>> rings;
+
+   std::mutex drain_mtx; // one drain at a time
+   std::ostream *binary{};
+   std::vector<const DeferredSite *> site_ids; // index is the id in the binary log
+
+   std::thread thread;
+};
+
+template <typename Stream, bool Newline>
+struct DeferredPrinter {
+   constexpr DeferredPrinter(char sep_ = PRINT_SEPARATOR)
+      : sep{sep_} {}
+
+   template <typename... Ts>
+   void operator()(const Ts &... args) const {
+      static_assert(all_supported({arg_kind<Ts>()..., ArgKind::None}),
+                    "deferred print supports arithmetic types, pointers and strings");
+      if (!sizeof...(Ts)) {
+         return; // nothing is printed, like println()
+      }
+      std::size_t payload{};
+      (void)std::initializer_list<int>{
+         (payload += deferred_size(args, is_string_t<Ts>{}), 0)...};
+      auto &ring = DeferredLogger::instance().thread_ring();
+      std::size_t size;
+      char *record = ring.try_reserve(payload, size);
+      if (DdsUnlikely(!record)) {
+         return;
+      }
+      using site_t = DeferredSiteOf<Stream, Newline, std::decay_t<Ts>...>;
+      DeferredRing::Header header{static_cast<std::uint32_t>(size), sep, &site_t::site};
+      std::memcpy(record, &header, sizeof(header));
+      char *out = record + DeferredRing::header_size;
+      (void)std::initializer_list<int>{
+         (out = deferred_write(out, args, is_string_t<Ts>{}), 0)...};
+      (void)out;
+      ring.commit(size);
+   }
+
+   char sep = PRINT_SEPARATOR;
+
+private:
+   static constexpr bool all_supported(std::initializer_list<ArgKind> kinds) {
+      for (auto kind : kinds) {
+         if (ArgKind::Stream == kind) {
+            return false;
+         }
+      }
+      return true;
+   }
+};
+
+template <typename T>
+T deferred_load(const char *in) {
+   T value;
+   std::memcpy(&value, in, sizeof(T));
+   return value;
+}
+
+/*
+ * Whether `size` of a value of a site of the binary log is one decode_value reads.
+ */
+inline bool decode_size_valid(ArgKind kind, std::size_t size) {
+   switch (kind) {
+   case ArgKind::Bool:
+      return sizeof(bool) == size;
+   case ArgKind::Char:
+      return size > 0;
+   case ArgKind::Signed:
+   case ArgKind::Unsigned:
+      return 1 == size || 2 == size || 4 == size || 8 == size;
+   case ArgKind::Float:
+      return sizeof(float) == size || sizeof(double) == size ||
+             sizeof(long double) == size;
+   case ArgKind::Pointer:
+      return sizeof(const void *) == size;
+   case ArgKind::CString:
+   case ArgKind::String:
+      return 0 == size;
+   default:
+      return false;
+   }
+}
+
+/*
+ * Text of one value of the binary log, the same as println prints.
+ */
+inline void decode_value(std::ostream &out,
+                         ArgKind kind,
+                         std::size_t size,
+                         const char *in) {
+   switch (kind) {
+   case ArgKind::Bool:
+      out << deferred_load<bool>(in);
+      break;
+   case ArgKind::Char:
+      out << *in;
+      break;
+   case ArgKind::Signed:
+      switch (size) {
+      case 1: put(out, deferred_load<std::int8_t>(in)); break;
+      case 2: put(out, deferred_load<std::int16_t>(in)); break;
+      case 4: put(out, deferred_load<std::int32_t>(in)); break;
+      default: put(out, deferred_load<std::int64_t>(in)); break;
+      }
+      break;
+   case ArgKind::Unsigned:
+      switch (size) {
+      case 1: put(out, deferred_load<std::uint8_t>(in)); break;
+      case 2: put(out, deferred_load<std::uint16_t>(in)); break;
+      case 4: put(out, deferred_load<std::uint32_t>(in)); break;
+      default: put(out, deferred_load<std::uint64_t>(in)); break;
+      }
+      break;
+   case ArgKind::Float:
+      switch (size) {
+      case sizeof(float): put(out, deferred_load<float>(in)); break;
+      case sizeof(double): put(out, deferred_load<double>(in)); break;
+      default: out << deferred_load<long double>(in); break;
+      }
+      break;
+   case ArgKind::Pointer:
+      out << deferred_load<const void *>(in);
+      break;
+   default:
+      break;
+   }
+}
+
+} // namespace print_detail
+
+template <typename Stream>
+using DeferredPrintBaseT = print_detail::DeferredPrinter<Stream, false>;
+template <typename Stream>
+using DeferredPrintBaseLnT = print_detail::DeferredPrinter<Stream, true>;
+
+using DeferredPrintT = DeferredPrintBaseT<OstreamGetter>;
+using DeferredPrintLnT = DeferredPrintBaseLnT<OstreamGetter>;
+
+constexpr DeferredPrintT deferred_print{};
+constexpr DeferredPrintLnT deferred_println{};
+
+/*
+ * Converts everything logged so far. Nothing is done if deferred print wasn't used.
+ */
+inline void deferred_log_flush() {
+   if (auto *logger = print_detail::DeferredLogger::started()) {
+      logger->flush();
+   }
+}
+
+/*
+ * Write records to `out` as a binary log from now on (nullptr - convert them to text).
+ */
+inline void deferred_log_binary(std::ostream *out) {
+   print_detail::DeferredLogger::instance().set_binary(out);
+}
+
+/*
+ * Converts a binary log written with deferred_log_binary to text. Returns false if it
+ * is not a binary log, it is truncated or a record doesn't match its site.
+ */
+inline bool deferred_log_decode(std::istream &in, std::ostream &out) {
+   using print_detail::ArgKind;
+   struct site_t {
+      bool newline;
+      std::vector<std::pair<ArgKind, std::uint8_t>> args;
+   };
+   auto magic_size = std::strlen(print_detail::deferred_magic);
+   std::string magic(magic_size, '\0');
+   if (!in.read(&magic[0], static_cast<std::streamsize>(magic_size)) ||
+       magic != print_detail::deferred_magic) {
+      return false;
+   }
+   auto get = [&in](auto &value) {
+      return static_cast<bool>(in.read(reinterpret_cast<char *>(&value), sizeof(value)));
+   };
+   std::vector<site_t> sites;
+   std::string payload;
+   for (int tag = in.get(); tag != std::char_traits<char>::eof(); tag = in.get()) {
+      std::uint32_t id{}, count{}, size{};
+      std::uint8_t newline{}, kind{}, arg_size{};
+      std::uint64_t dropped{};
+      char sep{};
+      switch (tag) {
+      case 'S':
+         if (!get(id) || !get(newline) || !get(count) || id != sites.size()) {
+            return false;
+         }
+         sites.push_back({0 != newline, {}});
+         for (std::uint32_t i = 0; i < count; ++i) {
+            if (!get(kind) || !get(arg_size) ||
+                !print_detail::decode_size_valid(static_cast<ArgKind>(kind), arg_size)) {
+               return false;
+            }
+            sites.back().args.emplace_back(static_cast<ArgKind>(kind), arg_size);
+         }
+         break;
+      case 'R': {
+         if (!get(id) || !in.get(sep) || !get(size) || id >= sites.size()) {
+            return false;
+         }
+         payload.resize(size);
+         if (size && !in.read(&payload[0], size)) {
+            return false;
+         }
+         // every value is bounded by the payload, a corrupted record isn't read past it
+         const char *it = payload.data();
+         const char *end = it + payload.size();
+         bool first = true;
+         for (auto &arg : sites[id].args) {
+            if (!first) {
+               out << sep;
+            }
+            first = false;
+            if (ArgKind::CString == arg.first || ArgKind::String == arg.first) {
+               std::string str;
+               it = print_detail::deferred_read(it, end, str);
+               if (!it) {
+                  return false;
+               }
+               out << str;
+            } else {
+               if (arg.second > static_cast<std::size_t>(end - it)) {
+                  return false;
+               }
+               print_detail::decode_value(out, arg.first, arg.second, it);
+               it += arg.second;
+            }
+         }
+         if (sites[id].newline) {
+            out << '\n';
+         }
+         break;
+      }
+      case 'D':
+         if (!get(dropped)) {
+            return false;
+         }
+         out << "[deferred log] " << dropped << " lines dropped, ring buffer was full\n";
+         break;
+      default:
+         return false;
+      }
+   }
+   return true;
+}
@@ -0,0 +1,243 @@
+#pragma once
+
+#include <test_framework/log_sink.h>
+
+#include <cstddef>
+#include <cstdlib>
+#include <memory>
+#include <string>
+
+/*
+ * Sinks writing to files, only the --log-sink option needs them.
+ */
+#if defined(__unix__) || defined(__APPLE__)
+#define DDS_FILE_LOG_SINK 1
+#else
+#define DDS_FILE_LOG_SINK 0
+#endif
+
+#if DDS_FILE_LOG_SINK
+
+#include <algorithm>
+#include <cerrno>
+#include <cstring>
+#include <mutex>
+#include <vector>
+
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <unistd.h>
+
+/*
+ * Buffered writes to a file descriptor.
+ */
+class FdLogSink : public LogSink {
+public:
+   explicit FdLogSink(int fd_, bool own_ = false)
+      : fd{fd_}
+      , own{own_} {
+      buffer.reserve(buffer_size);
+   }
+
+   ~FdLogSink() override { close(); }
+
+   void write(const char *data, std::size_t size) override {
+      std::lock_guard<std::mutex> lock{mtx};
+      if (fd < 0) {
+         return;
+      }
+      if (buffer.size() + size > buffer_size) {
+         flush_buffer();
+      }
+      if (size >= buffer_size) {
+         write_all(data, size);
+      } else {
+         buffer.insert(buffer.end(), data, data + size);
+      }
+   }
+
+   void flush() override {
+      std::lock_guard<std::mutex> lock{mtx};
+      flush_buffer();
+   }
+
+   void close() override {
+      std::lock_guard<std::mutex> lock{mtx};
+      flush_buffer();
+      if (own && fd >= 0) {
+         ::close(fd);
+      }
+      fd = -1;
+   }
+
+private:
+   static constexpr std::size_t buffer_size = 64 << 10;
+
+   void flush_buffer() {
+      write_all(buffer.data(), buffer.size());
+      buffer.clear();
+   }
+
+   void write_all(const char *data, std::size_t size) {
+      while (size && fd >= 0) {
+         auto written = ::write(fd, data, size);
+         if (written < 0) {
+            if (EINTR == errno) {
+               continue;
+            }
+            return;
+         }
+         data += written;
+         size -= static_cast<std::size_t>(written);
+      }
+   }
+
+   int fd;
+   bool own;
+   std::vector<char> buffer;
+   std::mutex mtx;
+};
+
+/*
+ * Append-only memory-mapped file. Only the window at the end of the file is mapped,
+ * when it is full the file is extended by the next window, so the written part is never
+ * remapped. Windows are prefaulted where supported. The file is truncated to the
+ * written size on `close`, so a crashed run leaves zeros after the last line.
+ */
+class MmapLogSink : public LogSink {
+public:
+   MmapLogSink() = default;
+   MmapLogSink(const MmapLogSink &) = delete;
+   MmapLogSink &operator=(const MmapLogSink &) = delete;
+
+   ~MmapLogSink() override { close(); }
+
+   bool open(const std::string &path) {
+      std::lock_guard<std::mutex> lock{mtx};
+      fd = ::open(path.c_str(), O_RDWR | O_CREAT | O_TRUNC | O_CLOEXEC, 0644);
+      return fd >= 0 && next_window();
+   }
+
+   void write(const char *data, std::size_t size) override {
+      std::lock_guard<std::mutex> lock{mtx};
+      while (size && window) {
+         auto count = std::min(size, window_size - window_used);
+         std::memcpy(window + window_used, data, count);
+         window_used += count;
+         data += count;
+         size -= count;
+         if (window_used == window_size && !next_window()) {
+            return;
+         }
+      }
+   }
+
+   void close() override {
+      std::lock_guard<std::mutex> lock{mtx};
+      auto written = size_locked();
+      unmap();
+      if (fd >= 0) {
+         (void)::ftruncate(fd, static_cast<off_t>(written));
+         ::close(fd);
+         fd = -1;
+      }
+   }
+
+   std::size_t size() const {
+      std::lock_guard<std::mutex> lock{mtx};
+      return size_locked();
+   }
+
+private:
+   static constexpr std::size_t min_window = 1 << 20;
+   static constexpr std::size_t max_window = 64 << 20;
+
+   std::size_t size_locked() const { return window_offset + window_used; }
+
+   bool next_window() {
+      window_offset += window_used;
+      unmap();
+      window_size = std::min(std::max(window_size * 2, std::size_t{min_window}),
+                             std::size_t{max_window});
+      if (::ftruncate(fd, static_cast<off_t>(window_offset + window_size))) {
+         return false;
+      }
+      int flags = MAP_SHARED;
+#ifdef MAP_POPULATE
+      flags |= MAP_POPULATE;
+#endif
+      auto *ptr = ::mmap(nullptr,
+                         window_size,
+                         PROT_READ | PROT_WRITE,
+                         flags,
+                         fd,
+                         static_cast<off_t>(window_offset));
+      if (MAP_FAILED == ptr) {
+         return false;
+      }
+      window = static_cast<char *>(ptr);
+      return true;
+   }
+
+   void unmap() {
+      if (window) {
+         ::munmap(window, window_size);
+         window = nullptr;
+         window_used = 0;
+      }
+   }
+
+   int fd{-1};
+   char *window{};
+   std::size_t window_offset{}; // offset of the window in the file
+   std::size_t window_size{};
+   std::size_t window_used{};
+   mutable std::mutex mtx;
+};
+
+#endif // DDS_FILE_LOG_SINK
+
+namespace print_detail {
+
+inline bool parse_size(const std::string &value, std::size_t &size) {
+   char *end{};
+   size = static_cast<std::size_t>(std::strtoull(value.c_str(), &end, 10));
+   return !value.empty() && !*end;
+}
+
+} // namespace print_detail
+
+/*
+ * Creates a sink from `spec`:
+ *    fd:N      - file descriptor N
+ *    mmap:path - memory-mapped file, it is overwritten
+ *    ring:MB   - last MB megabytes of the log, printed when the sink is closed
+ * fd and mmap need POSIX, elsewhere they are invalid. Returns nullptr for an invalid
+ * spec or a file which can't be created.
+ */
+inline std::unique_ptr<LogSink> make_log_sink(const std::string &spec) {
+   auto colon = spec.find(':');
+   if (colon == std::string::npos) {
+      return nullptr;
+   }
+   auto kind = spec.substr(0, colon);
+   auto value = spec.substr(colon + 1);
+   std::size_t number{};
+#if DDS_FILE_LOG_SINK
+   if ("fd" == kind && print_detail::parse_size(value, number)) {
+      return std::unique_ptr<LogSink>{new FdLogSink{static_cast<int>(number)}};
+   }
+#endif
+   if ("ring" == kind && print_detail::parse_size(value, number) && number) {
+      return std::unique_ptr<LogSink>{new RingLogSink{number << 20}};
+   }
+#if DDS_FILE_LOG_SINK
+   if ("mmap" == kind && !value.empty()) {
+      std::unique_ptr<MmapLogSink> sink{new MmapLogSink};
+      if (sink->open(value)) {
+         return sink;
+      }
+   }
+#endif
+   return nullptr;
+}
@@ -0,0 +1,634 @@
+#pragma once
+
+/*
+ * Formatted output with format strings checked at compile time:
+ *
+ *    println_fmt(PRINT_FMT("{} items, mask {:08x}"), count, mask);
+ *
+ * Placeholder is `{}` or `{:spec}`, where spec is [0][width][.precision][type]:
+ *  - `d` `x` `X` `o` `b` - integer (or char) in the given base
+ *  - `c` - character (char or integer code)
+ *  - `f` `e` `g` - floating point, `precision` digits
+ *    (`{}` of float and double prints the shortest digits which read back exactly)
+ *  - `s` - string, bool or any streamable value
+ *  - `p` - pointer
+ * Width right-aligns the value, padded with spaces or with zeros when it starts with `0`.
+ * `{{` and `}}` print the braces.
+ *
+ * PRINT_FMT gives every format string its own type, so it is parsed and checked against
+ * the argument types at compile time and every call site gets its own formatter. The
+ * line is formatted into a stack buffer; when every argument has a bounded length, the
+ * buffer has exactly the maximum length of the line, otherwise it falls back to the heap
+ * for long lines.
+ */
+
+#include <test_framework/number_format.h>
+#include <test_framework/tools.h>
+
+#include <cstddef>
+#include <cstdint>
+#include <cstdio>
+#include <cstring>
+#include <initializer_list>
+#include <memory>
+#include <sstream>
+#include <string>
+#include <type_traits>
+#include <utility>
+
+#define PRINT_FMT(str)                                                                  \
+   [] {                                                                                 \
+      struct __print_fmt_t {                                                            \
+         static constexpr const char *value() { return str; }                          \
+      };                                                                                \
+      return __print_fmt_t{};                                                           \
+   }()
+
+namespace print_detail {
+
+// how an argument is formatted
+enum class ArgKind {
+   None,
+   Bool,
+   Char,
+   Signed,
+   Unsigned,
+   Float,
+   CString,
+   String,
+   Pointer,
+   Stream, // anything else, formatted with operator<<
+};
+
+template <typename T>
+constexpr ArgKind arg_kind() {
+   using type = std::decay_t<T>;
+   if (std::is_same<type, bool>::value) {
+      return ArgKind::Bool;
+   }
+   if (std::is_same<type, char>::value || std::is_same<type, signed char>::value ||
+       std::is_same<type, unsigned char>::value) {
+      return ArgKind::Char;
+   }
+   if (std::is_integral<type>::value) {
+      return std::is_signed<type>::value ? ArgKind::Signed : ArgKind::Unsigned;
+   }
+   if (std::is_floating_point<type>::value) {
+      return ArgKind::Float;
+   }
+   if (std::is_same<type, const char *>::value || std::is_same<type, char *>::value) {
+      return ArgKind::CString;
+   }
+   if (std::is_same<type, std::string>::value) {
+      return ArgKind::String;
+   }
+   if ((std::is_pointer<type>::value &&
+        !std::is_function<std::remove_pointer_t<type>>::value) ||
+       std::is_null_pointer<type>::value) {
+      return ArgKind::Pointer;
+   }
+   return ArgKind::Stream;
+}
+
+enum class FmtError {
+   Ok,
+   TooFewArgs,    // more placeholders than arguments
+   TooManyArgs,   // more arguments than placeholders
+   BadSpec,       // unknown format spec
+   TypeMismatch,  // format spec can't be used for the argument type
+   UnmatchedBrace // single `{` or `}`
+};
+
+struct Spec {
+   char type;      // 0 - default
+   bool zero;      // pad with zeros
+   std::size_t width;
+   int precision;  // -1 - default
+};
+
+template <ArgKind K>
+using kind_t = std::integral_constant<ArgKind, K>;
+
+constexpr bool is_integer(ArgKind kind) {
+   return ArgKind::Char == kind || ArgKind::Signed == kind || ArgKind::Unsigned == kind;
+}
+
+constexpr bool known_type(char type) {
+   for (char known : {'d', 'x', 'X', 'o', 'b', 'c', 'f', 'e', 'g', 's', 'p'}) {
+      if (known == type) {
+         return true;
+      }
+   }
+   return false;
+}
+
+constexpr bool valid_spec(ArgKind kind, const Spec &spec) {
+   if (spec.precision >= 0 && ArgKind::Float != kind) {
+      return false;
+   }
+   switch (spec.type) {
+   case 0:
+      return true;
+   case 'd':
+   case 'x':
+   case 'X':
+   case 'o':
+   case 'b':
+   case 'c':
+      return is_integer(kind);
+   case 'f':
+   case 'e':
+   case 'g':
+      return ArgKind::Float == kind;
+   case 's':
+      return ArgKind::Bool == kind || ArgKind::CString == kind ||
+             ArgKind::String == kind || ArgKind::Stream == kind;
+   case 'p':
+      return ArgKind::Pointer == kind;
+   default:
+      return false;
+   }
+}
+
+/*
+ * Format string split to the literal text (with resolved `{{` and `}}`) and N
+ * placeholders. Literal text before the placeholder `i` is text[begin[i], end[i]).
+ */
+template <std::size_t L, std::size_t N>
+struct Parsed {
+   char text[L];
+   std::size_t begin[N + 1];
+   std::size_t end[N + 1];
+   Spec spec[N + 1];
+   FmtError error;
+};
+
+constexpr std::size_t cstrlen(const char *str) {
+   std::size_t n{};
+   while (str[n]) {
+      ++n;
+   }
+   return n;
+}
+
+constexpr bool is_digit(char ch) { return ch >= '0' && ch <= '9'; }
+
+template <std::size_t L, std::size_t N>
+constexpr Parsed<L, N> parse(const char *str, const ArgKind *kinds) {
+   Parsed<L, N> ret{};
+   std::size_t pos{}, out{}, arg{};
+   while (str[pos]) {
+      char ch = str[pos];
+      if ('{' == ch && '{' != str[pos + 1]) {
+         if (arg == N) {
+            ret.error = FmtError::TooFewArgs;
+            return ret;
+         }
+         Spec spec{0, false, 0, -1};
+         if (':' == str[++pos]) {
+            if ('0' == str[++pos]) {
+               spec.zero = true;
+               ++pos;
+            }
+            for (; is_digit(str[pos]); ++pos) {
+               spec.width = spec.width * 10 + static_cast<std::size_t>(str[pos] - '0');
+            }
+            if ('.' == str[pos]) {
+               spec.precision = 0;
+               for (++pos; is_digit(str[pos]); ++pos) {
+                  spec.precision = spec.precision * 10 + (str[pos] - '0');
+               }
+            }
+            if (known_type(str[pos])) {
+               spec.type = str[pos++];
+            }
+         }
+         if ('}' != str[pos]) {
+            ret.error = str[pos] ? FmtError::BadSpec : FmtError::UnmatchedBrace;
+            return ret;
+         }
+         if (!valid_spec(kinds[arg], spec)) {
+            ret.error = FmtError::TypeMismatch;
+            return ret;
+         }
+         ret.end[arg] = out;
+         ret.spec[arg] = spec;
+         ret.begin[++arg] = out;
+         ++pos;
+         continue;
+      }
+      if ('}' == ch && '}' != str[pos + 1]) {
+         ret.error = FmtError::UnmatchedBrace;
+         return ret;
+      }
+      ret.text[out++] = ch;
+      pos += ('{' == ch || '}' == ch) ? 2 : 1;
+   }
+   ret.end[arg] = out;
+   ret.error = arg < N ? FmtError::TooManyArgs : FmtError::Ok;
+   return ret;
+}
+
+constexpr std::size_t unbounded = static_cast<std::size_t>(-1);
+
+// maximum number of digits of an integer of `bits` in the given base
+constexpr std::size_t max_digits(std::size_t bits, char type) {
+   switch (type) {
+   case 'x':
+   case 'X':
+      return (bits + 3) / 4;
+   case 'o':
+      return (bits + 2) / 3;
+   case 'b':
+      return bits;
+   default:
+      return (bits * 30103 + 99999) / 100000; // log10(2) rounded up
+   }
+}
+
+constexpr std::size_t max_length(ArgKind kind, std::size_t size, const Spec &spec) {
+   std::size_t len = unbounded;
+   switch (kind) {
+   case ArgKind::Bool:
+      len = 5;
+      break;
+   case ArgKind::Char:
+   case ArgKind::Signed:
+   case ArgKind::Unsigned:
+      len = (0 == spec.type && ArgKind::Char == kind) || 'c' == spec.type
+               ? 1
+               : max_digits(size * 8, spec.type) + (ArgKind::Unsigned != kind);
+      break;
+   case ArgKind::Float:
+      // `f` of the largest double has 309 integer digits, long double is unbounded
+      if (0 == spec.type && spec.precision < 0 && size <= sizeof(double)) {
+         len = 24; // -1.7976931348623157e+308
+      } else if ('f' != spec.type) {
+         len = (spec.precision < 0 ? 6 : static_cast<std::size_t>(spec.precision)) + 16;
+      } else if (size <= sizeof(double)) {
+         len = 311 + static_cast<std::size_t>(spec.precision < 0 ? 6 : spec.precision);
+      }
+      break;
+   case ArgKind::Pointer:
+      len = 2 + max_digits(sizeof(void *) * 8, 'x');
+      break;
+   default:
+      break;
+   }
+   return unbounded == len || len > spec.width ? len : spec.width;
+}
+
+// maximum length of the formatted text or `unbounded`
+template <std::size_t L, std::size_t N>
+constexpr std::size_t max_length(const Parsed<L, N> &parsed,
+                                 const ArgKind *kinds,
+                                 const std::size_t *sizes) {
+   std::size_t len = parsed.end[N] - parsed.begin[N];
+   for (std::size_t i = 0; i < N; ++i) {
+      auto arg = max_length(kinds[i], sizes[i], parsed.spec[i]);
+      if (unbounded == arg) {
+         return unbounded;
+      }
+      len += parsed.end[i] - parsed.begin[i] + arg;
+   }
+   return len;
+}
+
+/*
+ * Output buffer on the stack, which moves to the heap when `N` bytes are not enough.
+ */
+template <std::size_t N>
+class Buffer {
+public:
+   Buffer() = default;
+   Buffer(const Buffer &) = delete;
+   Buffer &operator=(const Buffer &) = delete;
+
+   const char *data() const { return ptr; }
+   std::size_t size() const { return len; }
+
+   // returns space for `n` more bytes, which are committed with `commit`
+   char *reserve(std::size_t n) {
+      if (len + n > capacity) {
+         grow(len + n);
+      }
+      return ptr + len;
+   }
+
+   void commit(std::size_t n) { len += n; }
+
+   void append(const char *str, std::size_t n) {
+      std::memcpy(reserve(n), str, n);
+      len += n;
+   }
+
+   void push_back(char ch) {
+      *reserve(1) = ch;
+      ++len;
+   }
+
+   // right-align text written since `start` to `width` with `fill`
+   void pad(std::size_t start, std::size_t width, char fill) {
+      auto written = len - start;
+      if (written >= width) {
+         return;
+      }
+      auto count = width - written;
+      reserve(count);
+      auto *from = ptr + start;
+      // zeros go after the sign
+      if ('0' == fill && written && ('-' == *from || '+' == *from)) {
+         ++from;
+         --written;
+      }
+      std::memmove(from + count, from, written);
+      std::memset(from, fill, count);
+      len += count;
+   }
+
+private:
+   void grow(std::size_t required) {
+      auto size = capacity * 2 > required ? capacity * 2 : required;
+      std::unique_ptr<char[]> grown{new char[size]};
+      std::memcpy(grown.get(), ptr, len);
+      heap = std::move(grown);
+      ptr = heap.get();
+      capacity = size;
+   }
+
+   char stack[N ? N : 1];
+   std::unique_ptr<char[]> heap;
+   char *ptr = stack;
+   std::size_t capacity = N ? N : 1;
+   std::size_t len{};
+};
+
+template <typename Buf, typename U>
+void write_unsigned(Buf &buf, U value, char type) {
+   static_assert(std::is_unsigned<U>::value, "");
+   char tmp[sizeof(U) * 8];
+   if (0 == type || 'd' == type) {
+      buf.append(tmp, static_cast<std::size_t>(format_decimal(tmp, value) - tmp));
+      return;
+   }
+   if ('x' == type || 'X' == type) {
+      auto *end = format_hex(tmp, value, 'X' == type);
+      buf.append(tmp, static_cast<std::size_t>(end - tmp));
+      return;
+   }
+   const char *digits = 'X' == type ? "0123456789ABCDEF" : "0123456789abcdef";
+   unsigned base = 'o' == type ? 8 : 2;
+   auto *end = tmp + sizeof(tmp);
+   auto *it = end;
+   do {
+      *--it = digits[value % base];
+      value = static_cast<U>(value / base);
+   } while (value);
+   buf.append(it, static_cast<std::size_t>(end - it));
+}
+
+template <typename Buf, typename T>
+void write_integer(Buf &buf, T value, char type) {
+   using unsigned_t = std::make_unsigned_t<T>;
+   auto magnitude = static_cast<unsigned_t>(value);
+   if (value < T{}) {
+      buf.push_back('-');
+      magnitude = static_cast<unsigned_t>(unsigned_t{} - magnitude);
+   }
+   write_unsigned(buf, magnitude, type);
+}
+
+template <typename Buf, typename T>
+void write_arg(Buf &buf, const Spec &, T value, kind_t<ArgKind::Bool>) {
+   if (value) {
+      buf.append("true", 4);
+   } else {
+      buf.append("false", 5);
+   }
+}
+
+template <typename Buf, typename T>
+void write_arg(Buf &buf, const Spec &spec, T value, kind_t<ArgKind::Char>) {
+   if (0 == spec.type || 'c' == spec.type) {
+      buf.push_back(static_cast<char>(value));
+   } else {
+      write_integer(buf, static_cast<int>(value), spec.type);
+   }
+}
+
+template <typename Buf, typename T>
+void write_arg(Buf &buf, const Spec &spec, T value, kind_t<ArgKind::Signed>) {
+   if ('c' == spec.type) {
+      buf.push_back(static_cast<char>(value));
+   } else {
+      write_integer(buf, value, spec.type);
+   }
+}
+
+template <typename Buf, typename T>
+void write_arg(Buf &buf, const Spec &spec, T value, kind_t<ArgKind::Unsigned>) {
+   if ('c' == spec.type) {
+      buf.push_back(static_cast<char>(value));
+   } else {
+      write_unsigned(buf, value, spec.type);
+   }
+}
+
+// `{}` of float and double is the shortest representation which reads back exactly
+template <typename Buf>
+bool write_shortest(Buf &buf, float value) {
+   char tmp[max_number_chars];
+   buf.append(tmp, static_cast<std::size_t>(format_shortest(tmp, value) - tmp));
+   return true;
+}
+
+template <typename Buf>
+bool write_shortest(Buf &buf, double value) {
+   char tmp[max_number_chars];
+   buf.append(tmp, static_cast<std::size_t>(format_shortest(tmp, value) - tmp));
+   return true;
+}
+
+template <typename Buf>
+bool write_shortest(Buf &, long double) {
+   return false;
+}
+
+template <typename Buf, typename T>
+void write_arg(Buf &buf, const Spec &spec, T value, kind_t<ArgKind::Float>) {
+   if (0 == spec.type && spec.precision < 0 && write_shortest(buf, value)) {
+      return;
+   }
+   char format[8]{'%', '.', '*'};
+   std::size_t n = 3;
+   if (std::is_same<T, long double>::value) {
+      format[n++] = 'L';
+   }
+   format[n] = spec.type ? spec.type : 'g';
+   int precision = spec.precision < 0 ? 6 : spec.precision;
+   using float_t =
+      std::conditional_t<std::is_same<T, long double>::value, long double, double>;
+   // a short temporary buffer fits any value but huge ones with `f`
+   char tmp[64];
+   auto len =
+      std::snprintf(tmp, sizeof(tmp), format, precision, static_cast<float_t>(value));
+   if (len < 0) {
+      return;
+   }
+   if (static_cast<std::size_t>(len) < sizeof(tmp)) {
+      buf.append(tmp, static_cast<std::size_t>(len));
+      return;
+   }
+   std::unique_ptr<char[]> large{new char[static_cast<std::size_t>(len) + 1]};
+   std::snprintf(large.get(), static_cast<std::size_t>(len) + 1, format, precision,
+                 static_cast<float_t>(value));
+   buf.append(large.get(), static_cast<std::size_t>(len));
+}
+
+template <typename Buf>
+void write_arg(Buf &buf, const Spec &, const char *value, kind_t<ArgKind::CString>) {
+   if (value) {
+      buf.append(value, std::strlen(value));
+   } else {
+      buf.append("(null)", 6);
+   }
+}
+
+template <typename Buf>
+void write_arg(Buf &buf,
+               const Spec &,
+               const std::string &value,
+               kind_t<ArgKind::String>) {
+   buf.append(value.data(), value.size());
+}
+
+template <typename Buf, typename T>
+void write_arg(Buf &buf, const Spec &, T value, kind_t<ArgKind::Pointer>) {
+   buf.append("0x", 2);
+   auto *address = static_cast<const volatile void *>(value);
+   write_unsigned(buf, reinterpret_cast<std::uintptr_t>(address), 'x');
+}
+
+template <typename Buf, typename T>
+void write_arg(Buf &buf, const Spec &, const T &value, kind_t<ArgKind::Stream>) {
+   std::ostringstream out;
+   put(out, value);
+   auto str = out.str();
+   buf.append(str.data(), str.size());
+}
+
+template <typename Buf, typename T>
+void write_field(Buf &buf, const Spec &spec, const T &value) {
+   auto start = buf.size();
+   write_arg(buf, spec, value, kind_t<arg_kind<T>()>{});
+   if (spec.width) {
+      bool numeric = is_integer(arg_kind<T>()) || ArgKind::Float == arg_kind<T>();
+      buf.pad(start, spec.width, spec.zero && numeric ? '0' : ' ');
+   }
+}
+
+/*
+ * Error in the format string of `Fmt` for arguments `Ts`, FmtError::Ok if it's valid.
+ */
+template <typename Fmt, typename... Ts>
+constexpr FmtError format_error() {
+   constexpr ArgKind kinds[] = {arg_kind<Ts>()..., ArgKind::None};
+   return parse<cstrlen(Fmt::value()) + 1, sizeof...(Ts)>(Fmt::value(), kinds).error;
+}
+
+/*
+ * Formatter of a call site: formats `args` with the format string of `Fmt` followed by
+ * `suffix` and passes the result to `out`.
+ */
+template <typename Fmt, typename... Ts>
+struct Formatter {
+   static constexpr std::size_t count = sizeof...(Ts);
+   static constexpr std::size_t length = cstrlen(Fmt::value()) + 1;
+   using parsed_t = Parsed<length, count>;
+
+   // called with the parsed format string, so a wrong one fails to compile here
+   template <typename Out>
+   static void format(Out &&out,
+                      const char *suffix,
+                      std::size_t suffix_len,
+                      const Ts &... args) {
+      static constexpr ArgKind kinds[] = {arg_kind<Ts>()..., ArgKind::None};
+      static constexpr std::size_t sizes[] = {sizeof(Ts)..., 0};
+      static constexpr parsed_t parsed = parse<length, count>(Fmt::value(), kinds);
+      static_assert(FmtError::TooFewArgs != parsed.error,
+                    "format string has more placeholders than arguments");
+      static_assert(FmtError::TooManyArgs != parsed.error,
+                    "format string has less placeholders than arguments");
+      static_assert(FmtError::BadSpec != parsed.error, "invalid format spec");
+      static_assert(FmtError::TypeMismatch != parsed.error,
+                    "format spec doesn't match the argument type");
+      static_assert(FmtError::UnmatchedBrace != parsed.error,
+                    "unmatched brace in format string, use {{ or }} to print it");
+      static constexpr std::size_t max_len = max_length(parsed, kinds, sizes);
+      // 256 bytes is a line of a usual length, longer lines move to the heap
+      Buffer<unbounded == max_len ? 256 : max_len + 1> buf;
+      write(buf, parsed, args..., std::index_sequence_for<Ts...>{});
+      buf.append(suffix, suffix_len);
+      out(buf.data(), buf.size());
+   }
+
+private:
+   template <typename Buf, std::size_t... I>
+   static void write(Buf &buf,
+                     const parsed_t &parsed,
+                     const Ts &... args,
+                     std::index_sequence<I...>) {
+      (void)std::initializer_list<int>{
+         (buf.append(parsed.text + parsed.begin[I], parsed.end[I] - parsed.begin[I]),
+          write_field(buf, parsed.spec[I], args),
+          0)...};
+      auto tail = parsed.end[count] - parsed.begin[count];
+      buf.append(parsed.text + parsed.begin[count], tail);
+   }
+};
+
+} // namespace print_detail
+
+template <typename Stream>
+struct PrintFmtBaseT {
+   template <typename Fmt, typename... Ts>
+   void operator()(Fmt, const Ts &... args) const {
+      print_detail::Formatter<Fmt, Ts...>::format(
+         [](const char *data, std::size_t size) { LineSink<Stream>::commit(data, size); },
+         "",
+         0,
+         args...);
+   }
+};
+
+template <typename Stream>
+struct PrintFmtBaseLnT {
+   template <typename Fmt, typename... Ts>
+   void operator()(Fmt, const Ts &... args) const {
+      print_detail::Formatter<Fmt, Ts...>::format(
+         [](const char *data, std::size_t size) { LineSink<Stream>::commit(data, size); },
+         "\n",
+         1,
+         args...);
+   }
+};
+
+using PrintFmtT = PrintFmtBaseT<OstreamGetter>;
+using PrintFmtLnT = PrintFmtBaseLnT<OstreamGetter>;
+
+constexpr PrintFmtT print_fmt{};
+constexpr PrintFmtLnT println_fmt{};
+
+/*
+ * Formats to a string, e.g. format_fmt(PRINT_FMT("{:08x}"), value).
+ */
+template <typename Fmt, typename... Ts>
+std::string format_fmt(Fmt, const Ts &... args) {
+   std::string ret;
+   print_detail::Formatter<Fmt, Ts...>::format(
+      [&ret](const char *data, std::size_t size) { ret.assign(data, size); },
+      "",
+      0,
+      args...);
+   return ret;
+}
@@ -0,0 +1,149 @@
+#pragma once
+
+#include <algorithm>
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <cstdio>
+#include <cstring>
+#include <iostream>
+#include <mutex>
+#include <streambuf>
+#include <string>
+#include <vector>
+
+/*
+ * Runtime destination of print/println output. By default lines go to `stdout`, an
+ * installed sink gets them instead. Implementations are called concurrently and must
+ * keep every `write` in one piece.
+ */
+class LogSink {
+public:
+   virtual ~LogSink() = default;
+
+   virtual void write(const char *data, std::size_t size) = 0;
+   virtual void flush() {}
+   // called once when the sink is no longer used, later writes are dropped
+   virtual void close() {}
+};
+
+/*
+ * Keeps only the last `size` bytes of the log in memory, they are printed to `stdout`
+ * on `close` (not when it is destroyed).
+ */
+class RingLogSink : public LogSink {
+public:
+   explicit RingLogSink(std::size_t size)
+      : ring(size) {}
+
+   void write(const char *data, std::size_t size) override {
+      std::lock_guard<std::mutex> lock{mtx};
+      if (closed) {
+         return;
+      }
+      total += size;
+      if (size > ring.size()) {
+         data += size - ring.size();
+         size = ring.size();
+      }
+      auto pos = static_cast<std::size_t>((total - size) % ring.size());
+      auto first = std::min(size, ring.size() - pos);
+      std::memcpy(&ring[pos], data, first);
+      std::memcpy(ring.data(), data + first, size - first);
+   }
+
+   void close() override {
+      auto kept = contents();
+      std::lock_guard<std::mutex> lock{mtx};
+      if (closed) {
+         return;
+      }
+      closed = true;
+      if (total > kept.size()) {
+         std::fprintf(stdout,
+                      "[log] %llu bytes dropped, the last %llu bytes follow\n",
+                      static_cast<unsigned long long>(total - kept.size()),
+                      static_cast<unsigned long long>(kept.size()));
+      }
+      std::fwrite(kept.data(), 1, kept.size(), stdout);
+      std::fflush(stdout);
+   }
+
+   // kept lines, the first one is skipped when it was overwritten in part
+   std::string contents() const {
+      std::lock_guard<std::mutex> lock{mtx};
+      if (total <= ring.size()) {
+         return {ring.data(), static_cast<std::size_t>(total)};
+      }
+      auto pos = static_cast<std::size_t>(total % ring.size());
+      std::string ret{ring.data() + pos, ring.size() - pos};
+      ret.append(ring.data(), pos);
+      auto line_end = ret.find('\n');
+      return line_end == std::string::npos ? std::string{} : ret.substr(line_end + 1);
+   }
+
+   std::uint64_t written() const {
+      std::lock_guard<std::mutex> lock{mtx};
+      return total;
+   }
+
+private:
+   std::vector<char> ring;
+   std::uint64_t total{};
+   bool closed{};
+   mutable std::mutex mtx;
+};
+
+namespace print_detail {
+
+inline std::atomic<LogSink *> &log_sink() {
+   static std::atomic<LogSink *> sink{};
+   return sink;
+}
+
+/*
+ * Replaces the buffer of std::cout while a sink is installed, so `print` and direct
+ * writes to std::cout go to the sink as well. It is unbuffered to keep the order with
+ * lines of println.
+ */
+class LogSinkBuffer : public std::streambuf {
+protected:
+   int_type overflow(int_type ch) override {
+      if (!traits_type::eq_int_type(ch, traits_type::eof())) {
+         auto c = traits_type::to_char_type(ch);
+         xsputn(&c, 1);
+      }
+      return traits_type::not_eof(ch);
+   }
+
+   std::streamsize xsputn(const char *s, std::streamsize n) override {
+      if (auto *sink = log_sink().load(std::memory_order_acquire)) {
+         sink->write(s, static_cast<std::size_t>(n));
+      } else {
+         std::fwrite(s, 1, static_cast<std::size_t>(n), stdout);
+      }
+      return n;
+   }
+
+   int sync() override {
+      if (auto *sink = log_sink().load(std::memory_order_acquire)) {
+         sink->flush();
+      }
+      return 0;
+   }
+};
+
+} // namespace print_detail
+
+/*
+ * Installs `sink` as the output of print/println and std::cout, nullptr restores
+ * `stdout`. Returns the previous sink, which is not closed.
+ */
+inline LogSink *set_log_sink(LogSink *sink) {
+   static print_detail::LogSinkBuffer buffer;
+   static std::streambuf *original = std::cout.rdbuf();
+   std::cout.flush();
+   auto *prev = print_detail::log_sink().exchange(sink, std::memory_order_acq_rel);
+   std::cout.rdbuf(sink ? &buffer : original);
+   return prev;
+}
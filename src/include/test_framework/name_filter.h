@@ -0,0 +1,185 @@
+#pragma once
+
+#include <common/common.h>
+#include <test_framework/config.h>
+
+#include <cstddef>
+#include <functional>
+#include <map>
+#include <vector>
+
+namespace DDS_ROOT_NAMESPACE {
+namespace DDS_TINYTEST_NAMESPACE {
+
+/*
+ * Selection of test cases by name.
+ *
+ * Patterns are globs over the full test names (`suite/nested/case`), split to segments
+ * on the test separator:
+ *  - `*` matches any characters inside a segment, `?` matches a single character
+ *  - segment `**` matches any number of segments
+ *  - a pattern matching only the leading segments selects whole suite, so `suite/nested`
+ *    selects every test case in it
+ *
+ * All patterns are compiled once into a trie over the segments (patterns with common
+ * prefixes share the nodes), so a name is matched in a single pass over its segments.
+ * Name is selected if it matches any include pattern (or there is none) and it doesn't
+ * match any exclude pattern.
+ */
+class __name_filter_t {
+public:
+   void add(StringView pattern, StringView separator, bool exclude) {
+      if (nodes.empty()) {
+         nodes.emplace_back(); // root, created on demand to not allocate before `main`
+      }
+      std::size_t current{};
+      for_each_segment(pattern, separator, [&](StringView segment) {
+         current = child(current, segment);
+         return true;
+      });
+      if (!current) {
+         return;
+      }
+      (exclude ? nodes[current].exclude : nodes[current].include) = true;
+      has_include = has_include || !exclude;
+      has_exclude = has_exclude || exclude;
+   }
+
+   bool empty() const { return !has_include && !has_exclude; }
+
+   bool match(StringView name, StringView separator) const {
+      if (empty()) {
+         return true;
+      }
+      bool included = !has_include;
+      bool excluded{};
+      std::vector<std::size_t> active;
+      std::vector<std::size_t> next;
+      enter(active, 0);
+      for_each_segment(name, separator, [&](StringView segment) {
+         next.clear();
+         for (auto index : active) {
+            auto &node = nodes[index];
+            if (node.any_depth) {
+               enter(next, index);
+            }
+            auto found = node.literal.find(segment);
+            if (found != node.literal.end()) {
+               enter(next, found->second);
+            }
+            for (auto &wildcard : node.wildcard) {
+               if (glob(wildcard.first, segment)) {
+                  enter(next, wildcard.second);
+               }
+            }
+         }
+         active.swap(next);
+         for (auto index : active) {
+            included = included || nodes[index].include;
+            excluded = excluded || nodes[index].exclude;
+         }
+         return !active.empty() && !excluded;
+      });
+      return included && !excluded;
+   }
+
+private:
+   struct node_t {
+      std::map<String, std::size_t, std::less<>> literal;    // plain segment children
+      std::vector<std::pair<String, std::size_t>> wildcard; // `*` and `?` children
+      std::size_t any_child{};                               // `**` child (0 - none)
+      bool any_depth{};                                      // this node is `**`
+      bool include{};
+      bool exclude{};
+   };
+
+   template <typename Cb>
+   static void for_each_segment(StringView str, StringView separator, Cb &&cb) {
+      if (separator.empty()) {
+         cb(str);
+         return;
+      }
+      std::size_t begin{};
+      while (begin <= str.size()) {
+         auto end = str.find(separator, begin);
+         if (end == StringView::npos) {
+            end = str.size();
+         }
+         if (end > begin && !cb(str.substr(begin, end - begin))) {
+            return;
+         }
+         begin = end + separator.size();
+      }
+   }
+
+   std::size_t child(std::size_t parent, StringView segment) {
+      auto add_node = [this] {
+         nodes.emplace_back();
+         return nodes.size() - 1;
+      };
+      if ("**" == segment) {
+         if (!nodes[parent].any_child) {
+            auto index = add_node();
+            nodes[index].any_depth = true;
+            nodes[parent].any_child = index;
+         }
+         return nodes[parent].any_child;
+      }
+      if (StringView::npos == segment.find_first_of("*?")) {
+         auto found = nodes[parent].literal.find(segment);
+         if (found != nodes[parent].literal.end()) {
+            return found->second;
+         }
+         auto index = add_node();
+         nodes[parent].literal.emplace(segment.to_string(), index);
+         return index;
+      }
+      for (auto &wildcard : nodes[parent].wildcard) {
+         if (wildcard.first == segment) {
+            return wildcard.second;
+         }
+      }
+      auto index = add_node();
+      nodes[parent].wildcard.emplace_back(segment.to_string(), index);
+      return index;
+   }
+
+   // activate node `index` and the `**` nodes reachable from it without a segment
+   void enter(std::vector<std::size_t> &active, std::size_t index) const {
+      active.push_back(index);
+      for (auto any = nodes[index].any_child; any; any = nodes[any].any_child) {
+         active.push_back(any);
+      }
+   }
+
+   static bool glob(StringView pattern, StringView str) {
+      std::size_t p{}, s{};
+      auto star = StringView::npos;
+      std::size_t matched{};
+      while (s < str.size()) {
+         if (p < pattern.size() && (pattern[p] == '?' || pattern[p] == str[s])) {
+            ++p;
+            ++s;
+         } else if (p < pattern.size() && pattern[p] == '*') {
+            star = p++;
+            matched = s;
+         } else if (star != StringView::npos) {
+            p = star + 1;
+            s = ++matched;
+         } else {
+            return false;
+         }
+      }
+      while (p < pattern.size() && pattern[p] == '*') {
+         ++p;
+      }
+      return p == pattern.size();
+   }
+
+   std::vector<node_t> nodes; // nodes[0] is the root
+   bool has_include{};
+   bool has_exclude{};
+};
+
+} // namespace DDS_TINYTEST_NAMESPACE
+} // namespace DDS_ROOT_NAMESPACE
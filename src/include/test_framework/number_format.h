@@ -0,0 +1,443 @@
+#pragma once
+
+/*
+ * Formatting of arithmetic values to characters, without iostream:
+ *  - integers are converted two digits at a time with a table
+ *  - float and double get the shortest digits which read back to the same value, with
+ *    Grisu2 by Florian Loitsch ("Printing Floating-Point Numbers Quickly and Accurately
+ *    with Integers"); for a tiny fraction of values the digits are not the shortest,
+ *    but they still read back exactly
+ *
+ * Every function writes to `out` and returns the end of the written characters.
+ */
+
+#include <cmath>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <limits>
+#include <type_traits>
+
+namespace print_detail {
+
+// enough for any integer of up to 64 bits with sign and any shortest float or double
+constexpr std::size_t max_number_chars = 32;
+
+inline const char *digit_pairs() {
+   return "00010203040506070809"
+          "10111213141516171819"
+          "20212223242526272829"
+          "30313233343536373839"
+          "40414243444546474849"
+          "50515253545556575859"
+          "60616263646566676869"
+          "70717273747576777879"
+          "80818283848586878889"
+          "90919293949596979899";
+}
+
+inline unsigned count_digits(std::uint64_t value) {
+   unsigned count = 1;
+   for (;;) {
+      if (value < 10) {
+         return count;
+      }
+      if (value < 100) {
+         return count + 1;
+      }
+      if (value < 1000) {
+         return count + 2;
+      }
+      if (value < 10000) {
+         return count + 3;
+      }
+      value /= 10000;
+      count += 4;
+   }
+}
+
+inline char *format_decimal(char *out, std::uint64_t value) {
+   auto *end = out + count_digits(value);
+   auto *it = end;
+   const char *pairs = digit_pairs();
+   while (value >= 100) {
+      auto pair = static_cast<std::size_t>(value % 100) * 2;
+      value /= 100;
+      *--it = pairs[pair + 1];
+      *--it = pairs[pair];
+   }
+   if (value >= 10) {
+      auto pair = static_cast<std::size_t>(value) * 2;
+      *--it = pairs[pair + 1];
+      *--it = pairs[pair];
+   } else {
+      *--it = static_cast<char>('0' + value);
+   }
+   return end;
+}
+
+template <typename T>
+char *format_integer(char *out, T value) {
+   static_assert(std::is_integral<T>::value, "integer expected");
+   using unsigned_t = std::make_unsigned_t<T>;
+   auto magnitude = static_cast<unsigned_t>(value);
+   if (value < T{}) {
+      *out++ = '-';
+      magnitude = static_cast<unsigned_t>(unsigned_t{} - magnitude);
+   }
+   return format_decimal(out, magnitude);
+}
+
+inline char *format_hex(char *out, std::uint64_t value, bool upper = false) {
+   const char *digits = upper ? "0123456789ABCDEF" : "0123456789abcdef";
+   unsigned count = 1;
+   while (count < 16 && (value >> (4 * count))) {
+      ++count;
+   }
+   auto *end = out + count;
+   for (auto *it = end; it != out; value >>= 4) {
+      *--it = digits[value & 0xf];
+   }
+   return end;
+}
+
+/*
+ * Grisu2 works with "do-it-yourself" floating point numbers f * 2^e with 64-bit f.
+ */
+struct DiyFp {
+   std::uint64_t f;
+   int e;
+
+   DiyFp operator-(const DiyFp &rhs) const { return {f - rhs.f, e}; }
+
+   // upper 64 bits of the product, rounded
+   DiyFp operator*(const DiyFp &rhs) const {
+      const std::uint64_t mask = 0xffffffffu;
+      std::uint64_t a = f >> 32, b = f & mask, c = rhs.f >> 32, d = rhs.f & mask;
+      std::uint64_t ac = a * c, bc = b * c, ad = a * d, bd = b * d;
+      std::uint64_t mid = (bd >> 32) + (ad & mask) + (bc & mask) + (1u << 31);
+      return {ac + (ad >> 32) + (bc >> 32) + (mid >> 32), e + rhs.e + 64};
+   }
+
+   DiyFp normalize() const {
+      DiyFp ret = *this;
+      while (!(ret.f & (std::uint64_t{1} << 63))) {
+         ret.f <<= 1;
+         --ret.e;
+      }
+      return ret;
+   }
+};
+
+// binary layout of float and double
+template <typename T>
+struct FloatTraits;
+
+template <>
+struct FloatTraits<float> {
+   using bits_t = std::uint32_t;
+   static constexpr int significand_bits = 23;
+   static constexpr int exponent_bias = 127 + significand_bits;
+};
+
+template <>
+struct FloatTraits<double> {
+   using bits_t = std::uint64_t;
+   static constexpr int significand_bits = 52;
+   static constexpr int exponent_bias = 1023 + significand_bits;
+};
+
+// finite positive value as DiyFp with its lower and upper rounding boundaries
+template <typename T>
+void diy_fp_boundaries(T value, DiyFp &v, DiyFp &minus, DiyFp &plus) {
+   using traits = FloatTraits<T>;
+   typename traits::bits_t bits;
+   std::memcpy(&bits, &value, sizeof(bits));
+   const std::uint64_t hidden = std::uint64_t{1} << traits::significand_bits;
+   std::uint64_t significand = bits & (hidden - 1);
+   int biased = static_cast<int>(bits >> traits::significand_bits);
+   if (biased) {
+      v = {significand + hidden, biased - traits::exponent_bias};
+   } else {
+      v = {significand, 1 - traits::exponent_bias};
+   }
+   plus = DiyFp{(v.f << 1) + 1, v.e - 1}.normalize();
+   // the lower neighbour is closer when the value is a power of two
+   minus = v.f == hidden && biased > 1 ? DiyFp{(v.f << 2) - 1, v.e - 2}
+                                       : DiyFp{(v.f << 1) - 1, v.e - 1};
+   minus.f <<= minus.e - plus.e;
+   minus.e = plus.e;
+}
+
+/*
+ * Normalized 10^-k for k = -348 + 8i, so the product with the value has the binary
+ * exponent in the range Grisu2 needs.
+ */
+inline DiyFp cached_power(int e, int &k) {
+   static const DiyFp powers[] = {
+      {0xfa8fd5a0081c0288ull, -1220},
+      {0xbaaee17fa23ebf76ull, -1193},
+      {0x8b16fb203055ac76ull, -1166},
+      {0xcf42894a5dce35eaull, -1140},
+      {0x9a6bb0aa55653b2dull, -1113},
+      {0xe61acf033d1a45dfull, -1087},
+      {0xab70fe17c79ac6caull, -1060},
+      {0xff77b1fcbebcdc4full, -1034},
+      {0xbe5691ef416bd60cull, -1007},
+      {0x8dd01fad907ffc3cull, -980},
+      {0xd3515c2831559a83ull, -954},
+      {0x9d71ac8fada6c9b5ull, -927},
+      {0xea9c227723ee8bcbull, -901},
+      {0xaecc49914078536dull, -874},
+      {0x823c12795db6ce57ull, -847},
+      {0xc21094364dfb5637ull, -821},
+      {0x9096ea6f3848984full, -794},
+      {0xd77485cb25823ac7ull, -768},
+      {0xa086cfcd97bf97f4ull, -741},
+      {0xef340a98172aace5ull, -715},
+      {0xb23867fb2a35b28eull, -688},
+      {0x84c8d4dfd2c63f3bull, -661},
+      {0xc5dd44271ad3cdbaull, -635},
+      {0x936b9fcebb25c996ull, -608},
+      {0xdbac6c247d62a584ull, -582},
+      {0xa3ab66580d5fdaf6ull, -555},
+      {0xf3e2f893dec3f126ull, -529},
+      {0xb5b5ada8aaff80b8ull, -502},
+      {0x87625f056c7c4a8bull, -475},
+      {0xc9bcff6034c13053ull, -449},
+      {0x964e858c91ba2655ull, -422},
+      {0xdff9772470297ebdull, -396},
+      {0xa6dfbd9fb8e5b88full, -369},
+      {0xf8a95fcf88747d94ull, -343},
+      {0xb94470938fa89bcfull, -316},
+      {0x8a08f0f8bf0f156bull, -289},
+      {0xcdb02555653131b6ull, -263},
+      {0x993fe2c6d07b7facull, -236},
+      {0xe45c10c42a2b3b06ull, -210},
+      {0xaa242499697392d3ull, -183},
+      {0xfd87b5f28300ca0eull, -157},
+      {0xbce5086492111aebull, -130},
+      {0x8cbccc096f5088ccull, -103},
+      {0xd1b71758e219652cull, -77},
+      {0x9c40000000000000ull, -50},
+      {0xe8d4a51000000000ull, -24},
+      {0xad78ebc5ac620000ull, 3},
+      {0x813f3978f8940984ull, 30},
+      {0xc097ce7bc90715b3ull, 56},
+      {0x8f7e32ce7bea5c70ull, 83},
+      {0xd5d238a4abe98068ull, 109},
+      {0x9f4f2726179a2245ull, 136},
+      {0xed63a231d4c4fb27ull, 162},
+      {0xb0de65388cc8ada8ull, 189},
+      {0x83c7088e1aab65dbull, 216},
+      {0xc45d1df942711d9aull, 242},
+      {0x924d692ca61be758ull, 269},
+      {0xda01ee641a708deaull, 295},
+      {0xa26da3999aef774aull, 322},
+      {0xf209787bb47d6b85ull, 348},
+      {0xb454e4a179dd1877ull, 375},
+      {0x865b86925b9bc5c2ull, 402},
+      {0xc83553c5c8965d3dull, 428},
+      {0x952ab45cfa97a0b3ull, 455},
+      {0xde469fbd99a05fe3ull, 481},
+      {0xa59bc234db398c25ull, 508},
+      {0xf6c69a72a3989f5cull, 534},
+      {0xb7dcbf5354e9beceull, 561},
+      {0x88fcf317f22241e2ull, 588},
+      {0xcc20ce9bd35c78a5ull, 614},
+      {0x98165af37b2153dfull, 641},
+      {0xe2a0b5dc971f303aull, 667},
+      {0xa8d9d1535ce3b396ull, 694},
+      {0xfb9b7cd9a4a7443cull, 720},
+      {0xbb764c4ca7a44410ull, 747},
+      {0x8bab8eefb6409c1aull, 774},
+      {0xd01fef10a657842cull, 800},
+      {0x9b10a4e5e9913129ull, 827},
+      {0xe7109bfba19c0c9dull, 853},
+      {0xac2820d9623bf429ull, 880},
+      {0x80444b5e7aa7cf85ull, 907},
+      {0xbf21e44003acdd2dull, 933},
+      {0x8e679c2f5e44ff8full, 960},
+      {0xd433179d9c8cb841ull, 986},
+      {0x9e19db92b4e31ba9ull, 1013},
+      {0xeb96bf6ebadf77d9ull, 1039},
+      {0xaf87023b9bf0ee6bull, 1066}
+   };
+   // smallest k for which the exponent of the product is at least -60
+   double dk = (-61 - e) * 0.30102999566398114 + 347;
+   auto ik = static_cast<int>(dk);
+   if (dk - ik > 0.0) {
+      ++ik;
+   }
+   auto index = static_cast<unsigned>((ik >> 3) + 1);
+   k = 348 - static_cast<int>(index << 3);
+   return powers[index];
+}
+
+inline void grisu_round(char *digits,
+                        int len,
+                        std::uint64_t delta,
+                        std::uint64_t rest,
+                        std::uint64_t ten_kappa,
+                        std::uint64_t wp_w) {
+   while (rest < wp_w && delta - rest >= ten_kappa &&
+          (rest + ten_kappa < wp_w || wp_w - rest > rest + ten_kappa - wp_w)) {
+      --digits[len - 1];
+      rest += ten_kappa;
+   }
+}
+
+// generates the shortest digits of `w` inside (`mp` - `delta`, `mp`)
+inline int grisu_digits(const DiyFp &w,
+                        const DiyFp &mp,
+                        std::uint64_t delta,
+                        char *digits,
+                        int &k) {
+   static const std::uint64_t pow10[] = {
+      1ull,
+      10ull,
+      100ull,
+      1000ull,
+      10000ull,
+      100000ull,
+      1000000ull,
+      10000000ull,
+      100000000ull,
+      1000000000ull,
+      10000000000ull,
+      100000000000ull,
+      1000000000000ull,
+      10000000000000ull,
+      100000000000000ull,
+      1000000000000000ull,
+      10000000000000000ull,
+      100000000000000000ull,
+      1000000000000000000ull,
+      10000000000000000000ull,
+   };
+   const DiyFp one{std::uint64_t{1} << -mp.e, mp.e};
+   const std::uint64_t wp_w = (mp - w).f;
+   auto p1 = static_cast<std::uint32_t>(mp.f >> -one.e);
+   std::uint64_t p2 = mp.f & (one.f - 1);
+   int len = 0;
+   auto kappa = static_cast<int>(count_digits(p1));
+   while (kappa > 0) {
+      auto divisor = pow10[kappa - 1];
+      auto d = p1 / divisor;
+      p1 = static_cast<std::uint32_t>(p1 % divisor);
+      if (d || len) {
+         digits[len++] = static_cast<char>('0' + d);
+      }
+      --kappa;
+      std::uint64_t rest = (static_cast<std::uint64_t>(p1) << -one.e) + p2;
+      if (rest <= delta) {
+         k += kappa;
+         auto ten_kappa = pow10[kappa] << -one.e;
+         grisu_round(digits, len, delta, rest, ten_kappa, wp_w);
+         return len;
+      }
+   }
+   for (;;) {
+      p2 *= 10;
+      delta *= 10;
+      auto d = static_cast<char>(p2 >> -one.e);
+      if (d || len) {
+         digits[len++] = static_cast<char>('0' + d);
+      }
+      p2 &= one.f - 1;
+      --kappa;
+      if (p2 < delta) {
+         k += kappa;
+         auto index = -kappa;
+         auto scaled_wp_w = wp_w * (index < 20 ? pow10[index] : 0);
+         grisu_round(digits, len, delta, p2, one.f, scaled_wp_w);
+         return len;
+      }
+   }
+}
+
+// shortest digits of a finite positive value, which is digits * 10^k
+template <typename T>
+int grisu2(T value, char *digits, int &k) {
+   DiyFp v, minus, plus;
+   diy_fp_boundaries(value, v, minus, plus);
+   auto c_mk = cached_power(plus.e, k);
+   auto w = v.normalize() * c_mk;
+   auto wp = plus * c_mk;
+   auto wm = minus * c_mk;
+   ++wm.f;
+   --wp.f;
+   return grisu_digits(w, wp, wp.f - wm.f, digits, k);
+}
+
+/*
+ * Places the digits like %g does: fixed notation for decimal exponents in [-4, 17) and
+ * exponential notation otherwise, without trailing zeros in the fraction.
+ */
+inline char *format_digits(char *out, const char *digits, int len, int k) {
+   int exponent = len + k - 1;
+   if (exponent < -4 || exponent >= 17) {
+      *out++ = digits[0];
+      if (len > 1) {
+         *out++ = '.';
+         std::memcpy(out, digits + 1, static_cast<std::size_t>(len - 1));
+         out += len - 1;
+      }
+      *out++ = 'e';
+      *out++ = exponent < 0 ? '-' : '+';
+      auto magnitude = static_cast<unsigned>(exponent < 0 ? -exponent : exponent);
+      if (magnitude < 10) {
+         *out++ = '0';
+      }
+      return format_decimal(out, magnitude);
+   }
+   if (k >= 0) {
+      std::memcpy(out, digits, static_cast<std::size_t>(len));
+      out += len;
+      std::memset(out, '0', static_cast<std::size_t>(k));
+      return out + k;
+   }
+   int point = len + k; // digits before the decimal point
+   if (point > 0) {
+      std::memcpy(out, digits, static_cast<std::size_t>(point));
+      out += point;
+      *out++ = '.';
+      std::memcpy(out, digits + point, static_cast<std::size_t>(len - point));
+      return out + (len - point);
+   }
+   *out++ = '0';
+   *out++ = '.';
+   std::memset(out, '0', static_cast<std::size_t>(-point));
+   out += -point;
+   std::memcpy(out, digits, static_cast<std::size_t>(len));
+   return out + len;
+}
+
+// shortest representation of float or double, which reads back to the same value
+template <typename T>
+char *format_shortest(char *out, T value) {
+   static_assert(std::is_same<T, float>::value || std::is_same<T, double>::value,
+                 "float or double expected");
+   if (value != value) {
+      std::memcpy(out, "nan", 3);
+      return out + 3;
+   }
+   if (std::signbit(value)) {
+      *out++ = '-';
+      value = -value;
+   }
+   if (value == std::numeric_limits<T>::infinity()) {
+      std::memcpy(out, "inf", 3);
+      return out + 3;
+   }
+   if (value == 0) {
+      *out = '0';
+      return out + 1;
+   }
+   char digits[20];
+   int k{};
+   int len = grisu2(value, digits, k);
+   return format_digits(out, digits, len, k);
+}
+
+} // namespace print_detail
@@ -0,0 +1,106 @@
+#pragma once
+
+#include <common/common.h>
+#include <common/inplace_function.h>
+#include <test_framework/config.h>
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <cstddef>
+#include <ctime>
+#include <memory>
+#include <mutex>
+#include <thread>
+
+namespace DDS_ROOT_NAMESPACE {
+namespace DDS_TINYTEST_NAMESPACE {
+
+/*
+ * CPU time consumed by the calling thread (whole process where it is not supported).
+ */
+inline std::chrono::nanoseconds __thread_cpu_now() {
+#if defined(CLOCK_THREAD_CPUTIME_ID)
+   timespec ts{};
+   clock_gettime(CLOCK_THREAD_CPUTIME_ID, &ts);
+   return std::chrono::seconds{ts.tv_sec} + std::chrono::nanoseconds{ts.tv_nsec};
+#else
+   return std::chrono::nanoseconds{static_cast<long long>(
+      1e9 * static_cast<double>(std::clock()) / CLOCKS_PER_SEC)};
+#endif
+}
+
+/*
+ * Watchdog of running test cases. Every test case has a slot, which is armed when the
+ * test case starts and disarmed when it ends. A background thread calls `on_timeout`
+ * once for every slot armed for longer than `timeout`.
+ */
+class __watchdog_t {
+public:
+   using clock_t = std::chrono::steady_clock;
+   using on_timeout_t = inplace_move_function_t<void(std::size_t /*slot*/)>;
+
+   __watchdog_t(std::size_t slots_count,
+                std::chrono::milliseconds timeout_,
+                on_timeout_t on_timeout_)
+      : slots{new slot_t[slots_count]}
+      , count{slots_count}
+      , timeout{timeout_}
+      , on_timeout{std::move(on_timeout_)} {
+      auto period = std::max(std::chrono::milliseconds{1},
+                             std::min(timeout / 4, std::chrono::milliseconds{100}));
+      thread = std::thread{[this, period] { watch(period); }};
+   }
+
+   ~__watchdog_t() {
+      {
+         std::lock_guard<std::mutex> lock{mtx};
+         done = true;
+      }
+      cv.notify_all();
+      thread.join();
+   }
+
+   void start(std::size_t slot) {
+      slots[slot].start.store(clock_t::now().time_since_epoch().count());
+   }
+
+   // returns true if the slot expired while it was armed
+   bool stop(std::size_t slot) {
+      slots[slot].start.store(0);
+      return slots[slot].expired.load();
+   }
+
+private:
+   struct slot_t {
+      std::atomic<clock_t::rep> start{0}; // 0 - not running
+      std::atomic<bool> expired{false};
+   };
+
+   void watch(std::chrono::milliseconds period) {
+      std::unique_lock<std::mutex> lock{mtx};
+      while (!cv.wait_for(lock, period, [this] { return done; })) {
+         auto now = clock_t::now().time_since_epoch().count();
+         auto limit = std::chrono::duration_cast<clock_t::duration>(timeout).count();
+         for (std::size_t i = 0; i < count; ++i) {
+            auto start = slots[i].start.load();
+            if (start && now - start > limit && !slots[i].expired.exchange(true)) {
+               on_timeout(i);
+            }
+         }
+      }
+   }
+
+   std::unique_ptr<slot_t[]> slots;
+   std::size_t count;
+   std::chrono::milliseconds timeout;
+   on_timeout_t on_timeout;
+   std::mutex mtx;
+   std::condition_variable cv;
+   bool done{};
+   std::thread thread;
+};
+
+} // namespace DDS_TINYTEST_NAMESPACE
+} // namespace DDS_ROOT_NAMESPACE
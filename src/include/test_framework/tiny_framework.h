@@ -35,17 +35,60 @@
  *
  * TEST_SUITE_END() // end of suite  suite_name1
  *
+ * // suite which test cases must never run in parallel with other test cases
+ * TEST_SUITE_SERIAL_BEGIN(suite_name3)
+ * ...
+ * TEST_SUITE_END()
+ *
+ * // micro-benchmark, see test_framework/benchmark.h
+ * TEST_BENCHMARK(bench_name1) {
+ *    TEST_BENCHMARK_LOOP { do_not_optimize(some_function()); }
+ * }
+ *
+ * // heap allocations (requires DDS_TINYTEST_TRACK_ALLOCS, see alloc_tracker.h)
+ * TEST_CASE(case_name3) {
+ *    TEST_CHECK_NO_ALLOC { hot_path(); }
+ *    TEST_CHECK_ALLOCS_AT_MOST(1) { std::vector<int> v(10); }
+ * }
+ *
+ * Test cases are executed on the main thread by default. With `--jobs=N` they are run
+ * by a pool of N threads, every test case collects its checks and log output on its own
+ * and the output is printed in registration order, so it stays deterministic. The log
+ * output includes lines of println/println_fmt, but not other writes to std::cout.
  *
  */
 
 #include <common/common.h>
+#include <mpl/for_each_field.h>
+#include <mpl/static_for.h>
+#include <mpl/switch_string.h>
 #include <string>
+#include <test_framework/alloc_tracker.h>
+#include <test_framework/benchmark.h>
 #include <test_framework/config.h>
+#include <test_framework/deferred_log.h>
+#include <test_framework/file_log_sink.h>
+#include <test_framework/format.h>
+#include <test_framework/name_filter.h>
+#include <test_framework/timing.h>
 #include <test_framework/tools.h>
+#include <test_framework/work_pool.h>
 
-#include <functional>
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <condition_variable>
+#include <cstdlib>
+#include <fstream>
 #include <list>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <new>
+#include <shared_mutex>
 #include <sstream>
+#include <thread>
+#include <vector>
 
 namespace DDS_ROOT_NAMESPACE {
 namespace DDS_TINYTEST_NAMESPACE {
@@ -55,23 +98,107 @@ struct __config_t;
 // only declaration
 __config_t &__get_config();
 
-enum __check_return_e { __check_ok, __check_err };
+struct __test_node_t;
+struct __test_result_t;
+
+using __test_fn_t = void (*)(const __config_t &, __test_result_t &);
+
+/*
+ * Suite defined with TEST_SUITE_BEGIN. Nodes are constant, they are linked to the
+ * enclosing suite at compile time (see `__tiny_test_suite`).
+ */
+struct __suite_node_t {
+   const char *label;
+   bool serial;
+   const __suite_node_t *parent;
+};
 
-using __test_report_cb_t = std::function<void(__check_return_e)>;
-using __test_cb_t = std::function<void(const __config_t &, __test_report_cb_t)>;
-using __test_info_t = std::pair<String /*name*/, __test_cb_t>;
-using __tests_t = std::list<__test_info_t>;
-using __list_suites_t = std::list<String>;
+// result of a single test case, filled by the thread which runs it
+struct __test_result_t {
+   const __test_node_t *test{};
+   bool ran{};
+   unsigned checks{};
+   unsigned errors{};
+   // passed checks take the slow path: they are traced or TEST_INFO has to be reset
+   bool notify_passed{};
+   std::list<String> info; // messages of TEST_INFO
+   String log;
+   std::chrono::nanoseconds wall{}; // wall-clock time of the test case
+   std::chrono::nanoseconds cpu{};  // CPU time of the thread running it
+   __alloc_stats_t allocs;          // heap allocations done by the test case
+   __bench_stats_t bench; // measured samples of TEST_BENCHMARK
+};
+
+/*
+ * Log buffer of the test case running on the current thread (nullptr - print directly).
+ * Lines of println and println_fmt to std::cout are captured by it as well.
+ */
+inline String *&__thread_log() { return print_detail::thread_capture(); }
 
+/*
+ * Registered test cases form an intrusive list of statically allocated nodes, so no
+ * memory is allocated before `main`.
+ */
 struct __static_test_object_t {
-   __tests_t tests;
-   __list_suites_t suites;
-   const String test_separator{"/"};
+   __test_node_t *first{};
+   __test_node_t *last{};
+   const char *test_separator{"/"};
 };
 
 // only declaration
 __static_test_object_t &__get_sobject();
 
+/*
+ * Test case defined with TEST_CASE or TEST_BENCHMARK. Full name is built only when
+ * it is needed.
+ */
+struct __test_node_t {
+   __test_node_t(const __suite_node_t *suite_,
+                 const char *name_,
+                 __test_fn_t fn_,
+                 bool benchmark_ = false)
+      : suite{suite_}
+      , name{name_}
+      , fn{fn_}
+      , benchmark{benchmark_} {
+      auto &obj = __get_sobject();
+      (obj.last ? obj.last->next : obj.first) = this;
+      obj.last = this;
+   }
+
+   // must not run in parallel with other test cases
+   bool serial() const {
+      for (auto *s = suite; s; s = s->parent) {
+         if (s->serial) {
+            return true;
+         }
+      }
+      return benchmark;
+   }
+
+   // names of all suites and test case joined with `test_separator`
+   String full_name() const {
+      String calc;
+      append_suite(calc, suite);
+      return calc + name;
+   }
+
+   const __suite_node_t *suite;
+   const char *name;
+   __test_fn_t fn;
+   bool benchmark; // defined with TEST_BENCHMARK
+   __test_node_t *next{};
+
+private:
+   static void append_suite(String &calc, const __suite_node_t *s) {
+      if (s) {
+         append_suite(calc, s->parent);
+         calc += s->label;
+         calc += __get_sobject().test_separator;
+      }
+   }
+};
+
 struct __config_t {
    enum Level {
       ERROR,          // print only error
@@ -80,24 +207,61 @@ struct __config_t {
       ALL,            // print also postive checks
    };
 
+   enum BenchMode {
+      BENCH_ALSO, // run benchmarks together with test cases
+      BENCH_ONLY, // run only benchmarks (--bench)
+      BENCH_NONE, // skip benchmarks (--no-bench)
+   };
+
    bool parse_args(int argc, char **argv) {
       if (argc < 2) {
          return true;
       }
+      using DDS_MPL_NAMESPACE::case_;
+      using DDS_MPL_NAMESPACE::switch_string;
       for (int i = 1; i < argc; ++i) {
          StringView opt{argv[i]};
-         if ("--help" == opt) {
-            print_help(argv[0]);
-            return false;
-         } else if ("--log_level=message" == opt) {
-            level = MESSAGE;
-         } else if ("--log_level=testnames" == opt) {
-            level = TEST_CASE_NAME;
-         } else if ("--log_level=all" == opt) {
-            level = ALL;
-         } else if ("--log_level=error" == opt) {
-            level = ERROR;
-         } else {
+         // an option with a value is matched by its name up to '='
+         auto split = std::min(opt.find('='), opt.size());
+         auto name = opt.substr(0, split + (split < opt.size()));
+         auto value = opt.substr(name.size()).to_string();
+         bool valid = true;
+         bool known = switch_string(
+            name,
+            case_("--help", [&] { valid = false; }),
+            case_("--log_level=", [&] { valid = parse_level(value); }),
+            case_("--bench", [&] { bench = BENCH_ONLY; }),
+            case_("--no-bench", [&] { bench = BENCH_NONE; }),
+            case_("--jobs=", [&] { valid = parse_jobs(value.c_str()); }),
+            case_("--filter=", [&] { add_filter(value); }),
+            case_("--list", [&] { list = true; }),
+            case_("--slowest=", [&] {
+               char *end{};
+               slowest = static_cast<unsigned>(std::strtoul(value.c_str(), &end, 10));
+               valid = !value.empty() && !*end;
+            }),
+            case_("--timeout=", [&] {
+               char *end{};
+               timeout = std::chrono::milliseconds{std::strtoul(value.c_str(), &end, 10)};
+               valid = !value.empty() && !*end;
+            }),
+            case_("--flush=", [&] { valid = parse_flush(value); }),
+            case_("--log-sink=", [&] {
+               log_sink = make_log_sink(value);
+               if (!log_sink) {
+                  std::cerr << "[error] Can't create log sink " << value << "\n";
+                  valid = false;
+               }
+            }),
+            case_("--timeout-abort", [&] { timeout_abort = true; }),
+            case_("--save-baseline=", [&] { save_baseline = value; }),
+            case_("--compare-baseline=", [&] { compare_baseline = value; }),
+            case_("--regression-threshold=", [&] {
+               char *end{};
+               regression_threshold = std::strtod(value.c_str(), &end) / 100;
+               valid = !value.empty() && !*end && regression_threshold >= 0;
+            }));
+         if (!known || !valid) {
             print_help(argv[0]);
             return false;
          }
@@ -105,81 +269,691 @@ struct __config_t {
       return true;
    }
 
-   void trace(Level type, const String &msg) const {
+   void trace(Level type, const String &msg) const { trace(type, msg.c_str()); }
+
+   void trace(Level type, const char *msg) const {
       if (type > level) {
          return;
       }
+      if (auto *log = __thread_log()) {
+         *log += msg;
+         *log += '\n';
+         return;
+      }
       println(msg);
    }
 
    int run_tests(const __static_test_object_t &obj) const {
-      int count_test_cases{};
-      unsigned checks{};
-      unsigned errors{};
-      auto test_report_cb = [&checks, &errors](__check_return_e value) {
-         switch (value) {
-         case __check_err: ++errors; break;
-         case __check_ok: ++checks; break;
-         default: DdsVerify(!"Unhandled case");
-         }
-      };
-      for (auto &test : obj.tests) {
-         trace(TEST_CASE_NAME, "Enter: " + test.first);
-         if (filter(test)) {
-            auto stored_checks = checks;
-            auto stored_errors = errors;
-            test.second(*this, test_report_cb);
-            ++count_test_cases;
-            auto ran_checks = checks - stored_checks;
-            auto ran_errors = errors - stored_errors;
-            if (ran_checks == 0 && ran_errors == 0) {
-               trace(MESSAGE,
-                     "[warning] Test case " + test.first + " doesn't check anything");
-            } else {
-               trace(ALL,
-                     "[info] Test case " + test.first + " ran " +
-                        std::to_string(ran_checks + ran_errors) + " cheks (" +
-                        std::to_string(ran_errors) + " of them failed)");
+      std::vector<const __test_node_t *> tests;
+      for (auto *test = obj.first; test; test = test->next) {
+         tests.push_back(test);
+      }
+      if (log_sink) {
+         set_log_sink(log_sink.get());
+      }
+      if (list) {
+         for (auto *test : tests) {
+            if (filter(*test)) {
+               println(test->full_name());
             }
          }
-         trace(TEST_CASE_NAME, "Leave: " + test.first);
+         close_log_sink();
+         return 0;
+      }
+      std::vector<__test_result_t> results(tests.size());
+      for (std::size_t i = 0; i < tests.size(); ++i) {
+         results[i].test = tests[i];
+      }
+
+      std::unique_ptr<__watchdog_t> watchdog;
+      if (timeout.count()) {
+         auto on_timeout = [&](std::size_t i) { report_timeout(*tests[i]); };
+         watchdog.reset(new __watchdog_t{tests.size(), timeout, on_timeout});
+      }
+      if (jobs > 1 && tests.size() > 1) {
+         run_parallel(tests, results, watchdog.get());
+      } else {
+         for (std::size_t i = 0; i < tests.size(); ++i) {
+            run_case(*tests[i], results[i], watchdog.get(), i);
+         }
+      }
+      watchdog.reset();
+
+      int count_test_cases{};
+      unsigned errors{};
+      for (auto &result : results) {
+         count_test_cases += result.ran;
+         errors += result.errors;
       }
+      if (!save_baseline.empty()) {
+         errors += save_bench_baseline(tests, results);
+      }
+      if (!compare_baseline.empty()) {
+         errors += compare_bench_baseline(tests, results);
+      }
+      deferred_log_flush();
+      close_log_sink(); // keep the log before the summary
       String errors_report;
       if (errors) {
          errors_report = std::to_string(errors) + " checks failed.";
       }
       std::cerr << "*** run " << count_test_cases << " tests. " << errors_report << "\n";
+      print_slowest(results);
       return 0;
    }
 
    static void print_help(const char *name) {
       std::cerr << "Usage:\n"
                 << name << "\n --log_level=[error/message/testnames/all]\n"
+                << " --jobs=N (run test cases on N threads, 0 - one per core)\n"
+                << " --filter=pattern[,pattern...] (run only matching test cases)\n"
+                << "    pattern: glob over `suite/nested/case` names, `*` and `?` match\n"
+                << "    inside a name, `**` matches any suites, a suite selects all its\n"
+                << "    cases, `-pattern` excludes matching test cases\n"
+                << " --list (print names of selected test cases, don't run them)\n"
+                << " --bench (run only benchmarks)\n"
+                << " --no-bench (skip benchmarks)\n"
+                << " --slowest=N (print N slowest test cases, default 5)\n"
+                << " --timeout=ms (report test cases running longer than ms)\n"
+                << " --timeout-abort (abort when a test case exceeds --timeout)\n"
+                << " --flush=[line/buffer] (flush log after every line or when full)\n"
+                << " --log-sink=[fd:N/mmap:path/ring:MB] (write log to descriptor N,\n"
+                << "    to a memory-mapped file or keep its last MB megabytes in memory\n"
+                << "    and print them at the end)\n"
+                << " --save-baseline=path (save benchmark results)\n"
+                << " --compare-baseline=path (fail on benchmarks slower than saved)\n"
+                << " --regression-threshold=percent (allowed slowdown, default 5)\n"
                 << " --help (print this help message)\n";
    }
 
-   bool filter(const __test_info_t &test) const {
-      (void)test.first; // TODO: add filtering by name
-      return true;
+   bool filter(const __test_node_t &test) const {
+      if (test.benchmark ? bench == BENCH_NONE : bench == BENCH_ONLY) {
+         return false;
+      }
+      return name_filter.empty() ||
+             name_filter.match(test.full_name(), __get_sobject().test_separator);
+   }
+
+   void report_benchmark(const String &name, const __bench_stats_t &stats) const {
+      std::stringstream strm;
+      strm << "[bench] " << name << ": " << stats.samples.size() << " samples x "
+           << stats.iterations << " iterations, min " << format_time(stats.min)
+           << ", median " << format_time(stats.median) << ", mean "
+           << format_time(stats.mean) << ", stddev " << format_time(stats.stddev);
+      if (stats.items_per_iteration > 0 && stats.mean > 0) {
+         strm << ", " << format_rate(stats.items_per_iteration * 1e9 / stats.mean)
+              << "items/s";
+      }
+      if (stats.bytes_per_iteration > 0 && stats.mean > 0) {
+         strm << ", " << format_rate(stats.bytes_per_iteration * 1e9 / stats.mean)
+              << "B/s";
+      }
+      trace(ERROR, strm.str());
    }
 
    Level level{ERROR};
-};
+   unsigned jobs{1};
+   bool list{};
+   __name_filter_t name_filter;
+   BenchMode bench{BENCH_ALSO};
+   __bench_options_t bench_options;
+   unsigned slowest{5};
+   std::chrono::milliseconds timeout{0}; // 0 - no timeout
+   bool timeout_abort{};
+   String save_baseline;
+   String compare_baseline;
+   double regression_threshold{0.05}; // relative slowdown still accepted
+   double bench_confidence{0.95};     // confidence level of the comparison
+   std::unique_ptr<LogSink> log_sink; // output of the log, stdout when empty
 
-struct __add_remove_suite_t {
-   __add_remove_suite_t(__static_test_object_t &obj, const String &name) {
-      obj.suites.emplace_back(name);
+private:
+   bool parse_level(StringView value) {
+      using DDS_MPL_NAMESPACE::case_;
+      return DDS_MPL_NAMESPACE::switch_string(
+         value,
+         case_("error", [this] { level = ERROR; }),
+         case_("message", [this] { level = MESSAGE; }),
+         case_("testnames", [this] { level = TEST_CASE_NAME; }),
+         case_("all", [this] { level = ALL; }));
+   }
+
+   static bool parse_flush(StringView value) {
+      using DDS_MPL_NAMESPACE::case_;
+      return DDS_MPL_NAMESPACE::switch_string(
+         value,
+         case_("line", [] { print_flush_policy() = PrintFlushPolicy::EveryLine; }),
+         case_("buffer", [] { print_flush_policy() = PrintFlushPolicy::WhenFull; }));
+   }
+
+   void add_filter(StringView patterns) {
+      StringView separator{__get_sobject().test_separator};
+      std::size_t begin{};
+      while (begin <= patterns.size()) {
+         auto end = std::min(patterns.find(',', begin), patterns.size());
+         auto pattern = patterns.substr(begin, end - begin);
+         bool exclude = pattern.starts_with('-');
+         name_filter.add(exclude ? pattern.substr(1) : pattern, separator, exclude);
+         begin = end + 1;
+      }
+   }
+
+   static String format_percent(double value) {
+      std::stringstream strm;
+      strm.precision(3);
+      strm << std::showpos << value * 100 << "%";
+      return strm.str();
+   }
+
+   /*
+    * Baseline file has a header line followed by a line per benchmark:
+    * `name samples mean stddev`, where times are nanoseconds per iteration.
+    */
+   static constexpr const char *baseline_header() { return "tiny_test-baseline-1"; }
+
+   unsigned save_bench_baseline(const std::vector<const __test_node_t *> &tests,
+                                const std::vector<__test_result_t> &results) const {
+      std::ofstream out{save_baseline};
+      out << baseline_header() << "\n";
+      out.precision(17);
+      for (std::size_t i = 0; i < tests.size(); ++i) {
+         auto &bench = results[i].bench;
+         if (!bench.samples.empty()) {
+            out << tests[i]->full_name() << " " << bench.samples.size() << " "
+                << bench.mean << " " << bench.stddev << "\n";
+         }
+      }
+      if (!out.flush()) {
+         trace(ERROR, "[error] Can't write baseline file " + save_baseline);
+         return 1;
+      }
+      return 0;
+   }
+
+   unsigned compare_bench_baseline(const std::vector<const __test_node_t *> &tests,
+                                   const std::vector<__test_result_t> &results) const {
+      std::ifstream in{compare_baseline};
+      String header;
+      if (!(in >> header) || header != baseline_header()) {
+         trace(ERROR, "[error] Can't read baseline file " + compare_baseline);
+         return 1;
+      }
+      std::map<String, __bench_summary_t> baseline;
+      String name;
+      __bench_summary_t summary;
+      while (in >> name >> summary.samples >> summary.mean >> summary.stddev) {
+         baseline[name] = summary;
+      }
+
+      unsigned regressions{};
+      for (std::size_t i = 0; i < tests.size(); ++i) {
+         auto &bench = results[i].bench;
+         if (bench.samples.empty()) {
+            continue;
+         }
+         auto name = tests[i]->full_name();
+         auto found = baseline.find(name);
+         if (found == baseline.end()) {
+            trace(MESSAGE, "[bench] " + name + " is not in the baseline");
+            continue;
+         }
+         __bench_summary_t current{bench.samples.size(), bench.mean, bench.stddev};
+         __bench_compare_t cmp{found->second, current, bench_confidence};
+         if (!cmp.exceeds(regression_threshold)) {
+            continue;
+         }
+         auto report = name + " " + format_percent(cmp.change) + " (" +
+                       std::to_string(static_cast<int>(bench_confidence * 100)) +
+                       "% CI " + format_percent(cmp.low) + " .. " +
+                       format_percent(cmp.high) + ")";
+         if (cmp.change > 0) {
+            ++regressions;
+            trace(ERROR, "[error] Benchmark regressed: " + report);
+         } else {
+            trace(ERROR, "[bench] Benchmark improved: " + report);
+         }
+      }
+      return regressions;
+   }
+
+   static String format_time(double ns) {
+      const char *unit = "ns";
+      if (ns >= 1e6) {
+         ns /= 1e6;
+         unit = "ms";
+      } else if (ns >= 1e3) {
+         ns /= 1e3;
+         unit = "us";
+      }
+      std::stringstream strm;
+      strm.precision(3);
+      strm << ns << " " << unit;
+      return strm.str();
+   }
+
+   static String format_rate(double per_second) {
+      const char *unit = "";
+      if (per_second >= 1e9) {
+         per_second /= 1e9;
+         unit = "G";
+      } else if (per_second >= 1e6) {
+         per_second /= 1e6;
+         unit = "M";
+      } else if (per_second >= 1e3) {
+         per_second /= 1e3;
+         unit = "k";
+      }
+      std::stringstream strm;
+      strm.precision(3);
+      strm << per_second << " " << unit;
+      return strm.str();
+   }
+
+   bool parse_jobs(const char *value) {
+      char *end{};
+      auto parsed = std::strtoul(value, &end, 10);
+      if (!*value || *end) {
+         return false;
+      }
+      jobs = static_cast<unsigned>(parsed);
+      if (!jobs) {
+         jobs = std::max(1u, std::thread::hardware_concurrency());
+      }
+      return true;
+   }
+
+   // called from the watchdog thread, so it is printed immediately
+   void report_timeout(const __test_node_t &test) const {
+      std::cerr << "[timeout] Test case " + test.full_name() + " runs longer than " +
+                      std::to_string(timeout.count()) + " ms\n";
+      std::cerr.flush();
+      if (timeout_abort) {
+         deferred_log_flush();
+         close_log_sink();
+         std::abort();
+      }
+   }
+
+   // the log is complete, later output goes to stdout
+   void close_log_sink() const {
+      std::cout.flush();
+      if (log_sink) {
+         set_log_sink(nullptr);
+         log_sink->close();
+      }
+   }
+
+   void print_slowest(const std::vector<__test_result_t> &results) const {
+      std::vector<const __test_result_t *> ran;
+      for (auto &result : results) {
+         if (result.ran) {
+            ran.push_back(&result);
+         }
+      }
+      auto count = std::min<std::size_t>(slowest, ran.size());
+      if (!count) {
+         return;
+      }
+      std::partial_sort(
+         ran.begin(), ran.begin() + count, ran.end(), [](auto *lhs, auto *rhs) {
+            return lhs->wall > rhs->wall;
+         });
+      std::cerr << "*** slowest " << count << " tests (wall / cpu):\n";
+      for (std::size_t i = 0; i < count; ++i) {
+         std::cerr << "   " << format_time(static_cast<double>(ran[i]->wall.count()))
+                   << " / " << format_time(static_cast<double>(ran[i]->cpu.count()))
+                   << "  " << ran[i]->test->full_name() << "\n";
+      }
    }
-   __add_remove_suite_t(__static_test_object_t &obj) { obj.suites.pop_back(); }
-};
 
-struct __add_test_t {
-   template <typename test_info>
-   __add_test_t(__static_test_object_t &obj, test_info test) {
-      obj.tests.emplace_back(test.__test_name, test);
+   void run_case(const __test_node_t &test,
+                 __test_result_t &result,
+                 __watchdog_t *watchdog,
+                 std::size_t index) const {
+      if (!filter(test)) {
+         return;
+      }
+      if (level >= TEST_CASE_NAME) {
+         trace(TEST_CASE_NAME, "Enter: " + test.full_name());
+      }
+      result.notify_passed = level >= ALL;
+      auto wall_start = std::chrono::steady_clock::now();
+      auto cpu_start = __thread_cpu_now();
+      if (watchdog) {
+         watchdog->start(index);
+      }
+      __alloc_probe_t alloc_probe;
+      test.fn(*this, result);
+      result.allocs = alloc_probe.stats();
+      result.wall = std::chrono::steady_clock::now() - wall_start;
+      result.cpu = __thread_cpu_now() - cpu_start;
+      result.ran = true;
+      if (watchdog && watchdog->stop(index)) {
+         ++result.errors;
+         trace(ERROR,
+               "[error] Test case " + test.full_name() + " exceeded timeout " +
+                  std::to_string(timeout.count()) + " ms, it took " +
+                  format_time(static_cast<double>(result.wall.count())));
+      }
+      if (test.benchmark) {
+         // measurements are reported by the benchmark itself
+      } else if (result.checks == 0 && result.errors == 0) {
+         if (level >= MESSAGE) {
+            trace(MESSAGE,
+                  "[warning] Test case " + test.full_name() + " doesn't check anything");
+         }
+      } else if (level >= ALL) {
+         trace(ALL,
+               "[info] Test case " + test.full_name() + " ran " +
+                  std::to_string(result.checks + result.errors) + " cheks (" +
+                  std::to_string(result.errors) + " of them failed)");
+      }
+      if (level >= ALL && __alloc_tracking_enabled()) {
+         trace(ALL,
+               "[info] Test case " + test.full_name() + " allocated " +
+                  std::to_string(result.allocs.count) + " blocks, " +
+                  std::to_string(result.allocs.bytes) + " bytes (peak " +
+                  std::to_string(result.allocs.peak) + " bytes)");
+      }
+      if (level >= TEST_CASE_NAME) {
+         trace(TEST_CASE_NAME, "Leave: " + test.full_name());
+      }
+   }
+
+   /*
+    * Test cases are executed by a work-stealing pool. Each one logs into its own buffer,
+    * which is printed from this thread in registration order as soon as all preceding
+    * test cases are done. Lines printed by test cases with println go to the buffer too,
+    * other writes to std::cout (print, operator<<) are not ordered. Test cases from
+    * serial suites take the lock exclusively.
+    */
+   void run_parallel(const std::vector<const __test_node_t *> &tests,
+                     std::vector<__test_result_t> &results,
+                     __watchdog_t *watchdog) const {
+      std::shared_timed_mutex serial_mtx;
+      std::mutex done_mtx;
+      std::condition_variable done_cv;
+      std::vector<char> done(tests.size());
+
+      std::thread pool{[&] {
+         __work_stealing_pool_t::run(tests.size(), jobs, [&](std::size_t i) {
+            __thread_log() = &results[i].log;
+            if (tests[i]->serial()) {
+               std::unique_lock<std::shared_timed_mutex> lock{serial_mtx};
+               run_case(*tests[i], results[i], watchdog, i);
+            } else {
+               std::shared_lock<std::shared_timed_mutex> lock{serial_mtx};
+               run_case(*tests[i], results[i], watchdog, i);
+            }
+            __thread_log() = nullptr;
+            {
+               std::lock_guard<std::mutex> lock{done_mtx};
+               done[i] = 1;
+            }
+            done_cv.notify_all();
+         });
+      }};
+
+      for (std::size_t i = 0; i < tests.size(); ++i) {
+         {
+            std::unique_lock<std::mutex> lock{done_mtx};
+            done_cv.wait(lock, [&] { return done[i] != 0; });
+         }
+         if (!results[i].log.empty()) {
+            print(results[i].log);
+         }
+      }
+      pool.join();
    }
 };
 
+/*
+ * Slow path of a passed check, called only when `result.notify_passed` is set.
+ */
+inline void __check_passed(const __config_t &cfg,
+                           __test_result_t &result,
+                           const char *msg) {
+   cfg.trace(__config_t::ALL, msg);
+   result.info.clear();
+   result.notify_passed = cfg.level >= __config_t::ALL;
+}
+
+/*
+ * Slow path of a failed check: count it and report `what` with the TEST_INFO context.
+ */
+inline void __check_failed(const __config_t &cfg,
+                           __test_result_t &result,
+                           bool stop_on_error,
+                           const char *file,
+                           int line,
+                           const String &what) {
+   ++result.errors;
+   std::stringstream strm;
+   strm << "[error] " << (stop_on_error ? "(required check)" : "")
+        << result.test->full_name() << " File: " << file << ":" << line << " " << what;
+   for (const auto &msg : result.info) {
+      cfg.trace(__config_t::ERROR, "   Failed in context:" + msg);
+   }
+   result.info.clear();
+   result.notify_passed = cfg.level >= __config_t::ALL;
+   cfg.trace(__config_t::ERROR, strm.str());
+}
+
+template <typename L, typename R, typename = void>
+struct __has_equal_t : std::false_type {};
+
+template <typename L, typename R>
+struct __has_equal_t<
+   L,
+   R,
+   decltype(void(std::declval<const L &>() == std::declval<const R &>()))>
+   : std::true_type {};
+
+template <typename L, typename R>
+bool __equal(const L &lhs, const R &rhs);
+
+template <typename L, typename R>
+using __both_integral_t =
+   std::integral_constant<bool, std::is_integral<L>::value && std::is_integral<R>::value>;
+
+template <typename T>
+constexpr bool __is_negative(T value, std::true_type /*signed*/) {
+   return value < 0;
+}
+
+template <typename T>
+constexpr bool __is_negative(T, std::false_type /*signed*/) {
+   return false;
+}
+
+template <typename L, typename R>
+bool __equal_value(const L &lhs, const R &rhs, std::false_type /*integral*/) {
+   return lhs == rhs;
+}
+
+// integers compare by value: `TEST_CHECK_EQUAL(-1, v.size())` fails instead of comparing
+// SIZE_MAX, and `TEST_CHECK_EQUAL(1, v.size())` doesn't warn about the signedness
+template <typename L, typename R>
+bool __equal_value(L lhs, R rhs, std::true_type /*integral*/) {
+   using common_t = std::common_type_t<L, R>;
+   return __is_negative(lhs, std::is_signed<L>{}) ==
+             __is_negative(rhs, std::is_signed<R>{}) &&
+          static_cast<common_t>(lhs) == static_cast<common_t>(rhs);
+}
+
+template <typename L, typename R>
+bool __equal(const L &lhs, const R &rhs, std::true_type /*has ==*/) {
+   return __equal_value(lhs, rhs, __both_integral_t<L, R>{});
+}
+
+template <typename T>
+bool __equal(const T &lhs, const T &rhs, std::false_type /*has ==*/) {
+   static_assert(DDS_MPL_NAMESPACE::is_reflectable_t<T>::value,
+                 "Values have no operator== and they are not aggregates");
+   constexpr auto count = static_cast<int>(DDS_MPL_NAMESPACE::field_count_t<T>::value);
+   bool ret = true;
+   DDS_MPL_NAMESPACE::static_for<0, count>([&](auto i) {
+      constexpr auto index = decltype(i)::value;
+      ret = ret && __equal(DDS_MPL_NAMESPACE::get_field<index>(lhs),
+                           DDS_MPL_NAMESPACE::get_field<index>(rhs));
+   });
+   return ret;
+}
+
+/*
+ * Equality checked by TEST_CHECK_EQUAL: operator== when there is one, aggregates without
+ * it are equal when all their fields are.
+ */
+template <typename L, typename R>
+bool __equal(const L &lhs, const R &rhs) {
+   return __equal(lhs, rhs, __has_equal_t<L, R>{});
+}
+
+// `path` of a field is empty for the values themselves
+template <typename L, typename R>
+void __write_difference(std::ostream &strm,
+                        const String &path,
+                        const L &lhs,
+                        const R &rhs,
+                        std::true_type /*has ==*/) {
+   if (!path.empty()) {
+      strm << "field " << path << ": ";
+   }
+   strm << '`';
+   print_detail::write_value(strm, lhs);
+   strm << "` != `";
+   print_detail::write_value(strm, rhs);
+   strm << '`';
+}
+
+// only the fields which differ, a nested one by its path: "field 1.0: `2` != `3`"
+template <typename T>
+void __write_difference(std::ostream &strm,
+                        const String &path,
+                        const T &lhs,
+                        const T &rhs,
+                        std::false_type /*has ==*/) {
+   constexpr auto count = static_cast<int>(DDS_MPL_NAMESPACE::field_count_t<T>::value);
+   bool first = true;
+   DDS_MPL_NAMESPACE::static_for<0, count>([&](auto i) {
+      constexpr auto index = decltype(i)::value;
+      const auto &l = DDS_MPL_NAMESPACE::get_field<index>(lhs);
+      const auto &r = DDS_MPL_NAMESPACE::get_field<index>(rhs);
+      if (__equal(l, r)) {
+         return;
+      }
+      if (!first) {
+         strm << ", ";
+      }
+      first = false;
+      using field_t = std::decay_t<decltype(l)>;
+      auto field = (path.empty() ? path : path + ".") + std::to_string(index);
+      __write_difference(strm, field, l, r, __has_equal_t<field_t, field_t>{});
+   });
+}
+
+template <typename L, typename R>
+void __check_equal_failed(const __config_t &cfg,
+                          __test_result_t &result,
+                          bool stop_on_error,
+                          const char *file,
+                          int line,
+                          const char *what,
+                          const L &lhs,
+                          const R &rhs) {
+   std::stringstream strm;
+   strm << what << "[";
+   __write_difference(strm, String{}, lhs, rhs, __has_equal_t<L, R>{});
+   strm << "]";
+   __check_failed(cfg, result, stop_on_error, file, line, strm.str());
+}
+
+/*
+ * Check done at the end of TEST_CHECK_ALLOCS_AT_MOST scope.
+ */
+inline void __check_alloc_scope(const __config_t &cfg,
+                                __test_result_t &result,
+                                const __alloc_scope_t &scope,
+                                const char *file,
+                                int line) {
+   if (!__alloc_tracking_enabled()) {
+      __check_failed(cfg,
+                     result,
+                     false,
+                     file,
+                     line,
+                     "allocation check needs DDS_TINYTEST_TRACK_ALLOCS defined");
+      return;
+   }
+   auto allocations = scope.allocations();
+   if (allocations > scope.limit) {
+      __check_failed(cfg,
+                     result,
+                     false,
+                     file,
+                     line,
+                     std::to_string(allocations) + " allocations in scope (at most " +
+                        std::to_string(scope.limit) + " allowed)");
+      return;
+   }
+   ++result.checks;
+   if (result.notify_passed) {
+      __check_passed(cfg, result, "Ok: allocations in scope are within limit");
+   }
+}
+
+using __bench_fn_t = void (*)(const __config_t &, __test_result_t &, __bench_state_t &);
+
+/*
+ * Run benchmark `body(cfg, result, state)` and report its statistics. Checks of the body
+ * are counted and logged for its first call only. Later calls (calibration, warm-up and
+ * samples) check quietly, their first failure is reported if the first call passed.
+ */
+inline void __run_benchmark(const __config_t &cfg,
+                            __test_result_t &result,
+                            __bench_fn_t body) {
+   __config_t quiet; // passed checks of later calls are not traced
+   __test_result_t repeated;
+   repeated.test = result.test;
+   String repeated_log;
+   bool first = true;
+   __bench_stats_t stats;
+   auto measured = __measure_benchmark(
+      [&](__bench_state_t &state) {
+         if (first) {
+            first = false;
+            body(cfg, result, state);
+            return;
+         }
+         auto *log = __thread_log();
+         __thread_log() = &repeated_log;
+         body(quiet, repeated, state);
+         __thread_log() = log;
+         repeated.info.clear();
+         repeated.notify_passed = false;
+      },
+      cfg.bench_options,
+      stats);
+   if (repeated.errors && !result.errors) {
+      // only the first failure with its context
+      auto begin = std::min(repeated_log.find("   Failed in context:"),
+                            repeated_log.find("[error]"));
+      auto end = repeated_log.find('\n', repeated_log.find("[error]"));
+      ++result.errors;
+      cfg.trace(__config_t::ERROR, repeated_log.substr(begin, end - begin));
+   }
+   auto name = result.test->full_name();
+   if (!measured) {
+      if (!result.errors) {
+         ++result.errors;
+         cfg.trace(__config_t::ERROR,
+                   "[error] Benchmark " + name + " doesn't use TEST_BENCHMARK_LOOP");
+      }
+      return;
+   }
+   cfg.report_benchmark(name, stats);
+   result.bench = std::move(stats);
+}
+
 /*
  * This line defines a `int main()` function and should be used only once for binary.
  * When used is should be the first macro used from test file.
@@ -196,6 +970,7 @@ struct __add_test_t {
       static ::DDS_ROOT_NAMESPACE::DDS_TINYTEST_NAMESPACE::__config_t scfg;              \
       return scfg;                                                                       \
    }                                                                                     \
+   TEST_BASE_ALLOC_TRACKING()                                                            \
    int main(int argc, char **argv) {                                                     \
       auto &__cfg = ::DDS_ROOT_NAMESPACE::DDS_TINYTEST_NAMESPACE::__get_config();        \
       if (!__cfg.parse_args(argc, argv)) {                                               \
@@ -205,24 +980,78 @@ struct __add_test_t {
          ::DDS_ROOT_NAMESPACE::DDS_TINYTEST_NAMESPACE::__get_sobject());                 \
    }
 
+/*
+ * Internal defined used from this framework: replacement of the global operator
+ * new/delete, expanded by TESTS_BEGIN() when DDS_TINYTEST_TRACK_ALLOCS is defined.
+ */
+#ifdef DDS_TINYTEST_TRACK_ALLOCS
+#define TEST_BASE_ALLOC_TRACKING()                                                       \
+   void *operator new(std::size_t size) {                                                \
+      auto *ptr = ::DDS_ROOT_NAMESPACE::DDS_TINYTEST_NAMESPACE::__tracked_alloc(size);   \
+      if (!ptr) {                                                                        \
+         throw std::bad_alloc{};                                                         \
+      }                                                                                  \
+      return ptr;                                                                        \
+   }                                                                                     \
+   void *operator new[](std::size_t size) { return operator new(size); }                 \
+   void *operator new(std::size_t size, const std::nothrow_t &) noexcept {               \
+      return ::DDS_ROOT_NAMESPACE::DDS_TINYTEST_NAMESPACE::__tracked_alloc(size);        \
+   }                                                                                     \
+   void *operator new[](std::size_t size, const std::nothrow_t &) noexcept {             \
+      return ::DDS_ROOT_NAMESPACE::DDS_TINYTEST_NAMESPACE::__tracked_alloc(size);        \
+   }                                                                                     \
+   void operator delete(void *ptr) noexcept {                                            \
+      ::DDS_ROOT_NAMESPACE::DDS_TINYTEST_NAMESPACE::__tracked_free(ptr);                 \
+   }                                                                                     \
+   void operator delete[](void *ptr) noexcept { operator delete(ptr); }                  \
+   void operator delete(void *ptr, std::size_t) noexcept { operator delete(ptr); }       \
+   void operator delete[](void *ptr, std::size_t) noexcept { operator delete(ptr); }     \
+   void operator delete(void *ptr, const std::nothrow_t &) noexcept {                    \
+      operator delete(ptr);                                                              \
+   }                                                                                     \
+   void operator delete[](void *ptr, const std::nothrow_t &) noexcept {                  \
+      operator delete(ptr);                                                              \
+   }                                                                                     \
+   static const bool __tiny_test_alloc_tracking =                                        \
+      ::DDS_ROOT_NAMESPACE::DDS_TINYTEST_NAMESPACE::__alloc_tracking_enabled() = true;
+#else
+#define TEST_BASE_ALLOC_TRACKING()
+#endif
+
 /*
  * Begin test suite with given `name`
  * used to group test cases.
  * Test cases with same names can appear if they are in different suites.
  */
-#define TEST_SUITE_BEGIN(name)                                                           \
+#define TEST_SUITE_BEGIN(name) TEST_BASE_SUITE_BEGIN(name, false)
+
+/*
+ * Same as TEST_SUITE_BEGIN, but test cases of this suite (including nested suites) are
+ * never executed in parallel with any other test case, even when `--jobs=N` is used.
+ */
+#define TEST_SUITE_SERIAL_BEGIN(name) TEST_BASE_SUITE_BEGIN(name, true)
+
+/*
+ * Internal defined used from this framework. Suite node is linked to the enclosing suite
+ * found by name lookup of `__tiny_test_suite`, before it is redeclared in the new scope.
+ */
+#define TEST_BASE_SUITE_BEGIN(name, serial)                                              \
    namespace name {                                                                      \
-   static ::DDS_ROOT_NAMESPACE::DDS_TINYTEST_NAMESPACE::__add_remove_suite_t             \
-      __suite_##name{::DDS_ROOT_NAMESPACE::DDS_TINYTEST_NAMESPACE::__get_sobject(),      \
-                     #name};
+   static constexpr ::DDS_ROOT_NAMESPACE::DDS_TINYTEST_NAMESPACE::__suite_node_t         \
+      __tiny_test_suite_node{#name, serial, __tiny_test_suite};                          \
+   static constexpr const ::DDS_ROOT_NAMESPACE::DDS_TINYTEST_NAMESPACE::__suite_node_t   \
+      *__tiny_test_suite = &__tiny_test_suite_node;
 
 /*
  * end of current suite
  */
-#define TEST_SUITE_END()                                                                 \
-   static ::DDS_ROOT_NAMESPACE::DDS_TINYTEST_NAMESPACE::__add_remove_suite_t             \
-      __suite_end_##name{::DDS_ROOT_NAMESPACE::DDS_TINYTEST_NAMESPACE::__get_sobject()}; \
-   }
+#define TEST_SUITE_END() }
+
+/*
+ * Internal defined used from this framework: `void` return type of a test case, which
+ * uses `__cfg` and `__result`, so there are no warnings when the body doesn't use them.
+ */
+#define TEST_BASE_USE_ARGS() decltype((void)__cfg, (void)__result)
 
 /*
  * define a test case with `name`.
@@ -230,55 +1059,71 @@ struct __add_test_t {
  * TEST_REQUIRE, TEST_CHECK_EQUAL, etc ...
  */
 #define TEST_CASE(name)                                                                  \
-   struct __type_case_##name {                                                           \
-      __type_case_##name(                                                                \
-         const ::DDS_ROOT_NAMESPACE::DDS_TINYTEST_NAMESPACE::__static_test_object_t      \
-            &obj) {                                                                      \
-         ::DDS_ROOT_NAMESPACE::String calc;                                              \
-         for (const auto &suite : obj.suites) {                                          \
-            calc += suite;                                                               \
-            calc += obj.test_separator;                                                  \
-         }                                                                               \
-         __test_name = calc + #name;                                                     \
-      }                                                                                  \
-      void operator()(const ::DDS_ROOT_NAMESPACE::DDS_TINYTEST_NAMESPACE::__config_t &,  \
-                      ::DDS_ROOT_NAMESPACE::DDS_TINYTEST_NAMESPACE::__test_report_cb_t); \
-      ::DDS_ROOT_NAMESPACE::String __test_name;                                          \
-      std::list<::DDS_ROOT_NAMESPACE::String> __list_info;                               \
-   };                                                                                    \
-   static ::DDS_ROOT_NAMESPACE::DDS_TINYTEST_NAMESPACE::__add_test_t case_##name{        \
-      ::DDS_ROOT_NAMESPACE::DDS_TINYTEST_NAMESPACE::__get_sobject(),                     \
-      __type_case_##name{                                                                \
-         ::DDS_ROOT_NAMESPACE::DDS_TINYTEST_NAMESPACE::__get_sobject()}};                \
-   void __type_case_##name::operator()(                                                  \
+   static void __test_fn_##name(                                                         \
+      const ::DDS_ROOT_NAMESPACE::DDS_TINYTEST_NAMESPACE::__config_t &,                  \
+      ::DDS_ROOT_NAMESPACE::DDS_TINYTEST_NAMESPACE::__test_result_t &);                  \
+   static ::DDS_ROOT_NAMESPACE::DDS_TINYTEST_NAMESPACE::__test_node_t case_##name{       \
+      __tiny_test_suite, #name, &__test_fn_##name};                                      \
+   static auto __test_fn_##name(                                                         \
+      const ::DDS_ROOT_NAMESPACE::DDS_TINYTEST_NAMESPACE::__config_t &__cfg,             \
+      ::DDS_ROOT_NAMESPACE::DDS_TINYTEST_NAMESPACE::__test_result_t &__result)           \
+      ->TEST_BASE_USE_ARGS()
+
+/*
+ * define a micro-benchmark with `name`. It is registered in the current suite as a test
+ * case, but it never runs in parallel with other test cases. Body is called several
+ * times and must contain TEST_BENCHMARK_LOOP { ... }, which is the measured code.
+ * Checks (TEST_CHECK, ...) can be used in the body too, they are counted once.
+ */
+#define TEST_BENCHMARK(name)                                                             \
+   static void __bench_fn_##name(                                                        \
+      const ::DDS_ROOT_NAMESPACE::DDS_TINYTEST_NAMESPACE::__config_t &,                  \
+      ::DDS_ROOT_NAMESPACE::DDS_TINYTEST_NAMESPACE::__test_result_t &,                   \
+      ::DDS_ROOT_NAMESPACE::DDS_TINYTEST_NAMESPACE::__bench_state_t &);                  \
+   static void __test_fn_##name(                                                         \
+      const ::DDS_ROOT_NAMESPACE::DDS_TINYTEST_NAMESPACE::__config_t &cfg,               \
+      ::DDS_ROOT_NAMESPACE::DDS_TINYTEST_NAMESPACE::__test_result_t &result) {           \
+      ::DDS_ROOT_NAMESPACE::DDS_TINYTEST_NAMESPACE::__run_benchmark(                     \
+         cfg, result, &__bench_fn_##name);                                               \
+   }                                                                                     \
+   static ::DDS_ROOT_NAMESPACE::DDS_TINYTEST_NAMESPACE::__test_node_t bench_##name{      \
+      __tiny_test_suite, #name, &__test_fn_##name, true};                                \
+   static auto __bench_fn_##name(                                                        \
       const ::DDS_ROOT_NAMESPACE::DDS_TINYTEST_NAMESPACE::__config_t &__cfg,             \
-      ::DDS_ROOT_NAMESPACE::DDS_TINYTEST_NAMESPACE::__test_report_cb_t __test_report_cb)
+      ::DDS_ROOT_NAMESPACE::DDS_TINYTEST_NAMESPACE::__test_result_t &__result,           \
+      ::DDS_ROOT_NAMESPACE::DDS_TINYTEST_NAMESPACE::__bench_state_t &__bench)            \
+      ->TEST_BASE_USE_ARGS()
+
+/*
+ * Measured loop of TEST_BENCHMARK. Its body is run as many times as the framework needs.
+ */
+#define TEST_BENCHMARK_LOOP for (auto __bench_iteration : __bench)
+
+/*
+ * Number of items/bytes processed by one iteration of TEST_BENCHMARK_LOOP, used to
+ * report the throughput.
+ */
+#define TEST_BENCHMARK_ITEMS(n) __bench.items_per_iteration = static_cast<double>(n);
+#define TEST_BENCHMARK_BYTES(n) __bench.bytes_per_iteration = static_cast<double>(n);
 
 /*
  * Internal defined used from this framework
  */
 #define TEST_BASE_CHECK(stop_on_error, expr)                                             \
-   if (expr) {                                                                           \
-      using namespace ::DDS_ROOT_NAMESPACE;                                              \
-      using namespace ::DDS_ROOT_NAMESPACE::DDS_TINYTEST_NAMESPACE;                      \
-      __test_report_cb(__check_ok);                                                      \
-      String __log = String{"Ok: '"} + #expr + String{"' passed"};                       \
-      __cfg.trace(__config_t::ALL, __log);                                               \
-      __list_info.clear();                                                               \
-   } else {                                                                              \
-      using namespace ::DDS_ROOT_NAMESPACE;                                              \
-      using namespace ::DDS_ROOT_NAMESPACE::DDS_TINYTEST_NAMESPACE;                      \
-      __test_report_cb(__check_err);                                                     \
-      String sExpr = String{"'"} + #expr + String{"'"};                                  \
-      std::stringstream __strm;                                                          \
-      __strm << "[error] " << (stop_on_error ? "(required check)" : "") << __test_name   \
-             << " File: " __FILE__ << ":" << __LINE__ << " " << sExpr << " failed";      \
-      String __log = __strm.str();                                                       \
-      for (const auto &info : __list_info) {                                             \
-         __cfg.trace(__config_t::ERROR, "   Failed in context:" + info);                 \
+   if (DdsLikely(expr)) {                                                                \
+      ++__result.checks;                                                                 \
+      if (DdsUnlikely(__result.notify_passed)) {                                         \
+         ::DDS_ROOT_NAMESPACE::DDS_TINYTEST_NAMESPACE::__check_passed(                   \
+            __cfg, __result, "Ok: '" #expr "' passed");                                  \
       }                                                                                  \
-      __list_info.clear();                                                               \
-      __cfg.trace(__config_t::ERROR, __log);                                             \
+   } else {                                                                              \
+      ::DDS_ROOT_NAMESPACE::DDS_TINYTEST_NAMESPACE::__check_failed(                      \
+         __cfg,                                                                          \
+         __result,                                                                       \
+         stop_on_error,                                                                  \
+         __FILE__,                                                                       \
+         __LINE__,                                                                       \
+         "'" #expr "' failed");                                                          \
       if (stop_on_error) {                                                               \
          return;                                                                         \
       }                                                                                  \
@@ -288,27 +1133,22 @@ struct __add_test_t {
  * Internal defined used from this framework
  */
 #define TEST_BASE_EQUAL(stop_on_error, lhs, rhs)                                         \
-   if (lhs == rhs) {                                                                     \
-      using namespace ::DDS_ROOT_NAMESPACE;                                              \
-      using namespace ::DDS_ROOT_NAMESPACE::DDS_TINYTEST_NAMESPACE;                      \
-      __test_report_cb(__check_ok);                                                      \
-      String __log = String{"Ok: '"} + #lhs + String{"="} + #rhs + String{"' passed"};   \
-      __cfg.trace(__config_t::ALL, __log);                                               \
-      __list_info.clear();                                                               \
-   } else {                                                                              \
-      using namespace ::DDS_ROOT_NAMESPACE;                                              \
-      using namespace ::DDS_ROOT_NAMESPACE::DDS_TINYTEST_NAMESPACE;                      \
-      __test_report_cb(__check_err);                                                     \
-      std::stringstream __strm;                                                          \
-      __strm << "[error] " << (stop_on_error ? "(required check)" : "") << __test_name   \
-             << " File: " __FILE__ << ":" << __LINE__ << " " #lhs "==" #rhs " (failed)"  \
-             << "[`" << lhs << "` != `" << rhs << "`]";                                  \
-      String __log = __strm.str();                                                       \
-      for (const auto &info : __list_info) {                                             \
-         __cfg.trace(__config_t::ERROR, "   Failed in context:" + info);                 \
+   if (DdsLikely(::DDS_ROOT_NAMESPACE::DDS_TINYTEST_NAMESPACE::__equal(lhs, rhs))) {     \
+      ++__result.checks;                                                                 \
+      if (DdsUnlikely(__result.notify_passed)) {                                         \
+         ::DDS_ROOT_NAMESPACE::DDS_TINYTEST_NAMESPACE::__check_passed(                   \
+            __cfg, __result, "Ok: '" #lhs "=" #rhs "' passed");                          \
       }                                                                                  \
-      __list_info.clear();                                                               \
-      __cfg.trace(__config_t::ERROR, __log);                                             \
+   } else {                                                                              \
+      ::DDS_ROOT_NAMESPACE::DDS_TINYTEST_NAMESPACE::__check_equal_failed(                \
+         __cfg,                                                                          \
+         __result,                                                                       \
+         stop_on_error,                                                                  \
+         __FILE__,                                                                       \
+         __LINE__,                                                                       \
+         #lhs "==" #rhs " (failed)",                                                     \
+         lhs,                                                                            \
+         rhs);                                                                           \
       if (stop_on_error) {                                                               \
          return;                                                                         \
       }                                                                                  \
@@ -343,6 +1183,21 @@ struct __add_test_t {
  */
 #define TEST_REQUIRE_EQUAL(lhs, rhs) TEST_BASE_EQUAL(true, lhs, rhs)
 
+/*
+ * Check that the following block (`TEST_CHECK_ALLOCS_AT_MOST(n) { ... }`) does at most
+ * `n` heap allocations on the current thread. Requires DDS_TINYTEST_TRACK_ALLOCS.
+ */
+#define TEST_CHECK_ALLOCS_AT_MOST(n)                                                     \
+   for (::DDS_ROOT_NAMESPACE::DDS_TINYTEST_NAMESPACE::__alloc_scope_t __alloc_scope{n};  \
+        __alloc_scope.enter();                                                           \
+        ::DDS_ROOT_NAMESPACE::DDS_TINYTEST_NAMESPACE::__check_alloc_scope(               \
+           __cfg, __result, __alloc_scope, __FILE__, __LINE__))
+
+/*
+ * Check that the following block (`TEST_CHECK_NO_ALLOC { ... }`) doesn't allocate.
+ */
+#define TEST_CHECK_NO_ALLOC TEST_CHECK_ALLOCS_AT_MOST(0)
+
 /*
  * this will print `msg` if `value` of log_level=<value> is greater or equal to message
  */
@@ -354,7 +1209,15 @@ struct __add_test_t {
  * passed `msg` will be printed if next check (TEST_CHECK, TEST_CHECK_EQUAL, ...) fails.
  * Every check will reset info.
  */
-#define TEST_INFO(msg) __list_info.emplace_back(msg);
+#define TEST_INFO(msg)                                                                   \
+   do {                                                                                  \
+      __result.info.emplace_back(msg);                                                   \
+      __result.notify_passed = true;                                                     \
+   } while (0)
 
 } // namespace DDS_TINYTEST_NAMESPACE
 } // namespace DDS_ROOT_NAMESPACE
+
+// suite of test cases defined outside of TEST_SUITE_BEGIN/TEST_SUITE_END
+static constexpr const ::DDS_ROOT_NAMESPACE::DDS_TINYTEST_NAMESPACE::__suite_node_t
+   *__tiny_test_suite = nullptr;
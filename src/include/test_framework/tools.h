@@ -1,9 +1,18 @@
 #pragma once
 
+#include <atomic>
+#include <cstddef>
 #include <initializer_list>
 #include <iostream>
+#include <mutex>
 #include <ostream>
+#include <streambuf>
 #include <string>
+#include <type_traits>
+
+#include <mpl/for_each_field.h>
+#include <test_framework/log_sink.h>
+#include <test_framework/number_format.h>
 
 #define PRINT_SEPARATOR ' '
 
@@ -19,71 +28,305 @@ struct StreamGetter<std::ostream> {
 
 using OstreamGetter = StreamGetter<std::ostream>;
 
+namespace print_detail {
+
+template <typename T>
+constexpr bool is_char_type() {
+   return std::is_same<T, char>::value || std::is_same<T, signed char>::value ||
+          std::is_same<T, unsigned char>::value || std::is_same<T, wchar_t>::value ||
+          std::is_same<T, char16_t>::value || std::is_same<T, char32_t>::value;
+}
+
+// formatted by number_format.h, bool and character types stay with iostream
+template <typename T>
+constexpr bool is_fast_number() {
+   return (std::is_integral<T>::value && !std::is_same<T, bool>::value &&
+           !is_char_type<T>()) ||
+          std::is_same<T, float>::value || std::is_same<T, double>::value;
+}
+
+/*
+ * Numbers bypass iostream only while it would print them the default way: decimal
+ * without width, and floating point with the default precision (which is replaced by
+ * the shortest round-trip digits). Locale of the stream is not applied to them.
+ */
+inline bool default_number_format(const std::ostream &out, bool floating) {
+   const auto custom = std::ios_base::showpos | std::ios_base::showpoint |
+                       std::ios_base::uppercase | std::ios_base::floatfield |
+                       std::ios_base::oct | std::ios_base::hex;
+   return !(out.flags() & custom) && !out.width() &&
+          (!floating || 6 == out.precision()) && out.rdbuf();
+}
+
+template <typename T>
+char *format_number(char *buf, T value, std::true_type /*floating*/) {
+   return format_shortest(buf, value);
+}
+
+template <typename T>
+char *format_number(char *buf, T value, std::false_type /*floating*/) {
+   return format_integer(buf, value);
+}
+
+template <typename Out, typename T, typename = void>
+struct is_streamable_t : std::false_type {};
+
+template <typename Out, typename T>
+struct is_streamable_t<Out, T, decltype(void(std::declval<Out &>() << std::declval<T>()))>
+   : std::true_type {};
+
+template <typename Out, typename T>
+void put(Out &out, T &&arg);
+
+template <typename Out, typename T>
+void write_value(Out &out, T &&arg, std::true_type /*streamable*/) {
+   out << static_cast<T &&>(arg);
+}
+
+// aggregate without operator<< is printed field by field: `{1, text, {2, 3}}`
+template <typename Out, typename T>
+void write_value(Out &out, const T &arg, std::false_type /*streamable*/) {
+   static_assert(DDS_ROOT_NAMESPACE::DDS_MPL_NAMESPACE::is_reflectable_t<T>::value,
+                 "Value has no operator<< and it is not an aggregate");
+   out << '{';
+   bool first = true;
+   DDS_ROOT_NAMESPACE::DDS_MPL_NAMESPACE::for_each_field(arg, [&](const auto &field) {
+      if (!first) {
+         out << ", ";
+      }
+      first = false;
+      put(out, field);
+   });
+   out << '}';
+}
+
+// `out << arg` when there is one, fields of an aggregate otherwise
+template <typename Out, typename T>
+void write_value(Out &out, const T &arg) {
+   write_value(out, arg, is_streamable_t<Out, const T &>{});
+}
+
+template <typename Out, typename T>
+void put(Out &out, T &&arg, std::false_type /*fast*/) {
+   write_value(out, static_cast<T &&>(arg), is_streamable_t<Out, T &&>{});
+}
+
+template <typename Out, typename T>
+void put(Out &out, T value, std::true_type /*fast*/) {
+   using floating = std::is_floating_point<T>;
+   if (!default_number_format(out, floating::value)) {
+      out << value;
+      return;
+   }
+   char buf[max_number_chars];
+   auto size = format_number(buf, value, floating{}) - buf;
+   if (out.rdbuf()->sputn(buf, size) != size) {
+      out.setstate(std::ios_base::badbit);
+   }
+}
+
+template <typename Out, typename T>
+void put(Out &out, T &&arg) {
+   using fast = std::integral_constant<bool,
+                                       std::is_base_of<std::ostream, Out>::value &&
+                                          is_fast_number<std::decay_t<T>>()>;
+   put(out, static_cast<T &&>(arg), fast{});
+}
+
+} // namespace print_detail
+
 template <typename Stream>
 struct PrintBaseT {
    constexpr PrintBaseT(char sep_ = PRINT_SEPARATOR)
       : sep{sep_} {}
 
-   void static call(char /*separator*/) {}
+   template <typename... Ts>
+   static void call(char sep, Ts &&... args) {
+      write(Stream::GetStream(), sep, static_cast<Ts &&>(args)...);
+   }
+
+   // write `args` separated with `sep` to `out`
+   template <typename Out>
+   static void write(Out &, char) {}
 
-   template <typename T>
-   static void call(char sep, T &&arg) {
-      Stream::GetStream() << static_cast<T &&>(arg);
+   template <typename Out, typename T, typename... Ts>
+   static void write(Out &out, char sep, T &&arg, Ts &&... args) {
+      (void)sep; // unused for a single argument
+      print_detail::put(out, static_cast<T &&>(arg));
+      (void)std::initializer_list<int>{
+         ((out << sep, print_detail::put(out, static_cast<Ts &&>(args))), 0)...};
    }
 
-   template <typename T1, typename T2>
-   static void call(char sep, T1 &&a1, T2 &&a2) {
-      Stream::GetStream() << static_cast<T1 &&>(a1) << sep << static_cast<T2 &&>(a2);
+   template <typename... Ts>
+   void operator()(Ts &&... args) const {
+      call(sep, static_cast<Ts &&>(args)...);
    }
 
-   template <typename T1, typename T2, typename T3>
-   static void call(char sep, T1 &&a1, T2 &&a2, T3 &&a3) {
-      Stream::GetStream() << static_cast<T1 &&>(a1) << sep << static_cast<T2 &&>(a2)
-                          << sep << static_cast<T3 &&>(a3);
+   char sep = PRINT_SEPARATOR;
+};
+
+using PrintT = PrintBaseT<OstreamGetter>;
+
+constexpr PrintT print{};
+
+/*
+ * When lines printed with println are flushed to the output.
+ */
+enum class PrintFlushPolicy {
+   EveryLine, // flush after every line
+   WhenFull,  // flush when the output buffer is full (and at exit)
+};
+
+inline std::atomic<PrintFlushPolicy> &print_flush_policy() {
+   static std::atomic<PrintFlushPolicy> policy{PrintFlushPolicy::WhenFull};
+   return policy;
+}
+
+/*
+ * Line of println is formatted in a thread-local buffer first, so it is passed to the
+ * output in a single call and lines from different threads are never mixed.
+ */
+class LineBuffer : public std::streambuf {
+public:
+   const char *data() const { return line.data(); }
+   std::size_t size() const { return line.size(); }
+   void clear() { line.clear(); } // keeps the capacity for the next line
+
+protected:
+   int_type overflow(int_type ch) override {
+      if (!traits_type::eq_int_type(ch, traits_type::eof())) {
+         line.push_back(traits_type::to_char_type(ch));
+      }
+      return traits_type::not_eof(ch);
    }
 
-   template <typename T1, typename T2, typename T3, typename T4>
-   static void call(char sep, T1 &&a1, T2 &&a2, T3 &&a3, T4 &&a4) {
-      Stream::GetStream() << static_cast<T1 &&>(a1) << sep << static_cast<T2 &&>(a2)
-                          << sep << static_cast<T3 &&>(a3) << sep
-                          << static_cast<T4 &&>(a4);
+   std::streamsize xsputn(const char *s, std::streamsize n) override {
+      line.append(s, static_cast<std::size_t>(n));
+      return n;
    }
 
-   template <typename T1, typename T2, typename T3, typename T4, typename T5>
-   static void call(char sep, T1 &&a1, T2 &&a2, T3 &&a3, T4 &&a4, T5 &&a5) {
-      Stream::GetStream() << static_cast<T1 &&>(a1) << sep << static_cast<T2 &&>(a2)
-                          << sep << static_cast<T3 &&>(a3) << sep
-                          << static_cast<T4 &&>(a4) << sep << static_cast<T5 &&>(a5);
+private:
+   std::string line;
+};
+
+struct LineStream {
+   LineBuffer buffer;
+   std::ostream stream{&buffer};
+   bool busy{};
+};
+
+/*
+ * Thread-local line stream. A nested println (from `operator<<` of a printed argument)
+ * gets its own stream, so it doesn't break the outer line. The line is formatted like
+ * `target` (flags, precision, fill, locale) and takes its pending width, as if it was
+ * printed to `target` directly. Without a target it has the default format.
+ */
+class LineStreamGuard {
+public:
+   LineStreamGuard()
+      : LineStreamGuard{default_format()} {}
+
+   explicit LineStreamGuard(std::ostream &target)
+      : line{acquire()} {
+      auto &stream = line->stream;
+      stream.flags(target.flags());
+      stream.precision(target.precision());
+      stream.fill(target.fill());
+      stream.width(target.width(0));
+      if (stream.getloc() != target.getloc()) {
+         stream.imbue(target.getloc());
+      }
    }
 
-   template <typename T1,
-             typename T2,
-             typename T3,
-             typename T4,
-             typename T5,
-             typename... Ts>
-   static void
-   call(char sep, T1 &&a1, T2 &&a2, T3 &&a3, T4 &&a4, T5 &&a5, Ts &&... args) {
-      Stream::GetStream() << static_cast<T1 &&>(a1) << sep << static_cast<T2 &&>(a2)
-                          << sep << static_cast<T3 &&>(a3) << sep
-                          << static_cast<T4 &&>(a4) << sep << static_cast<T5 &&>(a5);
-      if (sizeof...(args)) {
-         Stream::GetStream() << sep;
-         call(sep, args...);
+   ~LineStreamGuard() {
+      line->buffer.clear();
+      if (line == &ThreadLineStream()) {
+         line->busy = false;
+      } else {
+         delete line;
       }
    }
 
-   template <typename... Ts>
-   void operator()(Ts &&... args) const {
-      call(sep, static_cast<Ts &&>(args)...);
+   LineStreamGuard(const LineStreamGuard &) = delete;
+   LineStreamGuard &operator=(const LineStreamGuard &) = delete;
+
+   std::ostream &stream() { return line->stream; }
+   const LineBuffer &buffer() const { return line->buffer; }
+
+private:
+   static std::ostream &default_format() {
+      static thread_local std::ostream format{nullptr};
+      return format;
    }
 
-   char sep = PRINT_SEPARATOR;
+   static LineStream &ThreadLineStream() {
+      static thread_local LineStream stream;
+      return stream;
+   }
+
+   static LineStream *acquire() {
+      auto &own = ThreadLineStream();
+      if (own.busy) {
+         return new LineStream;
+      }
+      own.busy = true;
+      return &own;
+   }
+
+   LineStream *line;
 };
 
-using PrintT = PrintBaseT<OstreamGetter>;
+/*
+ * Commits a complete line to the output of `Stream` in a single call.
+ */
+template <typename Stream>
+struct StreamLineSink {
+   static void commit(const char *data, std::size_t size) {
+      static std::mutex mtx;
+      std::lock_guard<std::mutex> lock{mtx};
+      auto &out = Stream::GetStream();
+      out.write(data, static_cast<std::streamsize>(size));
+      if (PrintFlushPolicy::EveryLine == print_flush_policy().load()) {
+         out.flush();
+      }
+   }
+};
 
-constexpr PrintT print{};
+template <typename Stream>
+struct LineSink : StreamLineSink<Stream> {};
+
+namespace print_detail {
+
+// lines of std::cout printed by the current thread are appended here when it is set
+inline std::string *&thread_capture() {
+   static thread_local std::string *capture{};
+   return capture;
+}
+
+} // namespace print_detail
+
+/*
+ * Lines of std::cout go to its current buffer (so its rdbuf() can be redirected), an
+ * installed LogSink takes them instead. Lines of a thread with a capture buffer are
+ * appended to it.
+ */
+template <>
+struct LineSink<OstreamGetter> {
+   static void commit(const char *data, std::size_t size) {
+      if (auto *capture = print_detail::thread_capture()) {
+         capture->append(data, size);
+         return;
+      }
+      if (auto *sink = print_detail::log_sink().load(std::memory_order_acquire)) {
+         sink->write(data, size);
+         if (PrintFlushPolicy::EveryLine == print_flush_policy().load()) {
+            sink->flush();
+         }
+         return;
+      }
+      StreamLineSink<OstreamGetter>::commit(data, size);
+   }
+};
 
 template <typename Stream>
 struct PrintBaseLnT {
@@ -93,8 +336,10 @@ struct PrintBaseLnT {
    template <typename... Ts>
    void operator()(Ts &&... args) const {
       if (sizeof...(args)) {
-         PrintBaseT<Stream>{sep}(std::forward<Ts>(args)...);
-         Stream::GetStream() << std::endl;
+         LineStreamGuard line{Stream::GetStream()};
+         PrintBaseT<Stream>::write(line.stream(), sep, static_cast<Ts &&>(args)...);
+         line.stream() << '\n';
+         LineSink<Stream>::commit(line.buffer().data(), line.buffer().size());
       }
    }
 
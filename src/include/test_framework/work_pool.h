@@ -0,0 +1,90 @@
+#pragma once
+
+#include <common/common.h>
+#include <common/function_ref.h>
+#include <test_framework/config.h>
+
+#include <cstddef>
+#include <deque>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+namespace DDS_ROOT_NAMESPACE {
+namespace DDS_TINYTEST_NAMESPACE {
+
+/*
+ * Minimal work-stealing pool used to execute test cases in parallel.
+ *
+ * Every worker owns a queue pre-filled with a contiguous range of task indices. It pops
+ * tasks from the front of its own queue and, once it runs dry, steals from the back of
+ * the other queues. No tasks are added after start, so a worker which finds every queue
+ * empty can exit.
+ */
+class __work_stealing_pool_t {
+public:
+   /*
+    * Call `task(index)` for every index in [0, count) using `jobs` threads.
+    * Returns when all tasks are finished.
+    */
+   static void run(std::size_t count,
+                   unsigned jobs,
+                   function_ref_t<void(std::size_t /*index*/)> task) {
+      if (jobs < 1) {
+         jobs = 1;
+      }
+      std::vector<queue_t> queues(jobs);
+      for (unsigned w = 0; w < jobs; ++w) {
+         auto begin = count * w / jobs;
+         auto end = count * (w + 1) / jobs;
+         for (auto i = begin; i < end; ++i) {
+            queues[w].tasks.push_back(i);
+         }
+      }
+
+      std::vector<std::thread> workers;
+      workers.reserve(jobs);
+      for (unsigned w = 0; w < jobs; ++w) {
+         workers.emplace_back([&queues, &task, w] {
+            std::size_t index{};
+            while (next(queues, w, index)) {
+               task(index);
+            }
+         });
+      }
+      for (auto &worker : workers) {
+         worker.join();
+      }
+   }
+
+private:
+   struct queue_t {
+      std::mutex mtx;
+      std::deque<std::size_t> tasks;
+   };
+
+   static bool next(std::vector<queue_t> &queues, unsigned self, std::size_t &index) {
+      {
+         auto &own = queues[self];
+         std::lock_guard<std::mutex> lock{own.mtx};
+         if (!own.tasks.empty()) {
+            index = own.tasks.front();
+            own.tasks.pop_front();
+            return true;
+         }
+      }
+      for (std::size_t i = 1; i < queues.size(); ++i) {
+         auto &victim = queues[(self + i) % queues.size()];
+         std::lock_guard<std::mutex> lock{victim.mtx};
+         if (!victim.tasks.empty()) {
+            index = victim.tasks.back();
+            victim.tasks.pop_back();
+            return true;
+         }
+      }
+      return false;
+   }
+};
+
+} // namespace DDS_TINYTEST_NAMESPACE
+} // namespace DDS_ROOT_NAMESPACE
@@ -0,0 +1,78 @@
+// replace operator new/delete of this binary to count allocations
+#define DDS_TINYTEST_TRACK_ALLOCS
+
+#include <test_framework/tiny_framework.h>
+
+#include <memory>
+#include <numeric>
+#include <vector>
+
+using namespace dds;
+using namespace dds::tiny_test;
+
+TESTS_BEGIN()
+
+TEST_SUITE_BEGIN(allocTrackerTests)
+
+TEST_CASE(enabled) { TEST_CHECK(__alloc_tracking_enabled()); }
+
+TEST_CASE(counters) {
+   __alloc_probe_t probe;
+   auto ptr = std::make_unique<char[]>(100);
+   auto stats = probe.stats();
+   TEST_CHECK_EQUAL(1u, stats.count);
+   TEST_CHECK_EQUAL(100u, stats.bytes);
+   TEST_CHECK_EQUAL(100u, stats.peak);
+
+   ptr.reset();
+   std::vector<int> v(10);
+   stats = probe.stats();
+   TEST_CHECK_EQUAL(2u, stats.count);
+   TEST_CHECK_EQUAL(100u + 10 * sizeof(int), stats.bytes);
+   // first block is already released when the vector is allocated
+   TEST_CHECK_EQUAL(100u, stats.peak);
+}
+
+TEST_CASE(noAlloc) {
+   std::vector<int> values(1000, 1);
+   int sum{};
+   TEST_CHECK_NO_ALLOC { sum = std::accumulate(values.begin(), values.end(), 0); }
+   TEST_CHECK_EQUAL(1000, sum);
+}
+
+TEST_CASE(allocsAtMost) {
+   TEST_CHECK_ALLOCS_AT_MOST(2) {
+      std::vector<int> v1(10);
+      std::vector<int> v2(v1);
+   }
+   TEST_CHECK_ALLOCS_AT_MOST(1) {
+      std::vector<int> v;
+      v.reserve(64);
+      for (int i = 0; i < 64; ++i) {
+         v.push_back(i);
+      }
+   }
+
+   // over the budget: reported to a local result instead of this test case
+   __test_result_t failing;
+   failing.test = __result.test;
+   String log;
+   {
+      __config_t __cfg;
+      auto &__result = failing;
+      auto *saved = __thread_log();
+      __thread_log() = &log;
+      TEST_CHECK_ALLOCS_AT_MOST(1) {
+         std::vector<int> v1(10);
+         std::vector<int> v2(v1);
+         std::vector<int> v3(v2);
+      }
+      __thread_log() = saved;
+   }
+   TEST_CHECK_EQUAL(1u, failing.errors);
+   TEST_CHECK_EQUAL(0u, failing.checks);
+   TEST_CHECK(log.find("[error] allocTrackerTests/allocsAtMost") != String::npos);
+   TEST_CHECK(log.find("3 allocations in scope (at most 1 allowed)") != String::npos);
+}
+
+TEST_SUITE_END() // allocTrackerTests
@@ -0,0 +1,134 @@
+#include <test_framework/tiny_framework.h>
+
+#include <cmath>
+#include <string>
+
+using namespace dds;
+using namespace dds::tiny_test;
+
+TESTS_BEGIN();
+
+static bool near(double expected, double value, double tolerance) {
+   return std::fabs(expected - value) < tolerance;
+}
+
+static int body_calls;
+
+static void checked_body(const __config_t &__cfg,
+                         __test_result_t &__result,
+                         __bench_state_t &__bench) {
+   ++body_calls;
+   TEST_CHECK(body_calls > 0);
+   TEST_BENCHMARK_LOOP {}
+}
+
+static void failing_later_body(const __config_t &__cfg,
+                               __test_result_t &__result,
+                               __bench_state_t &__bench) {
+   ++body_calls;
+   TEST_INFO("call " + std::to_string(body_calls));
+   TEST_CHECK(body_calls == 1);
+   TEST_BENCHMARK_LOOP {}
+}
+
+// runs `body` as a benchmark of `test`, its output is returned
+static String run_benchmark(const __test_node_t *test,
+                            __bench_fn_t body,
+                            __test_result_t &result) {
+   __config_t cfg;
+   cfg.bench_options.samples = 3;
+   cfg.bench_options.sample_time = std::chrono::microseconds{10};
+   result.test = test;
+   body_calls = 0;
+   String log;
+   auto *saved = __thread_log();
+   __thread_log() = &log;
+   __run_benchmark(cfg, result, body);
+   __thread_log() = saved;
+   return log;
+}
+
+static std::size_t count(const String &text, const String &part) {
+   std::size_t ret{};
+   for (auto pos = text.find(part); pos != String::npos; pos = text.find(part, pos + 1)) {
+      ++ret;
+   }
+   return ret;
+}
+
+TEST_SUITE_BEGIN(benchStatsTests)
+
+TEST_CASE(incompleteBeta) {
+   TEST_CHECK_EQUAL(0.0, __incomplete_beta(2, 3, 0));
+   TEST_CHECK_EQUAL(1.0, __incomplete_beta(2, 3, 1));
+   // I_x(1, 1) = x, I_x(a, 1) = x^a, I_x(1, b) = 1 - (1 - x)^b
+   TEST_CHECK(near(0.3, __incomplete_beta(1, 1, 0.3), 1e-9));
+   TEST_CHECK(near(std::pow(0.4, 3), __incomplete_beta(3, 1, 0.4), 1e-9));
+   TEST_CHECK(near(1 - std::pow(0.8, 4), __incomplete_beta(1, 4, 0.2), 1e-9));
+   // symmetric around 0.5
+   TEST_CHECK(near(0.5, __incomplete_beta(7.5, 7.5, 0.5), 1e-9));
+   // binomial sum of 4 trials with at least 2 successes: 11 / 16
+   TEST_CHECK(near(0.6875, __incomplete_beta(2, 3, 0.5), 1e-9));
+   // both branches of the continued fraction: I_x(a, b) = 1 - I_(1-x)(b, a)
+   TEST_CHECK(near(1 - __incomplete_beta(3, 2, 0.1), __incomplete_beta(2, 3, 0.9), 1e-9));
+}
+
+TEST_CASE(studentQuantile) {
+   // two-sided 95% critical values of the t-distribution tables
+   TEST_CHECK(near(12.706, __student_t_quantile(0.975, 1), 1e-3));
+   TEST_CHECK(near(2.571, __student_t_quantile(0.975, 5), 1e-3));
+   TEST_CHECK(near(2.042, __student_t_quantile(0.975, 30), 1e-3));
+   TEST_CHECK(near(1.960, __student_t_quantile(0.975, 1e6), 1e-3));
+   TEST_CHECK(near(2.764, __student_t_quantile(0.99, 10), 1e-3));
+}
+
+TEST_CASE(welchCompare) {
+   // 10 samples each, standard error sqrt(0.8), 18 degrees of freedom with t = 2.101
+   __bench_summary_t baseline{10, 100, 2};
+   __bench_compare_t slower{baseline, {10, 108, 2}, 0.95};
+   TEST_CHECK(near(0.08, slower.change, 1e-12));
+   TEST_CHECK(near(0.0612, slower.low, 1e-4));
+   TEST_CHECK(near(0.0988, slower.high, 1e-4));
+   TEST_CHECK(slower.significant);
+   TEST_CHECK(slower.exceeds(0.05));
+   TEST_CHECK(!slower.exceeds(0.10));
+
+   __bench_compare_t faster{baseline, {10, 92, 2}, 0.95};
+   TEST_CHECK(faster.significant);
+   TEST_CHECK(faster.high < 0);
+   TEST_CHECK(faster.exceeds(0.05));
+
+   // the same change with noisy samples isn't significant for any threshold
+   __bench_compare_t noisy{{10, 100, 20}, {10, 108, 20}, 0.95};
+   TEST_CHECK(near(0.08, noisy.change, 1e-12));
+   TEST_CHECK(noisy.low < 0 && noisy.high > 0);
+   TEST_CHECK(!noisy.significant);
+   TEST_CHECK(!noisy.exceeds(0));
+
+   // nothing to compare with
+   __bench_compare_t empty{{}, {10, 108, 2}, 0.95};
+   TEST_CHECK(!empty.significant);
+   TEST_CHECK_EQUAL(0.0, empty.change);
+}
+
+// body is called for calibration, warm-up and every sample, its checks count once
+TEST_CASE(checksCountedOnce) {
+   __test_result_t result;
+   auto log = run_benchmark(__result.test, &checked_body, result);
+   TEST_CHECK(body_calls >= 5);
+   TEST_CHECK_EQUAL(1u, result.checks);
+   TEST_CHECK_EQUAL(0u, result.errors);
+   TEST_CHECK_EQUAL(1u, count(log, "[bench] benchStatsTests/checksCountedOnce: 3 "));
+   TEST_CHECK_EQUAL(0u, count(log, "[error]"));
+
+   // a later call fails: its first failure is reported
+   __test_result_t failing;
+   log = run_benchmark(__result.test, &failing_later_body, failing);
+   TEST_CHECK_EQUAL(1u, failing.checks);
+   TEST_CHECK_EQUAL(1u, failing.errors);
+   TEST_CHECK_EQUAL(1u, count(log, "[error]"));
+   TEST_CHECK_EQUAL(1u, count(log, "Failed in context:call 2\n"));
+   TEST_CHECK_EQUAL(0u, count(log, "Failed in context:call 3"));
+}
+
+TEST_SUITE_END() // benchStatsTests
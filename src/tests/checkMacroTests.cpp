@@ -0,0 +1,123 @@
+// replace operator new/delete of this binary to count allocations
+#define DDS_TINYTEST_TRACK_ALLOCS
+
+#include <test_framework/tiny_framework.h>
+
+#include <string>
+
+using namespace dds;
+using namespace dds::tiny_test;
+
+TESTS_BEGIN()
+
+/*
+ * Checks run by `run` are reported to `result` and logged to `log` instead of the
+ * running test case, as if they were in a test case run at `level`.
+ */
+struct local_checks_t {
+   local_checks_t(const __test_node_t *test, __config_t::Level level) {
+      cfg.level = level;
+      result.test = test;
+      result.notify_passed = level >= __config_t::ALL;
+   }
+
+   template <typename Checks>
+   void run(Checks checks) {
+      auto *saved = __thread_log();
+      __thread_log() = &log;
+      checks(cfg, result);
+      __thread_log() = saved;
+   }
+
+   bool logged(const char *text) const { return log.find(text) != String::npos; }
+
+   __config_t cfg;
+   __test_result_t result;
+   String log;
+};
+
+TEST_SUITE_BEGIN(checkMacroTests)
+
+TEST_CASE(passedChecks) {
+   local_checks_t local{__result.test, __config_t::ERROR};
+   // passed checks only count, no message is built
+   TEST_CHECK_NO_ALLOC {
+      local.run([](const __config_t &__cfg, __test_result_t &__result) {
+         for (int i = 0; i < 1000; ++i) {
+            TEST_CHECK(i >= 0);
+            TEST_CHECK_EQUAL(i, i);
+            TEST_REQUIRE(i < 1000);
+            TEST_REQUIRE_EQUAL(i + 1, 1 + i);
+         }
+      });
+   }
+   TEST_CHECK_EQUAL(4000u, local.result.checks);
+   TEST_CHECK_EQUAL(0u, local.result.errors);
+   TEST_CHECK(local.log.empty());
+   TEST_CHECK(!local.result.notify_passed);
+}
+
+TEST_CASE(passedChecksTraced) {
+   local_checks_t local{__result.test, __config_t::ALL};
+   local.run([](const __config_t &__cfg, __test_result_t &__result) {
+      int value = 1;
+      TEST_CHECK(value > 0);
+      TEST_CHECK_EQUAL(value, 1);
+   });
+   TEST_CHECK_EQUAL(2u, local.result.checks);
+   TEST_CHECK(local.logged("Ok: 'value > 0' passed\n"));
+   TEST_CHECK(local.logged("Ok: 'value=1' passed\n"));
+}
+
+TEST_CASE(failedChecks) {
+   local_checks_t local{__result.test, __config_t::ERROR};
+   int after_require{};
+   local.run([&](const __config_t &__cfg, __test_result_t &__result) {
+      int value = 1;
+      TEST_CHECK(value < 0);
+      TEST_CHECK_EQUAL(2, value);
+      TEST_REQUIRE(value == 0);
+      ++after_require;
+   });
+   TEST_CHECK_EQUAL(0u, local.result.checks);
+   TEST_CHECK_EQUAL(3u, local.result.errors);
+   TEST_CHECK_EQUAL(0, after_require);
+   TEST_CHECK(local.logged("[error] checkMacroTests/failedChecks File: "));
+   TEST_CHECK(local.logged("'value < 0' failed\n"));
+   TEST_CHECK(local.logged("2==value (failed)[`2` != `1`]\n"));
+   TEST_CHECK(local.logged("[error] (required check)checkMacroTests/failedChecks"));
+}
+
+TEST_CASE(info) {
+   local_checks_t local{__result.test, __config_t::ERROR};
+   local.run([](const __config_t &__cfg, __test_result_t &__result) {
+      TEST_INFO("reset by the passed check");
+      TEST_CHECK(__result.notify_passed);
+      TEST_INFO("first");
+      TEST_INFO(std::string{"second"});
+      TEST_CHECK(false);
+      // context of a failed check is reported once
+      TEST_CHECK(false);
+   });
+   TEST_CHECK_EQUAL(1u, local.result.checks);
+   TEST_CHECK_EQUAL(2u, local.result.errors);
+   TEST_CHECK(!local.logged("reset by the passed check"));
+   TEST_CHECK(local.logged("   Failed in context:first\n   Failed in context:second\n"));
+   TEST_CHECK_EQUAL(local.log.find("context:first"), local.log.rfind("context:first"));
+   // back on the fast path
+   TEST_CHECK(!local.result.notify_passed);
+   TEST_CHECK(local.result.info.empty());
+}
+
+// TEST_INFO is one statement, so it can be a branch without braces
+TEST_CASE(singleStatement) {
+   int checks{};
+   for (int i = 0; i < 4; ++i)
+      if (i % 2)
+         TEST_INFO("odd");
+      else
+         ++checks;
+   TEST_CHECK_EQUAL(2, checks);
+}
+
+TEST_SUITE_END() // checkMacroTests
@@ -0,0 +1,92 @@
+#!/usr/bin/env bash
+
+# compile-time benchmark of N-way static branching: nested if_static against cond_static
+# and switch_static. Every variant selects one of N branches for each of N keys.
+# usage: compile-bench.sh [N...] (default 8 32 128)
+
+FULL_SCRIPT=`readlink -f $0`
+DIRNAME=`dirname $FULL_SCRIPT`
+
+cd $DIRNAME
+
+if [ -z $CXX ] ; then
+   CXX=g++
+fi
+
+INCLUDE="-I `pwd`/../include"
+
+SIZES=("$@")
+if [ ${#SIZES[@]} -eq 0 ]
+then
+   SIZES=(8 32 128)
+fi
+
+WORK_DIR=`mktemp -d`
+trap "rm -rf $WORK_DIR" EXIT
+
+# prints source selecting the branch of key K with expression $1
+generate() {
+   local N=$1
+   local EXPR=$2
+   echo "#include <mpl/cond_static.h>"
+   echo "#include <mpl/if_static.h>"
+   echo "#include <mpl/switch_static.h>"
+   echo "using namespace dds::mpl;"
+   echo "template <int I> struct branch_t { int operator()() const { return I; } };"
+   echo "template <int K> int select() { return $EXPR(); }"
+   echo "int main() {"
+   echo "   int sum = 0;"
+   for ((i = 0; i < N; i++)); do
+      echo "   sum += select<$i>();"
+   done
+   echo "   return sum;"
+   echo "}"
+}
+
+nested_if_static() {
+   local N=$1
+   local EXPR="branch_t<-1>{}"
+   for ((i = N - 1; i >= 0; i--)); do
+      EXPR="if_static(bool_t<K == $i>{}, branch_t<$i>{}, $EXPR)"
+   done
+   echo "$EXPR"
+}
+
+cond_static_expr() {
+   local N=$1
+   local EXPR="cond_static("
+   for ((i = 0; i < N; i++)); do
+      EXPR="${EXPR}bool_t<K == $i>{}, branch_t<$i>{}, "
+   done
+   echo "${EXPR}branch_t<-1>{})"
+}
+
+switch_static_expr() {
+   local N=$1
+   local EXPR="switch_static<K>("
+   for ((i = 0; i < N; i++)); do
+      EXPR="${EXPR}case_static<$i>(branch_t<$i>{}), "
+   done
+   echo "${EXPR}default_static(branch_t<-1>{}))"
+}
+
+BUILD_OK=0
+for N in "${SIZES[@]}"
+do
+   for VARIANT in nested_if_static cond_static_expr switch_static_expr
+   do
+      FILE=$WORK_DIR/${VARIANT}_$N.cpp
+      generate $N "`$VARIANT $N`" > $FILE
+      START=`date +%s%N`
+      $CXX -std=c++14 $INCLUDE -fsyntax-only $FILE
+      ret=$?
+      END=`date +%s%N`
+      if [ $ret -ne 0 ]
+      then
+         BUILD_OK=$ret
+      fi
+      printf "%-20s N=%-5s %6d ms\n" $VARIANT $N $(((END - START) / 1000000))
+   done
+done
+
+exit $BUILD_OK
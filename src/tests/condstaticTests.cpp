@@ -0,0 +1,108 @@
+#include <common/common.h>
+#include <mpl/cond_static.h>
+#include <test_framework/tiny_framework.h>
+
+using namespace dds;
+using namespace dds::mpl;
+
+TESTS_BEGIN()
+
+TEST_SUITE_BEGIN(condstaticTests)
+
+TEST_CASE(Basic) {
+   using namespace std::literals;
+   auto ret1 = cond_static(false_t{}, 1, true_t{}, "string value"s, 2.5);
+   static_assert(std::is_same<String, decltype(ret1)>::value, "Type mismatch");
+   TEST_CHECK_EQUAL("string value", ret1);
+
+   auto ret2 = cond_static(false_t{}, 1, false_t{}, "string value"s, 2.5);
+   static_assert(std::is_same<double, decltype(ret2)>::value, "Type mismatch");
+   TEST_CHECK_EQUAL(2.5, ret2);
+
+   // the first true predicate wins
+   auto ret3 = cond_static(true_t{}, 1, true_t{}, "string value"s, 2.5);
+   static_assert(std::is_same<int, decltype(ret3)>::value, "Type mismatch");
+   TEST_CHECK_EQUAL(1, ret3);
+
+   // only the default branch
+   TEST_CHECK_EQUAL(3, cond_static(3));
+}
+
+// predicates can be any type derived from bool_t
+template <typename T>
+static String type_name() {
+   auto name = cond_static(std::is_same<T, int>{},
+                           "int",
+                           std::is_floating_point<T>{},
+                           "floating point",
+                           std::is_pointer<T>{},
+                           "pointer",
+                           "other");
+   return name;
+}
+
+TEST_CASE(typeTraits) {
+   TEST_CHECK_EQUAL("int", type_name<int>());
+   TEST_CHECK_EQUAL("floating point", type_name<float>());
+   TEST_CHECK_EQUAL("pointer", type_name<char *>());
+   TEST_CHECK_EQUAL("other", type_name<String>());
+}
+
+// usage of cond_static to implement compile time branching over several types
+template <typename T>
+static String to_str(const T &t) {
+   auto strCb = [](const auto &s) { return s; };
+   auto charCb = [](const auto &c) { return String(1, c); };
+   auto otherCb = [](const auto &in) { return std::to_string(in); };
+   return cond_static(std::is_same<String, T>{},
+                      strCb,
+                      std::is_same<char, T>{},
+                      charCb,
+                      otherCb)(t);
+}
+
+TEST_CASE(sfinae) {
+   TEST_CHECK_EQUAL("value", to_str(String{"value"}));
+   TEST_CHECK_EQUAL("c", to_str('c'));
+   TEST_CHECK_EQUAL("42", to_str(42));
+}
+
+struct counts_t {
+   int copies{};
+   int moves{};
+};
+
+struct counted_t {
+   explicit counted_t(counts_t &counts_)
+      : counts{&counts_} {}
+   counted_t(const counted_t &other)
+      : counts{other.counts} {
+      ++counts->copies;
+   }
+   counted_t(counted_t &&other)
+      : counts{other.counts} {
+      ++counts->moves;
+   }
+
+   counts_t *counts;
+};
+
+TEST_CASE(forwarding) {
+   counts_t counts;
+   counted_t branch{counts};
+   using Ret = decltype(cond_static(false_t{}, 1, true_t{}, branch, 2));
+   static_assert(std::is_same<counted_t &, Ret>::value, "Type mismatch");
+   TEST_CHECK(&branch == &cond_static(false_t{}, 1, true_t{}, branch, 2));
+   auto moved = cond_static(false_t{}, 1, false_t{}, 2, counted_t{counts});
+   static_assert(std::is_same<counted_t, decltype(moved)>::value, "Type mismatch");
+   TEST_CHECK_EQUAL(0, counts.copies);
+   TEST_CHECK_EQUAL(1, counts.moves);
+}
+
+TEST_CASE(constexprContext) {
+   static_assert(2 == cond_static(false_t{}, 1, true_t{}, 2, 3), "");
+   static_assert(3 == cond_static(false_t{}, 1, false_t{}, 2, 3), "");
+   TEST_CHECK(true);
+}
+
+TEST_SUITE_END() // condstaticTests
@@ -0,0 +1,106 @@
+#include <test_framework/tiny_framework.h>
+
+#include <initializer_list>
+#include <iostream>
+#include <sstream>
+#include <string>
+#include <vector>
+
+using namespace dds;
+using namespace dds::tiny_test;
+
+TESTS_BEGIN();
+
+// parses `args` after the program name, the help printed on an error is in `help`
+static bool parse(__config_t &cfg,
+                  std::initializer_list<const char *> args,
+                  std::string *help = nullptr) {
+   std::vector<std::string> storage{"configTests"};
+   storage.insert(storage.end(), args.begin(), args.end());
+   std::vector<char *> argv;
+   for (auto &arg : storage) {
+      argv.push_back(&arg[0]);
+   }
+   std::stringstream err;
+   auto *saved = std::cerr.rdbuf(err.rdbuf());
+   bool ret = cfg.parse_args(static_cast<int>(argv.size()), argv.data());
+   std::cerr.rdbuf(saved);
+   if (help) {
+      *help = err.str();
+   }
+   return ret;
+}
+
+// --flush changes the policy of the whole binary, so cases must not run in parallel
+TEST_SUITE_SERIAL_BEGIN(configTests)
+
+TEST_CASE(defaults) {
+   __config_t cfg;
+   TEST_CHECK(parse(cfg, {}));
+   TEST_CHECK(__config_t::ERROR == cfg.level);
+   TEST_CHECK_EQUAL(1u, cfg.jobs);
+   TEST_CHECK(cfg.name_filter.empty());
+   TEST_CHECK(__config_t::BENCH_ALSO == cfg.bench);
+   TEST_CHECK_EQUAL(5u, cfg.slowest);
+   TEST_CHECK_EQUAL(0.05, cfg.regression_threshold);
+}
+
+TEST_CASE(validArgs) {
+   auto policy = print_flush_policy().load();
+   __config_t cfg;
+   std::string help;
+   TEST_CHECK(parse(cfg,
+                    {"--jobs=2",
+                     "--filter=a/*,-a/b",
+                     "--log_level=all",
+                     "--flush=line",
+                     "--regression-threshold=5",
+                     "--slowest=3",
+                     "--no-bench",
+                     "--list"},
+                    &help));
+   TEST_CHECK(help.empty());
+   TEST_CHECK_EQUAL(2u, cfg.jobs);
+   TEST_CHECK(__config_t::ALL == cfg.level);
+   TEST_CHECK(PrintFlushPolicy::EveryLine == print_flush_policy().load());
+   TEST_CHECK_EQUAL(0.05, cfg.regression_threshold);
+   TEST_CHECK_EQUAL(3u, cfg.slowest);
+   TEST_CHECK(__config_t::BENCH_NONE == cfg.bench);
+   TEST_CHECK(cfg.list);
+
+   StringView separator{"/"};
+   TEST_CHECK(cfg.name_filter.match("a/c", separator));
+   TEST_CHECK(!cfg.name_filter.match("a/b", separator));
+   TEST_CHECK(!cfg.name_filter.match("b/c", separator));
+
+   TEST_CHECK(parse(cfg, {"--flush=buffer", "--jobs=0"}));
+   TEST_CHECK(PrintFlushPolicy::WhenFull == print_flush_policy().load());
+   TEST_CHECK(cfg.jobs >= 1u);
+   print_flush_policy() = policy;
+}
+
+TEST_CASE(invalidArgs) {
+   for (auto *arg : {"--log_level=",
+                     "--log_level=none",
+                     "--slowest=x",
+                     "--jobs",
+                     "--jobs=",
+                     "--bogus",
+                     "--flush=always",
+                     "--regression-threshold=-1",
+                     "--help"}) {
+      TEST_INFO(arg);
+      __config_t cfg;
+      std::string help;
+      TEST_CHECK(!parse(cfg, {arg}, &help));
+      TEST_CHECK(help.find("Usage:") != std::string::npos);
+   }
+
+   // options before the invalid one are applied, the rest is not parsed
+   __config_t cfg;
+   TEST_CHECK(!parse(cfg, {"--slowest=7", "--bogus", "--jobs=4"}));
+   TEST_CHECK_EQUAL(7u, cfg.slowest);
+   TEST_CHECK_EQUAL(1u, cfg.jobs);
+}
+
+TEST_SUITE_END() // configTests
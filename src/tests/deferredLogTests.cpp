@@ -0,0 +1,290 @@
+#include <test_framework/tiny_framework.h>
+
+#include <cstdint>
+#include <cstring>
+#include <set>
+#include <sstream>
+#include <string>
+#include <thread>
+#include <vector>
+
+TESTS_BEGIN();
+
+static std::stringstream &StreamObject() {
+   static std::stringstream obj;
+   return obj;
+}
+
+static std::string get_string_and_reset() {
+   auto ret = StreamObject().str();
+   StreamObject().str("");
+   StreamObject().clear();
+   return ret;
+}
+
+template <>
+struct StreamGetter<std::stringstream> {
+   static auto &GetStream() { return StreamObject(); }
+};
+
+using StringStreamGetter = StreamGetter<std::stringstream>;
+
+constexpr PrintBaseLnT<StringStreamGetter> sprintln{};
+constexpr DeferredPrintBaseT<StringStreamGetter> deferred_sprint{};
+constexpr DeferredPrintBaseLnT<StringStreamGetter> deferred_sprintln{};
+
+// stream which discards the output
+class NullBuffer : public std::streambuf {
+protected:
+   int_type overflow(int_type ch) override { return traits_type::not_eof(ch); }
+   std::streamsize xsputn(const char *, std::streamsize n) override { return n; }
+};
+
+using print_detail::DeferredRing;
+
+// writes a record of `payload` bytes, returns false when the ring is full
+static bool write_record(DeferredRing &ring, std::size_t payload, char sep = 0) {
+   std::size_t size{};
+   auto *record = ring.try_reserve(payload, size);
+   if (!record) {
+      return false;
+   }
+   using Site = print_detail::DeferredSiteOf<StringStreamGetter, true>;
+   DeferredRing::Header header{static_cast<std::uint32_t>(size), sep, &Site::site};
+   std::memcpy(record, &header, sizeof(header));
+   ring.commit(size);
+   return true;
+}
+
+template <typename T>
+static void append(std::string &out, T value) {
+   out.append(reinterpret_cast<const char *>(&value), sizeof(value));
+}
+
+// binary log of a site with a string and an int32 and a record of `payload`
+static std::string binary_log(const std::string &payload,
+                              std::uint8_t int_size = sizeof(std::int32_t)) {
+   using print_detail::ArgKind;
+   std::string log{print_detail::deferred_magic};
+   log += 'S';
+   append(log, std::uint32_t{0});
+   append(log, std::uint8_t{1});
+   append(log, std::uint32_t{2});
+   append(log, static_cast<std::uint8_t>(ArgKind::String));
+   append(log, std::uint8_t{0});
+   append(log, static_cast<std::uint8_t>(ArgKind::Signed));
+   append(log, int_size);
+   log += 'R';
+   append(log, std::uint32_t{0});
+   log += ' ';
+   append(log, static_cast<std::uint32_t>(payload.size()));
+   return log + payload;
+}
+
+// payload of the site of binary_log with a string of `length` and `text`
+static std::string string_payload(std::uint32_t length, const std::string &text) {
+   std::string payload;
+   append(payload, length);
+   return payload + text;
+}
+
+// logger mode is global, so cases must not run in parallel
+TEST_SUITE_SERIAL_BEGIN(deferredLogTests)
+
+TEST_CASE(testSameAsPrintln) {
+   get_string_and_reset();
+   std::string str{"string"};
+   char buffer[16] = "buffer";
+   int value = 7;
+   auto print = [&](auto &printer) {
+      printer(1, -2, 3u, static_cast<short>(-4), 5ull, 'c', true);
+      printer(0.1, 1.5f, 1e100, 3.14159265358979);
+      printer("literal", str, buffer, static_cast<const char *>("pointer"));
+      printer(std::string{}, "");
+   };
+   print(sprintln);
+   sprintln(&value);
+   auto expected = get_string_and_reset();
+
+   print(deferred_sprintln);
+   deferred_sprintln(&value);
+   deferred_log_flush();
+   TEST_CHECK_EQUAL(expected, get_string_and_reset());
+}
+
+TEST_CASE(testSeparator) {
+   get_string_and_reset();
+   DeferredPrintBaseLnT<StringStreamGetter> csv{','};
+   csv(1, 2, "three");
+   deferred_sprint("no", "newline");
+   deferred_sprintln();
+   deferred_log_flush();
+   TEST_CHECK_EQUAL(std::string{"1,2,three\nno newline"}, get_string_and_reset());
+}
+
+// lines of a thread keep their order
+TEST_CASE(testThreads) {
+   get_string_and_reset();
+   const int threads_count = 4;
+   const int lines_count = 1000;
+   std::vector<std::thread> threads;
+   for (int t = 0; t < threads_count; ++t) {
+      threads.emplace_back([t] {
+         for (int i = 0; i < lines_count; ++i) {
+            deferred_sprintln(t, i);
+         }
+      });
+   }
+   for (auto &thread : threads) {
+      thread.join();
+   }
+   deferred_log_flush();
+
+   std::vector<int> next(threads_count);
+   int lines{}, out_of_order{};
+   int t, i;
+   while (StreamObject() >> t >> i) {
+      ++lines;
+      out_of_order += next[t] != i;
+      next[t] = i + 1;
+   }
+   get_string_and_reset();
+   TEST_CHECK_EQUAL(threads_count * lines_count, lines);
+   TEST_CHECK_EQUAL(0, out_of_order);
+}
+
+TEST_CASE(testRingWrapAround) {
+   DeferredRing ring{4096};
+   std::size_t written{}, read{};
+   // records of different sizes, so they don't divide the ring evenly
+   for (int round = 0; round < 100; ++round) {
+      for (std::size_t i = 0; i < 10; ++i) {
+         TEST_REQUIRE(write_record(ring, 40 + i * 8, static_cast<char>(i)));
+         ++written;
+      }
+      ring.drain([&](const DeferredRing::Header &header, const char *) {
+         TEST_CHECK_EQUAL(static_cast<int>(read % 10), static_cast<int>(header.sep));
+         ++read;
+      });
+   }
+   TEST_CHECK_EQUAL(written, read);
+   TEST_CHECK(ring.empty());
+
+   // the ring filled up to 8 bytes before its end, shorter than a padding record
+   DeferredRing exact{4096};
+   for (int i = 0; i < 169; ++i) {
+      TEST_REQUIRE(write_record(exact, 8));
+   }
+   TEST_REQUIRE(write_record(exact, 16, 'a'));
+   read = 0;
+   exact.drain([&](const DeferredRing::Header &, const char *) { ++read; });
+   TEST_CHECK_EQUAL(170u, read);
+   TEST_REQUIRE(write_record(exact, 8, 'b'));
+   TEST_REQUIRE(write_record(exact, 8, 'c'));
+   std::string seps;
+   exact.drain([&](const DeferredRing::Header &header, const char *) {
+      seps += header.sep;
+   });
+   TEST_CHECK_EQUAL(std::string{"bc"}, seps);
+   TEST_CHECK(exact.empty());
+}
+
+TEST_CASE(testRingFull) {
+   DeferredRing ring{4096};
+   int written{};
+   while (write_record(ring, 100)) {
+      ++written;
+   }
+   auto record_size = (DeferredRing::header_size + 100 + 7) / 8 * 8;
+   TEST_CHECK_EQUAL(static_cast<int>(4096 / record_size), written);
+   TEST_CHECK_EQUAL(1u, ring.dropped.load());
+   int read{};
+   ring.drain([&](const DeferredRing::Header &, const char *) { ++read; });
+   TEST_CHECK_EQUAL(written, read);
+   TEST_CHECK(write_record(ring, 100));
+}
+
+TEST_CASE(testBinaryLog) {
+   get_string_and_reset();
+   std::stringstream binary;
+   deferred_log_binary(&binary);
+   deferred_sprintln("binary", 1, -2L, 2.5, 'x', false);
+   deferred_sprintln(static_cast<std::uint16_t>(60000), static_cast<std::int16_t>(-300));
+   deferred_sprint("end");
+   deferred_log_binary(nullptr);
+   TEST_CHECK("" == get_string_and_reset());
+
+   std::stringstream text;
+   TEST_CHECK(deferred_log_decode(binary, text));
+   TEST_CHECK_EQUAL(std::string{"binary 1 -2 2.5 x 0\n60000 -300\nend"}, text.str());
+
+   std::stringstream garbage{"not a log"};
+   TEST_CHECK(!deferred_log_decode(garbage, text));
+}
+
+TEST_CASE(testBinaryLogCorrupted) {
+   std::string value;
+   append(value, std::int32_t{7});
+   auto decode = [](const std::string &log, std::string *text = nullptr) {
+      std::stringstream in{log}, out;
+      bool ret = deferred_log_decode(in, out);
+      if (text) {
+         *text = out.str();
+      }
+      return ret;
+   };
+   std::string text;
+   TEST_CHECK(decode(binary_log(string_payload(3, "abc") + value), &text));
+   TEST_CHECK_EQUAL(std::string{"abc 7\n"}, text);
+
+   // string longer than the payload
+   TEST_CHECK(!decode(binary_log(string_payload(100, "abc") + value)));
+   TEST_CHECK(!decode(binary_log(string_payload(0xffffffff, "abc"))));
+   // no room for the length of the string
+   TEST_CHECK(!decode(binary_log("ab")));
+   // the number runs past the payload
+   TEST_CHECK(!decode(binary_log(string_payload(3, "abc") + value.substr(0, 2))));
+   // size of the number in the site isn't a size of the kind
+   TEST_CHECK(!decode(binary_log(string_payload(3, "abc") + value, 3)));
+   TEST_CHECK(!decode(binary_log(string_payload(3, "abc") + value, 200)));
+
+   // truncated anywhere in the record
+   auto log = binary_log(string_payload(3, "abc") + value);
+   auto record = log.find('R', std::strlen(print_detail::deferred_magic));
+   for (auto size = record + 1; size < log.size(); ++size) {
+      TEST_CHECK(!decode(log.substr(0, size)));
+   }
+}
+
+// cost of the call site, records go to a binary log which is discarded
+TEST_BENCHMARK(benchDeferredPrintln) {
+   NullBuffer null_buffer;
+   std::ostream null{&null_buffer};
+   deferred_log_binary(&null);
+   // thread with a large ring, so records are not dropped while it is drained
+   auto &ring_size = print_detail::DeferredLogger::ring_size();
+   auto saved_size = ring_size;
+   ring_size = 64 << 20;
+   std::thread thread{[&] {
+      std::uint64_t i{};
+      TEST_BENCHMARK_LOOP { deferred_println("value", ++i, 2.5); }
+   }};
+   thread.join();
+   ring_size = saved_size;
+   deferred_log_binary(nullptr);
+}
+
+TEST_BENCHMARK(benchPrintln) {
+   NullBuffer null_buffer;
+   std::ostream null{&null_buffer};
+   std::uint64_t i{};
+   TEST_BENCHMARK_LOOP {
+      LineStreamGuard line;
+      PrintT::write(line.stream(), ' ', "value", ++i, 2.5);
+      line.stream() << '\n';
+      auto &buffer = line.buffer();
+      null.write(buffer.data(), static_cast<std::streamsize>(buffer.size()));
+   }
+}
+
+TEST_SUITE_END() // deferredLogTests
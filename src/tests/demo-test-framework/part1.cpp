@@ -1,5 +1,8 @@
 #include <test_framework/tiny_framework.h>
 
+#include <numeric>
+#include <vector>
+
 TEST_SUITE_BEGIN(suite_part1)
 
 TEST_SUITE_BEGIN(suite_nested)
@@ -28,3 +31,19 @@ TEST_CASE(case2) {
 TEST_CASE(case1) { TEST_CHECK(true); }
 
 TEST_SUITE_END()
+
+TEST_SUITE_BEGIN(suite_bench)
+
+// measured with `--bench` (only benchmarks) or by default together with test cases
+TEST_BENCHMARK(accumulate) {
+   std::vector<int> values(1024, 1);
+   TEST_BENCHMARK_ITEMS(values.size());
+   TEST_BENCHMARK_BYTES(values.size() * sizeof(int));
+   TEST_BENCHMARK_LOOP {
+      auto sum = std::accumulate(values.begin(), values.end(), 0);
+      dds::tiny_test::do_not_optimize(sum);
+   }
+   TEST_CHECK_EQUAL(1024u, values.size());
+}
+
+TEST_SUITE_END()
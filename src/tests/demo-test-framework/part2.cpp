@@ -20,4 +20,11 @@ TEST_CASE(case3) {
 
 TEST_CASE(case4) { TEST_CHECK(true); }
 
+// test cases of this suite never run in parallel with others (`--jobs=N`)
+TEST_SUITE_SERIAL_BEGIN(suite_serial)
+
+TEST_CASE(case5) { TEST_CHECK(bar(true)); }
+
+TEST_SUITE_END()
+
 TEST_SUITE_END()
@@ -0,0 +1,149 @@
+#include <common/common.h>
+#include <mpl/dispatch_static.h>
+#include <test_framework/tiny_framework.h>
+
+#include <cstdint>
+#include <random>
+#include <vector>
+
+using namespace dds;
+using namespace dds::mpl;
+
+TESTS_BEGIN()
+
+TEST_SUITE_BEGIN(dispatchstaticTests)
+
+TEST_CASE(Basic) {
+   for (int value = -3; value <= 5; ++value) {
+      auto ret = dispatch_static<-3, 5>(value, [](auto v) {
+         constexpr int ret = decltype(v)::value;
+         static_assert(ret >= -3 && ret <= 5, "Out of range");
+         return ret;
+      });
+      TEST_CHECK_EQUAL(value, ret);
+   }
+   // single value range
+   auto single = dispatch_static<7, 7>(7, [](auto v) { return v(); });
+   TEST_CHECK_EQUAL(7, single);
+}
+
+TEST_CASE(otherwise) {
+   auto f = [](auto v) { return String(static_cast<std::size_t>(v()), 'x'); };
+   auto otherwise = [](int value) { return "out of range " + std::to_string(value); };
+   auto dispatch = [&](int value) { return dispatch_static<0, 3>(value, f, otherwise); };
+   TEST_CHECK_EQUAL("xx", dispatch(2));
+   TEST_CHECK_EQUAL("out of range 4", dispatch(4));
+   TEST_CHECK_EQUAL("out of range -1", dispatch(-1));
+}
+
+// the selected instantiation gets the value as a constant expression
+template <int width>
+static int sum_of_width(const int *data) {
+   int ret{};
+   for (int i = 0; i < width; ++i) {
+      ret += data[i];
+   }
+   return ret;
+}
+
+TEST_CASE(specialisedKernel) {
+   int data[] = {1, 2, 3, 4, 5, 6, 7, 8};
+   for (int width = 1; width <= 8; ++width) {
+      auto sum = dispatch_static<1, 8>(
+         width, [&](auto w) { return sum_of_width<decltype(w)::value>(data); });
+      TEST_CHECK_EQUAL(width * (width + 1) / 2, sum);
+   }
+}
+
+TEST_CASE(returnsReference) {
+   int values[4] = {};
+   auto &ref = dispatch_static<0, 3>(2, [&](auto v) -> int & { return values[v()]; });
+   TEST_CHECK(&values[2] == &ref);
+}
+
+enum class color_t : std::uint8_t { red = 1, green, blue };
+
+TEST_CASE(enumDispatch) {
+   auto name = [](auto c) {
+      using C = decltype(c);
+      static_assert(std::is_same<color_t, typename C::value_type>::value,
+                    "Type mismatch");
+      return C::value == color_t::red     ? "red"
+             : C::value == color_t::green ? "green"
+                                          : "blue";
+   };
+   auto dispatch = [&](color_t c) {
+      return String{dispatch_enum<color_t, color_t::red, color_t::blue>(c, name)};
+   };
+   TEST_CHECK_EQUAL("red", dispatch(color_t::red));
+   TEST_CHECK_EQUAL("green", dispatch(color_t::green));
+   TEST_CHECK_EQUAL("blue", dispatch(color_t::blue));
+}
+
+TEST_CASE(cartesianProduct) {
+   int calls{};
+   for (int a = 1; a <= 4; ++a) {
+      for (int b = -1; b <= 1; ++b) {
+         for (int c = 0; c <= 2; ++c) {
+            auto f = [&](auto x, auto y, auto z) {
+               ++calls;
+               return x() * 100 + y() * 10 + z();
+            };
+            auto ret = dispatch_static_product<static_range_t<1, 4>,
+                                               static_range_t<-1, 1>,
+                                               static_range_t<0, 2>>({a, b, c}, f);
+            TEST_CHECK_EQUAL(a * 100 + b * 10 + c, ret);
+         }
+      }
+   }
+   TEST_CHECK_EQUAL(4 * 3 * 3, calls);
+}
+
+static std::vector<int> random_widths(std::size_t count) {
+   std::mt19937 rng{42};
+   std::vector<int> ret(count);
+   for (auto &width : ret) {
+      width = static_cast<int>(rng() % 8) + 1;
+   }
+   return ret;
+}
+
+// dispatch of a runtime width to the specialised kernels
+TEST_BENCHMARK(benchDispatch) {
+   auto widths = random_widths(1000);
+   int data[] = {1, 2, 3, 4, 5, 6, 7, 8};
+   TEST_BENCHMARK_ITEMS(widths.size());
+   TEST_BENCHMARK_LOOP {
+      int sum{};
+      for (auto width : widths) {
+         sum += dispatch_static<1, 8>(
+            width, [&](auto w) { return sum_of_width<decltype(w)::value>(data); });
+      }
+      tiny_test::do_not_optimize(sum);
+   }
+}
+
+// the same dispatch written by hand
+TEST_BENCHMARK(benchSwitch) {
+   auto widths = random_widths(1000);
+   int data[] = {1, 2, 3, 4, 5, 6, 7, 8};
+   TEST_BENCHMARK_ITEMS(widths.size());
+   TEST_BENCHMARK_LOOP {
+      int sum{};
+      for (auto width : widths) {
+         switch (width) {
+         case 1: sum += sum_of_width<1>(data); break;
+         case 2: sum += sum_of_width<2>(data); break;
+         case 3: sum += sum_of_width<3>(data); break;
+         case 4: sum += sum_of_width<4>(data); break;
+         case 5: sum += sum_of_width<5>(data); break;
+         case 6: sum += sum_of_width<6>(data); break;
+         case 7: sum += sum_of_width<7>(data); break;
+         case 8: sum += sum_of_width<8>(data); break;
+         }
+      }
+      tiny_test::do_not_optimize(sum);
+   }
+}
+
+TEST_SUITE_END() // dispatchstaticTests
@@ -32,4 +32,74 @@ TEST_CASE(sfinae) {
    TEST_CHECK_EQUAL("42", ret2);
 }
 
-TEST_SUITE_END() // ifstaticTests
+// copies and moves of a counted_t, counted per test case
+struct counts_t {
+   int copies{};
+   int moves{};
+};
+
+struct counted_t {
+   explicit counted_t(counts_t &counts_, int value_)
+      : counts{&counts_}
+      , value{value_} {}
+   counted_t(const counted_t &other)
+      : counts{other.counts}
+      , value{other.value} {
+      ++counts->copies;
+   }
+   counted_t(counted_t &&other)
+      : counts{other.counts}
+      , value{other.value} {
+      ++counts->moves;
+   }
+
+   template <typename Id>
+   int operator()(Id) const {
+      return value;
+   }
+
+   counts_t *counts;
+   int value;
+};
+
+TEST_CASE(noCopiesNoMoves) {
+   counts_t counts;
+   counted_t t{counts, 1};
+   counted_t f{counts, 2};
+   int sum{};
+   for (int i = 0; i < 1000; ++i) {
+      sum += exec_if(true_t{}, t, f);
+      sum += exec_if(false_t{}, t, f);
+   }
+   TEST_CHECK_EQUAL(3000, sum);
+   TEST_CHECK_EQUAL(3, exec_if(true_t{}, counted_t{counts, 3}, f));
+   TEST_CHECK_EQUAL(4, exec_if(false_t{}, t, counted_t{counts, 4}));
+   TEST_CHECK_EQUAL(0, counts.copies);
+   TEST_CHECK_EQUAL(0, counts.moves);
+}
+
+// reference returned by the selected callback is kept
+TEST_CASE(returnsReference) {
+   String s{"value"};
+   auto get = [&](auto) -> String & { return s; };
+   auto other = [](auto) { return 42; };
+   static_assert(std::is_same<String &, decltype(exec_if(true_t{}, get, other))>::value,
+                 "Type mismatch");
+   TEST_CHECK(&s == &exec_if(true_t{}, get, other));
+}
+
+template <int value>
+struct constant_cb_t {
+   template <typename Id>
+   constexpr int operator()(Id) const {
+      return value;
+   }
+};
+
+TEST_CASE(constexprContext) {
+   static_assert(1 == exec_if(true_t{}, constant_cb_t<1>{}, constant_cb_t<2>{}), "");
+   static_assert(2 == exec_if(false_t{}, constant_cb_t<1>{}, constant_cb_t<2>{}), "");
+   TEST_CHECK(true);
+}
+
+TEST_SUITE_END() // execifTests
@@ -0,0 +1,176 @@
+#include <mpl/for_each_field.h>
+#include <test_framework/tiny_framework.h>
+
+#include <cstdint>
+#include <sstream>
+#include <string>
+#include <type_traits>
+#include <vector>
+
+TESTS_BEGIN();
+
+using namespace dds;
+using namespace dds::mpl;
+
+struct empty_t {};
+
+struct point_t {
+   int x;
+   int y;
+};
+
+struct record_t {
+   char tag;
+   double value;
+   std::string name;
+   point_t position;
+   std::uint16_t flags;
+};
+
+struct vector_t {
+   std::vector<int> values;
+};
+
+struct with_base_t : point_t {
+   int z;
+};
+
+// the same field types as `{int, char, char}`, but `b` is at offset 6, not 5
+struct overaligned_t {
+   int i;
+   char a;
+   alignas(2) char b;
+};
+
+struct with_constructor_t {
+   with_constructor_t(int x_)
+      : x{x_} {}
+   int x;
+};
+
+template <typename T>
+static std::string to_text(const T &value) {
+   std::ostringstream out;
+   print_detail::put(out, value);
+   return out.str();
+}
+
+template <typename T>
+static std::string difference(const T &lhs, const T &rhs) {
+   std::ostringstream out;
+   using has_equal = tiny_test::__has_equal_t<T, T>;
+   tiny_test::__write_difference(out, std::string{}, lhs, rhs, has_equal{});
+   return out.str();
+}
+
+TEST_SUITE_BEGIN(foreachfieldTests)
+
+TEST_CASE(fieldCount) {
+   static_assert(field_count_t<empty_t>::value == 0, "Count mismatch");
+   static_assert(field_count_t<point_t>::value == 2, "Count mismatch");
+   static_assert(field_count_t<record_t>::value == 5, "Count mismatch");
+   static_assert(field_count_t<vector_t>::value == 1, "Count mismatch");
+
+   static_assert(is_reflectable_t<record_t>::value, "Reflectable mismatch");
+   static_assert(!is_reflectable_t<with_base_t>::value, "Reflectable mismatch");
+   static_assert(!is_reflectable_t<with_constructor_t>::value, "Reflectable mismatch");
+   static_assert(!is_reflectable_t<int>::value, "Reflectable mismatch");
+}
+
+TEST_CASE(fieldTypes) {
+   using types = field_types_t<record_t>;
+   static_assert(
+      std::is_same<types,
+                   type_list_t<char, double, std::string, point_t, std::uint16_t>>::value,
+      "Types mismatch");
+   static_assert(std::is_same<field_types_t<empty_t>, type_list_t<>>::value,
+                 "Types mismatch");
+}
+
+TEST_CASE(getField) {
+   record_t record{'a', 2.5, "name", {1, 2}, 7};
+   TEST_CHECK(&get_field<0>(record) == &record.tag);
+   TEST_CHECK(&get_field<1>(record) == &record.value);
+   TEST_CHECK(&get_field<2>(record) == &record.name);
+   TEST_CHECK(&get_field<3>(record) == &record.position);
+   TEST_CHECK(&get_field<4>(record) == &record.flags);
+
+   get_field<2>(record) += "d";
+   get_field<1>(get_field<3>(record)) = 5;
+   TEST_CHECK_EQUAL("named", record.name);
+   TEST_CHECK_EQUAL(5, record.position.y);
+
+   const auto &constant = record;
+   using name_t = decltype(get_field<2>(constant));
+   static_assert(std::is_same<name_t, const std::string &>::value, "Const mismatch");
+   TEST_CHECK_EQUAL(7u, get_field<4>(constant));
+}
+
+TEST_CASE(layoutChecked) {
+   static_assert(sizeof(overaligned_t) == 8, "Size mismatch");
+   TEST_CHECK(!mpl::detail::field_layout_t<overaligned_t>::matches());
+   TEST_CHECK(mpl::detail::field_layout_t<record_t>::matches());
+   TEST_CHECK(mpl::detail::field_layout_t<point_t>::matches());
+   TEST_CHECK(mpl::detail::field_layout_t<vector_t>::matches());
+   TEST_CHECK(mpl::detail::field_layout_t<empty_t>::matches());
+   // checked at startup for every type whose fields are accessed
+   TEST_CHECK(mpl::detail::field_layout_t<record_t>::checked);
+}
+
+TEST_CASE(forEachField) {
+   point_t point{1, 2};
+   for_each_field(point, [](int &field) { field *= 10; });
+   TEST_CHECK_EQUAL(10, point.x);
+   TEST_CHECK_EQUAL(20, point.y);
+
+   const vector_t values{{1, 2, 3}};
+   std::size_t size{};
+   for_each_field(values, [&](const auto &field) {
+      static_assert(std::is_const<std::remove_reference_t<decltype(field)>>::value,
+                    "Const mismatch");
+      size = field.size();
+   });
+   TEST_CHECK_EQUAL(3u, size);
+
+   int calls{};
+   empty_t empty;
+   for_each_field(empty, [&](auto &) { ++calls; });
+   TEST_CHECK_EQUAL(0, calls);
+}
+
+TEST_CASE(print) {
+   TEST_CHECK_EQUAL("{1, 2}", to_text(point_t{1, 2}));
+   TEST_CHECK_EQUAL("{a, 2.5, name, {1, 2}, 7}",
+                    to_text(record_t{'a', 2.5, "name", {1, 2}, 7}));
+   TEST_CHECK_EQUAL("{}", to_text(empty_t{}));
+   TEST_CHECK_EQUAL("point {3, 4}", format_fmt(PRINT_FMT("point {}"), point_t{3, 4}));
+}
+
+TEST_CASE(checkEqual) {
+   TEST_CHECK(tiny_test::__equal(point_t{1, 2}, point_t{1, 2}));
+   TEST_CHECK(!tiny_test::__equal(point_t{1, 2}, point_t{1, 3}));
+   TEST_CHECK(tiny_test::__equal(empty_t{}, empty_t{}));
+   TEST_CHECK_EQUAL((record_t{'a', 2.5, "name", {1, 2}, 7}),
+                    (record_t{'a', 2.5, "name", {1, 2}, 7}));
+
+   // only the fields which differ are reported
+   TEST_CHECK_EQUAL("field 1: `2` != `3`", difference(point_t{1, 2}, point_t{1, 3}));
+   TEST_CHECK_EQUAL("field 0: `a` != `b`, field 3.1: `2` != `4`",
+                    difference(record_t{'a', 2.5, "name", {1, 2}, 7},
+                               record_t{'b', 2.5, "name", {1, 4}, 7}));
+   TEST_CHECK_EQUAL("`1` != `2`", difference(1, 2));
+}
+
+TEST_CASE(checkEqualIntegers) {
+   std::vector<int> values(3);
+   TEST_CHECK_EQUAL(3, values.size());
+   TEST_CHECK(!tiny_test::__equal(-1, values.size()));
+   TEST_CHECK(!tiny_test::__equal(static_cast<std::size_t>(-1), -1));
+   TEST_CHECK(!tiny_test::__equal(-1, 0xffffffffu));
+   TEST_CHECK(tiny_test::__equal(std::int8_t{-5}, -5ll));
+   TEST_CHECK(tiny_test::__equal(std::uint16_t{65535}, 65535));
+   TEST_CHECK(tiny_test::__equal('a', 97u));
+   TEST_CHECK(tiny_test::__equal(true, 1));
+}
+
+TEST_SUITE_END() // foreachfieldTests
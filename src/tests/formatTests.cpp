@@ -0,0 +1,133 @@
+#include <test_framework/tiny_framework.h>
+
+#include <cstdint>
+#include <sstream>
+#include <string>
+
+TESTS_BEGIN();
+
+using print_detail::FmtError;
+using print_detail::format_error;
+
+static std::stringstream &StreamObject() {
+   static std::stringstream obj;
+   return obj;
+}
+
+template <>
+struct StreamGetter<std::stringstream> {
+   static auto &GetStream() { return StreamObject(); }
+};
+
+using StringStreamGetter = StreamGetter<std::stringstream>;
+
+constexpr PrintFmtBaseT<StringStreamGetter> sprint_fmt{};
+constexpr PrintFmtBaseLnT<StringStreamGetter> sprintln_fmt{};
+
+struct Point {
+   int x, y;
+};
+
+std::ostream &operator<<(std::ostream &out, const Point &p) {
+   return out << '(' << p.x << ", " << p.y << ')';
+}
+
+TEST_SUITE_BEGIN(formatTests)
+
+TEST_CASE(testPlainText) {
+   TEST_CHECK("" == format_fmt(PRINT_FMT("")));
+   TEST_CHECK("text" == format_fmt(PRINT_FMT("text")));
+   TEST_CHECK("{braces}" == format_fmt(PRINT_FMT("{{braces}}")));
+   TEST_CHECK("{5}" == format_fmt(PRINT_FMT("{{{}}}"), 5));
+}
+
+TEST_CASE(testDefaultFormat) {
+   TEST_CHECK("1 -2 3" == format_fmt(PRINT_FMT("{} {} {}"), 1, -2L, 3u));
+   TEST_CHECK("a true false" == format_fmt(PRINT_FMT("{} {} {}"), 'a', true, false));
+   TEST_CHECK("1.5 0.1" == format_fmt(PRINT_FMT("{} {}"), 1.5, 0.1f));
+   std::string str{"string"};
+   const char *cstr = "cstr";
+   TEST_CHECK("literal string cstr" ==
+              format_fmt(PRINT_FMT("{} {} {}"), "literal", str, cstr));
+   TEST_CHECK("point (1, 2)" == format_fmt(PRINT_FMT("point {}"), Point{1, 2}));
+   TEST_CHECK("0x0" == format_fmt(PRINT_FMT("{}"), nullptr));
+}
+
+TEST_CASE(testIntegerLimits) {
+   TEST_CHECK("-9223372036854775808" == format_fmt(PRINT_FMT("{}"), INT64_MIN));
+   TEST_CHECK("18446744073709551615" == format_fmt(PRINT_FMT("{}"), UINT64_MAX));
+   TEST_CHECK("-128 255" ==
+              format_fmt(PRINT_FMT("{:d} {:d}"),
+                         static_cast<signed char>(-128),
+                         static_cast<unsigned char>(255)));
+}
+
+TEST_CASE(testIntegerSpecs) {
+   TEST_CHECK("ff FF 17 101" ==
+              format_fmt(PRINT_FMT("{:x} {:X} {:o} {:b}"), 255, 255, 15, 5));
+   TEST_CHECK("-1f" == format_fmt(PRINT_FMT("{:x}"), -31));
+   TEST_CHECK("ffffffff" == format_fmt(PRINT_FMT("{:x}"), UINT32_MAX));
+   TEST_CHECK("A 65" == format_fmt(PRINT_FMT("{:c} {:d}"), 65, 'A'));
+}
+
+TEST_CASE(testWidth) {
+   TEST_CHECK("   42|42" == format_fmt(PRINT_FMT("{:5}|{:1}"), 42, 42));
+   TEST_CHECK("00042 -0042" == format_fmt(PRINT_FMT("{:05} {:05}"), 42, -42));
+   TEST_CHECK("000000ff" == format_fmt(PRINT_FMT("{:08x}"), 255));
+   TEST_CHECK("  abc" == format_fmt(PRINT_FMT("{:05}"), "abc"));
+}
+
+TEST_CASE(testFloatSpecs) {
+   TEST_CHECK("3.142 3.14e+00 3.1" ==
+              format_fmt(PRINT_FMT("{:.3f} {:.2e} {:.2g}"), 3.14159, 3.14159, 3.14159));
+   TEST_CHECK("0002.50" == format_fmt(PRINT_FMT("{:07.2f}"), 2.5));
+   TEST_CHECK("1.25" == format_fmt(PRINT_FMT("{}"), 1.25L));
+   // longer than the temporary buffer
+   auto large = format_fmt(PRINT_FMT("{:.1f}"), 1e100);
+   TEST_CHECK_EQUAL(103u, large.size());
+   TEST_CHECK("10000000000" == large.substr(0, 11));
+   TEST_CHECK(".0" == large.substr(101));
+}
+
+TEST_CASE(testLongLine) {
+   // strings are unbounded, so the line doesn't fit the stack buffer
+   std::string str(1000, 'x');
+   auto formatted = format_fmt(PRINT_FMT("[{}] [{}]"), str, str);
+   TEST_CHECK("[" + str + "] [" + str + "]" == formatted);
+}
+
+TEST_CASE(testPrint) {
+   StreamObject().str("");
+   sprint_fmt(PRINT_FMT("{}+{}="), 1, 2);
+   sprintln_fmt(PRINT_FMT("{}"), 3);
+   sprintln_fmt(PRINT_FMT("done"));
+   TEST_CHECK("1+2=3\ndone\n" == StreamObject().str());
+   StreamObject().str("");
+}
+
+TEST_CASE(testCompileTimeErrors) {
+   auto one = PRINT_FMT("{}");
+   auto two = PRINT_FMT("{} {}");
+   auto hex = PRINT_FMT("{:x}");
+   auto fixed = PRINT_FMT("{:.2f}");
+   auto open = PRINT_FMT("{");
+   auto close = PRINT_FMT("}");
+   auto unknown = PRINT_FMT("{:y}");
+   auto bad = PRINT_FMT("{:xx}");
+   static_assert(FmtError::Ok == format_error<decltype(one), int>(), "");
+   static_assert(FmtError::TooFewArgs == format_error<decltype(two), int>(), "");
+   static_assert(FmtError::TooManyArgs == format_error<decltype(one), int, int>(), "");
+   static_assert(FmtError::Ok == format_error<decltype(hex), unsigned>(), "");
+   static_assert(FmtError::TypeMismatch == format_error<decltype(hex), double>(), "");
+   static_assert(FmtError::TypeMismatch == format_error<decltype(hex), std::string>(), "");
+   static_assert(FmtError::TypeMismatch == format_error<decltype(fixed), int>(), "");
+   static_assert(FmtError::UnmatchedBrace == format_error<decltype(open), int>(), "");
+   static_assert(FmtError::UnmatchedBrace == format_error<decltype(close)>(), "");
+   static_assert(FmtError::BadSpec == format_error<decltype(unknown), int>(), "");
+   static_assert(FmtError::BadSpec == format_error<decltype(bad), int>(), "");
+   (void)one, (void)two, (void)hex, (void)fixed, (void)open, (void)close;
+   (void)unknown, (void)bad;
+   TEST_CHECK(true);
+}
+
+TEST_SUITE_END() // formatTests
@@ -107,4 +107,81 @@ TEST_CASE(tricky) {
    TEST_CHECK_EQUAL(2, i2);
 }
 
+// copies and moves of a counted_t, counted per test case
+struct counts_t {
+   int copies{};
+   int moves{};
+};
+
+struct counted_t {
+   explicit counted_t(counts_t &counts_)
+      : counts{&counts_} {}
+   counted_t(const counted_t &other)
+      : counts{other.counts} {
+      ++counts->copies;
+   }
+   counted_t(counted_t &&other)
+      : counts{other.counts} {
+      ++counts->moves;
+   }
+
+   int operator()(int i) const { return i + 1; }
+
+   counts_t *counts;
+};
+
+TEST_CASE(lvalueIsReturnedByReference) {
+   counts_t counts;
+   counted_t t{counts};
+   const counted_t f{counts};
+   static_assert(std::is_same<counted_t &, decltype(if_static(true_t{}, t, f))>::value,
+                 "Type mismatch");
+   static_assert(
+      std::is_same<const counted_t &, decltype(if_static(false_t{}, t, f))>::value,
+      "Type mismatch");
+   TEST_CHECK(&t == &if_static(true_t{}, t, f));
+   TEST_CHECK(&f == &if_static(false_t{}, t, f));
+   TEST_CHECK_EQUAL(0, counts.copies);
+   TEST_CHECK_EQUAL(0, counts.moves);
+}
+
+TEST_CASE(rvalueIsMoved) {
+   counts_t counts;
+   auto ret = if_static(true_t{}, counted_t{counts}, 42);
+   static_assert(std::is_same<counted_t, decltype(ret)>::value, "Type mismatch");
+   TEST_CHECK_EQUAL(0, counts.copies);
+   TEST_CHECK_EQUAL(1, counts.moves);
+
+   String s(100, 'x');
+   auto moved = if_static(false_t{}, 42, std::move(s));
+   TEST_CHECK_EQUAL(100u, moved.size());
+   TEST_CHECK(s.empty());
+}
+
+TEST_CASE(noCopiesInLoop) {
+   counts_t counts;
+   counted_t heavy{counts};
+   auto other = [](int i) { return i; };
+   int sum{};
+   for (int i = 0; i < 1000; ++i) {
+      sum += if_static(true_t{}, heavy, other)(i);
+      sum += if_static(false_t{}, other, heavy)(i);
+   }
+   TEST_CHECK_EQUAL(1001000, sum);
+   TEST_CHECK_EQUAL(0, counts.copies);
+   TEST_CHECK_EQUAL(0, counts.moves);
+}
+
+constexpr int constexpr_one = 1;
+constexpr double constexpr_two = 2.0;
+
+TEST_CASE(constexprContext) {
+   static_assert(1 == if_static(true_t{}, 1, 2.0), "");
+   static_assert(2.0 == if_static(false_t{}, 1, 2.0), "");
+   static_assert(1 == if_static(true_t{}, constexpr_one, constexpr_two), "");
+   static_assert(&constexpr_two == &if_static(false_t{}, constexpr_one, constexpr_two),
+                 "");
+   TEST_CHECK(true);
+}
+
 TEST_SUITE_END() // ifstaticTests
@@ -0,0 +1,255 @@
+// replace operator new/delete of this binary to check that nothing allocates
+#define DDS_TINYTEST_TRACK_ALLOCS
+
+#include <common/common.h>
+#include <common/function_ref.h>
+#include <common/inplace_function.h>
+#include <test_framework/tiny_framework.h>
+
+#include <cstdint>
+#include <functional>
+#include <memory>
+#include <vector>
+
+using namespace dds;
+
+TESTS_BEGIN()
+
+TEST_SUITE_BEGIN(inplacefunctionTests)
+
+static int twice(int value) { return 2 * value; }
+
+TEST_CASE(Basic) {
+   inplace_function_t<int(int)> f;
+   TEST_CHECK(!f);
+   f = [](int value) { return value + 1; };
+   TEST_REQUIRE(static_cast<bool>(f));
+   TEST_CHECK_EQUAL(2, f(1));
+
+   f = twice;
+   TEST_CHECK_EQUAL(4, f(2));
+   f = nullptr;
+   TEST_CHECK(!f);
+
+   // arguments are forwarded, a move-only one too
+   inplace_function_t<int(std::unique_ptr<int>)> take = [](std::unique_ptr<int> ptr) {
+      return *ptr;
+   };
+   TEST_CHECK_EQUAL(3, take(std::make_unique<int>(3)));
+
+   // the callable keeps its state between calls
+   int calls{};
+   inplace_function_t<void()> count = [&calls, total = 0]() mutable {
+      calls = ++total;
+   };
+   count();
+   count();
+   TEST_CHECK_EQUAL(2, calls);
+}
+
+struct counts_t {
+   int copies{};
+   int moves{};
+   int destroyed{};
+};
+
+struct counted_t {
+   explicit counted_t(counts_t &counts_)
+      : counts{&counts_} {}
+   counted_t(const counted_t &other)
+      : counts{other.counts} {
+      ++counts->copies;
+   }
+   counted_t(counted_t &&other) noexcept
+      : counts{other.counts} {
+      ++counts->moves;
+   }
+   ~counted_t() { ++counts->destroyed; }
+
+   int operator()() const { return 1; }
+
+   counts_t *counts;
+};
+
+TEST_CASE(copyMove) {
+   counts_t counts;
+   {
+      inplace_function_t<int()> f{counted_t{counts}};
+      TEST_CHECK_EQUAL(1, counts.moves);
+      auto copy = f;
+      TEST_CHECK_EQUAL(1, counts.copies);
+      auto moved = std::move(copy);
+      TEST_CHECK_EQUAL(2, counts.moves);
+      TEST_CHECK(!copy);
+      TEST_CHECK_EQUAL(1, moved());
+
+      copy = moved;
+      TEST_CHECK_EQUAL(2, counts.copies);
+      moved = nullptr;
+      TEST_CHECK(!moved);
+      TEST_CHECK_EQUAL(1, copy());
+   }
+   // every constructed value is destroyed once
+   TEST_CHECK_EQUAL(counts.copies + counts.moves + 1, counts.destroyed);
+}
+
+TEST_CASE(moveOnly) {
+   static_assert(std::is_copy_constructible<inplace_function_t<void()>>::value,
+                 "Copy mismatch");
+   static_assert(!std::is_copy_constructible<inplace_move_function_t<void()>>::value,
+                 "Copy mismatch");
+   static_assert(!std::is_copy_assignable<inplace_move_function_t<void()>>::value,
+                 "Copy mismatch");
+
+   auto ptr = std::make_unique<int>(5);
+   inplace_move_function_t<int()> f = [ptr = std::move(ptr)] { return *ptr; };
+   auto moved = std::move(f);
+   TEST_CHECK(!f);
+   TEST_CHECK_EQUAL(5, moved());
+}
+
+TEST_CASE(capacity) {
+   using small_t = inplace_function_t<void(), 8, 8>;
+   static_assert(small_t::capacity == 8, "Capacity mismatch");
+   static_assert(sizeof(small_t) == 16, "Size mismatch");
+
+   std::uint64_t data[8]{1, 2, 3, 4, 5, 6, 7, 8};
+   inplace_function_t<std::uint64_t(), sizeof(data)> sum = [data] {
+      std::uint64_t ret{};
+      for (auto value : data) {
+         ret += value;
+      }
+      return ret;
+   };
+   TEST_CHECK_EQUAL(36u, sum());
+}
+
+TEST_CASE(noAlloc) {
+   std::uint64_t a{1}, b{2}, c{3}, d{4};
+   int result{};
+   TEST_CHECK_NO_ALLOC {
+      inplace_function_t<int()> f = [a, b, c, d] {
+         return static_cast<int>(a + b + c + d);
+      };
+      auto copy = f;
+      result = copy();
+   }
+   TEST_CHECK_EQUAL(10, result);
+}
+
+static int call_ref(function_ref_t<int(int)> f, int value) { return f(value); }
+
+TEST_CASE(functionRef) {
+   int offset{10};
+   TEST_CHECK_EQUAL(11, call_ref([&](int value) { return value + offset; }, 1));
+   TEST_CHECK_EQUAL(6, call_ref(twice, 3));
+   TEST_CHECK_EQUAL(8, call_ref(&twice, 4));
+
+   // refers to the callable, its state is shared
+   int calls{};
+   auto count = [&calls](int value) { return calls += value; };
+   function_ref_t<int(int)> ref = count;
+   ref(1);
+   ref(2);
+   TEST_CHECK_EQUAL(3, calls);
+
+   const auto constant = [](int) { return 7; };
+   TEST_CHECK_EQUAL(7, call_ref(constant, 0));
+
+   inplace_function_t<int(int)> owner = [](int value) { return -value; };
+   TEST_CHECK_EQUAL(-1, call_ref(owner, 1));
+}
+
+const int bench_calls = 1000;
+
+// the sum is kept in every step, so the direct call isn't folded to a formula
+template <typename F>
+static int call_loop(F &f) {
+   int sum{};
+   for (int i = 0; i < bench_calls; ++i) {
+      sum += f(i);
+      tiny_test::do_not_optimize(sum);
+   }
+   return sum;
+}
+
+// lambdas capturing 8 and 32 bytes, std::function allocates above 16
+static auto small_lambda(int offset) {
+   return [offset](int i) { return i + offset; };
+}
+
+static auto large_lambda(int offset) {
+   std::int64_t a{offset}, b{1}, c{2}, d{3};
+   return [a, b, c, d](int i) { return static_cast<int>(i + a + b * c - d); };
+}
+
+TEST_BENCHMARK(benchCallDirect) {
+   auto f = small_lambda(1);
+   TEST_BENCHMARK_ITEMS(bench_calls);
+   TEST_BENCHMARK_LOOP {
+      tiny_test::do_not_optimize(f);
+      tiny_test::do_not_optimize(call_loop(f));
+   }
+}
+
+TEST_BENCHMARK(benchCallInplace) {
+   inplace_function_t<int(int)> f = small_lambda(1);
+   TEST_BENCHMARK_ITEMS(bench_calls);
+   TEST_BENCHMARK_LOOP {
+      tiny_test::do_not_optimize(f);
+      tiny_test::do_not_optimize(call_loop(f));
+   }
+}
+
+TEST_BENCHMARK(benchCallFunctionRef) {
+   auto lambda = small_lambda(1);
+   function_ref_t<int(int)> f = lambda;
+   TEST_BENCHMARK_ITEMS(bench_calls);
+   TEST_BENCHMARK_LOOP {
+      tiny_test::do_not_optimize(f);
+      tiny_test::do_not_optimize(call_loop(f));
+   }
+}
+
+TEST_BENCHMARK(benchCallStdFunction) {
+   std::function<int(int)> f = small_lambda(1);
+   TEST_BENCHMARK_ITEMS(bench_calls);
+   TEST_BENCHMARK_LOOP {
+      tiny_test::do_not_optimize(f);
+      tiny_test::do_not_optimize(call_loop(f));
+   }
+}
+
+template <typename Function, typename Lambda>
+static void construct_loop(const Lambda &lambda) {
+   for (int i = 0; i < bench_calls; ++i) {
+      Function f = lambda;
+      tiny_test::do_not_optimize(f);
+   }
+}
+
+TEST_BENCHMARK(benchConstructSmallInplace) {
+   auto lambda = small_lambda(1);
+   TEST_BENCHMARK_ITEMS(bench_calls);
+   TEST_BENCHMARK_LOOP { construct_loop<inplace_function_t<int(int)>>(lambda); }
+}
+
+TEST_BENCHMARK(benchConstructSmallStdFunction) {
+   auto lambda = small_lambda(1);
+   TEST_BENCHMARK_ITEMS(bench_calls);
+   TEST_BENCHMARK_LOOP { construct_loop<std::function<int(int)>>(lambda); }
+}
+
+TEST_BENCHMARK(benchConstructLargeInplace) {
+   auto lambda = large_lambda(1);
+   TEST_BENCHMARK_ITEMS(bench_calls);
+   TEST_BENCHMARK_LOOP { construct_loop<inplace_function_t<int(int)>>(lambda); }
+}
+
+TEST_BENCHMARK(benchConstructLargeStdFunction) {
+   auto lambda = large_lambda(1);
+   TEST_BENCHMARK_ITEMS(bench_calls);
+   TEST_BENCHMARK_LOOP { construct_loop<std::function<int(int)>>(lambda); }
+}
+
+TEST_SUITE_END() // inplacefunctionTests
@@ -0,0 +1,157 @@
+#include <test_framework/tiny_framework.h>
+
+#include <cstdio>
+#include <fstream>
+#include <iterator>
+#include <sstream>
+#include <string>
+
+#include <fcntl.h>
+#include <unistd.h>
+
+TESTS_BEGIN();
+
+static std::string temp_path(const char *name) {
+   return "/tmp/tiny_test_" + std::to_string(::getpid()) + "_" + name;
+}
+
+static std::string read_file(const std::string &path) {
+   std::ifstream in{path, std::ios::binary};
+   return {std::istreambuf_iterator<char>{in}, std::istreambuf_iterator<char>{}};
+}
+
+static std::string numbered_lines(int count) {
+   std::string ret;
+   for (int i = 0; i < count; ++i) {
+      ret += "line " + std::to_string(i) + "\n";
+   }
+   return ret;
+}
+
+// installed sink is global, so cases must not run in parallel
+TEST_SUITE_SERIAL_BEGIN(logSinkTests)
+
+TEST_CASE(testRingKeepsLastLines) {
+   RingLogSink ring{64};
+   ring.write("one\n", 4);
+   TEST_CHECK("one\n" == ring.contents());
+   auto lines = numbered_lines(100);
+   for (std::size_t pos = 0; pos < lines.size(); pos += 5) {
+      ring.write(lines.data() + pos, std::min<std::size_t>(5, lines.size() - pos));
+   }
+   auto kept = ring.contents();
+   TEST_CHECK(kept.size() <= 64u);
+   TEST_CHECK(kept.size() >= 64u - sizeof("line 99"));
+   // starts with a whole line
+   TEST_CHECK(0 == kept.compare(0, 5, "line "));
+   TEST_CHECK(lines.substr(lines.size() - kept.size()) == kept);
+   TEST_CHECK_EQUAL(lines.size() + 4, ring.written());
+}
+
+TEST_CASE(testRingLargeWrite) {
+   RingLogSink ring{32};
+   auto lines = numbered_lines(20);
+   ring.write(lines.data(), lines.size());
+   TEST_CHECK("line 17\nline 18\nline 19\n" == ring.contents());
+}
+
+TEST_CASE(testMmapSink) {
+   auto path = temp_path("mmap.log");
+   MmapLogSink sink;
+   TEST_REQUIRE(sink.open(path));
+   // several MB, so the file has to grow
+   std::string expected;
+   auto lines = numbered_lines(1000);
+   for (int i = 0; i < 500; ++i) {
+      sink.write(lines.data(), lines.size());
+      expected += lines;
+   }
+   TEST_CHECK_EQUAL(expected.size(), sink.size());
+   sink.close();
+   sink.write("dropped\n", 8);
+   TEST_CHECK(expected == read_file(path));
+   std::remove(path.c_str());
+
+   MmapLogSink bad;
+   TEST_CHECK(!bad.open("/nonexistent/dir/file.log"));
+}
+
+TEST_CASE(testFdSink) {
+   auto path = temp_path("fd.log");
+   auto fd = ::open(path.c_str(), O_WRONLY | O_CREAT | O_TRUNC, 0644);
+   TEST_REQUIRE(fd >= 0);
+   FdLogSink sink{fd, true};
+   sink.write("small\n", 6);
+   sink.flush();
+   TEST_CHECK("small\n" == read_file(path));
+   // larger than the buffer
+   std::string large(100000, 'x');
+   sink.write(large.data(), large.size());
+   sink.close();
+   TEST_CHECK("small\n" + large == read_file(path));
+   std::remove(path.c_str());
+}
+
+TEST_CASE(testMakeLogSink) {
+   TEST_CHECK(!make_log_sink(""));
+   TEST_CHECK(!make_log_sink("fd"));
+   TEST_CHECK(!make_log_sink("fd:"));
+   TEST_CHECK(!make_log_sink("fd:x"));
+   TEST_CHECK(!make_log_sink("ring:0"));
+   TEST_CHECK(!make_log_sink("mmap:"));
+   TEST_CHECK(!make_log_sink("mmap:/nonexistent/dir/file.log"));
+   TEST_CHECK(!make_log_sink("file:1"));
+   TEST_CHECK(dynamic_cast<RingLogSink *>(make_log_sink("ring:1").get()));
+   TEST_CHECK(dynamic_cast<FdLogSink *>(make_log_sink("fd:2").get()));
+   auto path = temp_path("make.log");
+   TEST_CHECK(dynamic_cast<MmapLogSink *>(make_log_sink("mmap:" + path).get()));
+   std::remove(path.c_str());
+}
+
+TEST_CASE(testPrintToSink) {
+   // lines of this test case are not captured by its log with --jobs
+   auto *capture = print_detail::thread_capture();
+   print_detail::thread_capture() = nullptr;
+   RingLogSink ring{4096};
+   auto *prev = set_log_sink(&ring);
+   println("line", 1);
+   print("print", 2);
+   std::cout << " cout\n";
+   println_fmt(PRINT_FMT("{:x}"), 255);
+   set_log_sink(prev);
+   print_detail::thread_capture() = capture;
+   TEST_CHECK("line 1\nprint 2 cout\nff\n" == ring.contents());
+}
+
+// cost of a line in the sinks, compared with fwrite of the default stdout path
+static const std::string bench_line = std::string(63, 'x') + '\n';
+
+TEST_BENCHMARK(benchMmapSink) {
+   auto path = temp_path("bench.log");
+   MmapLogSink sink;
+   sink.open(path);
+   TEST_BENCHMARK_BYTES(bench_line.size());
+   TEST_BENCHMARK_LOOP { sink.write(bench_line.data(), bench_line.size()); }
+   sink.close();
+   std::remove(path.c_str());
+}
+
+TEST_BENCHMARK(benchFdSink) {
+   auto path = temp_path("bench.log");
+   FdLogSink sink{::open(path.c_str(), O_WRONLY | O_CREAT | O_TRUNC, 0644), true};
+   TEST_BENCHMARK_BYTES(bench_line.size());
+   TEST_BENCHMARK_LOOP { sink.write(bench_line.data(), bench_line.size()); }
+   sink.close();
+   std::remove(path.c_str());
+}
+
+TEST_BENCHMARK(benchStdio) {
+   auto path = temp_path("bench.log");
+   auto *file = std::fopen(path.c_str(), "w");
+   TEST_BENCHMARK_BYTES(bench_line.size());
+   TEST_BENCHMARK_LOOP { std::fwrite(bench_line.data(), 1, bench_line.size(), file); }
+   std::fclose(file);
+   std::remove(path.c_str());
+}
+
+TEST_SUITE_END() // logSinkTests
@@ -19,6 +19,8 @@ RELESE_OPT="-O2"
 
 CLANG_ASAN="-fsanitize=address -fno-omit-frame-pointer"
 
+THREAD_OPT="-pthread"
+
 BUILD_TYPE_OPT=$DEBUG_OPT
 # BUILD_TYPE_OPT=$RELESE_OPT
 
@@ -44,7 +46,7 @@ do
    INPUT_FILE="${OUTPUT}.cpp"
 
    echo "Compile $INPUT_FILE ($CLANG_CXX) ..."
-   CMD="$CXX -std=c++14 $INCLUDE $BUILD_TYPE_OPT $INPUT_FILE $CLANG_ASAN \
+   CMD="$CXX -std=c++14 $INCLUDE $BUILD_TYPE_OPT $THREAD_OPT $INPUT_FILE $CLANG_ASAN \
       -o $BUILD_DIR/${OUTPUT}_clang"
    echo $CMD
    $CMD
@@ -55,7 +57,7 @@ do
    fi
 
    echo "Compile $INPUT_FILE ($GCC_CXX) ..."
-   CMD="$GCC_CXX -std=c++14 $INCLUDE $BUILD_TYPE_OPT $INPUT_FILE \
+   CMD="$GCC_CXX -std=c++14 $INCLUDE $BUILD_TYPE_OPT $THREAD_OPT $INPUT_FILE \
       -o $BUILD_DIR/${OUTPUT}_gcc"
    echo $CMD
    $CMD
@@ -79,7 +81,7 @@ echo "compile file: $FILES"
 OUTPUT=multy_cpp_bin
 
 echo "Compile $FILES ($CLANG_CXX) ..."
-CMD="$CXX -std=c++14 $INCLUDE $BUILD_TYPE_OPT $FILES $CLANG_ASAN \
+CMD="$CXX -std=c++14 $INCLUDE $BUILD_TYPE_OPT $THREAD_OPT $FILES $CLANG_ASAN \
    -o $BUILD_DIR/${OUTPUT}_clang"
 echo $CMD
 $CMD
@@ -90,7 +92,7 @@ then
 fi
 
 echo "Compile $FILES ($GCC_CXX) ..."
-CMD="$GCC_CXX -std=c++14 $INCLUDE $BUILD_TYPE_OPT $FILES -o $BUILD_DIR/${OUTPUT}_gcc"
+CMD="$GCC_CXX -std=c++14 $INCLUDE $BUILD_TYPE_OPT $THREAD_OPT $FILES -o $BUILD_DIR/${OUTPUT}_gcc"
 echo $CMD
 $CMD
 ret=$?
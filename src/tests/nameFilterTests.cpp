@@ -0,0 +1,111 @@
+#include <test_framework/tiny_framework.h>
+
+#include <initializer_list>
+#include <string>
+
+using namespace dds;
+using namespace dds::tiny_test;
+
+TESTS_BEGIN();
+
+// filter of `patterns` as given to --filter, `-pattern` excludes
+static __name_filter_t make_filter(std::initializer_list<StringView> patterns) {
+   __name_filter_t filter;
+   for (auto pattern : patterns) {
+      bool exclude = pattern.starts_with('-');
+      filter.add(exclude ? pattern.substr(1) : pattern, "/", exclude);
+   }
+   return filter;
+}
+
+struct match_case_t {
+   const char *pattern;
+   const char *name;
+   bool selected;
+};
+
+TEST_SUITE_BEGIN(nameFilterTests)
+
+TEST_CASE(empty) {
+   __name_filter_t filter;
+   TEST_CHECK(filter.empty());
+   TEST_CHECK(filter.match("any/name", "/"));
+   TEST_CHECK(make_filter({""}).empty());
+}
+
+TEST_CASE(patterns) {
+   const match_case_t cases[] = {
+      // literal segments, a leading part of the name selects the whole suite
+      {"suite/case", "suite/case", true},
+      {"suite/case", "suite/other", false},
+      {"suite/case", "suite/case2", false},
+      {"suite", "suite/nested/case", true},
+      {"suite", "suite2/case", false},
+      {"suite/nested/case", "suite/nested", false},
+      // `*` and `?` inside a segment
+      {"suite/*", "suite/case", true},
+      {"suite/c*e", "suite/case", true},
+      {"suite/c*e", "suite/cases", false},
+      {"suite/ca?e", "suite/case", true},
+      {"suite/ca?e", "suite/cae", false},
+      {"*/case", "other/case", true},
+      {"*/case", "suite/nested/case", false},
+      {"su*/*/c*", "suite/nested/case", true},
+      // `**` at the start, in the middle and at the end
+      {"**/case", "case", true},
+      {"**/case", "suite/case", true},
+      {"**/case", "suite/nested/case", true},
+      {"**/case", "suite/nested/other", false},
+      {"suite/**/case", "suite/case", true},
+      {"suite/**/case", "suite/a/b/c/case", true},
+      {"suite/**/case", "other/a/case", false},
+      {"suite/**/case", "suite/a/other", false},
+      {"suite/**", "suite/a/b/case", true},
+      {"suite/**", "other/suite/case", false},
+      {"**/nested/*", "suite/nested/case", true},
+      {"**/nested/*", "suite/other/case", false},
+   };
+   for (auto &c : cases) {
+      TEST_INFO(std::string{c.pattern} + " ~ " + c.name);
+      TEST_CHECK_EQUAL(c.selected, make_filter({c.pattern}).match(c.name, "/"));
+   }
+}
+
+TEST_CASE(anyPattern) {
+   auto filter = make_filter({"a/one", "b/**/two", "c*"});
+   TEST_CHECK(filter.match("a/one", "/"));
+   TEST_CHECK(filter.match("b/x/two", "/"));
+   TEST_CHECK(filter.match("cc/three", "/"));
+   TEST_CHECK(!filter.match("a/two", "/"));
+   TEST_CHECK(!filter.match("b/one", "/"));
+}
+
+TEST_CASE(exclude) {
+   // exclusion overrides a matching include
+   auto filter = make_filter({"suite", "-suite/slow*"});
+   TEST_CHECK(filter.match("suite/fast", "/"));
+   TEST_CHECK(!filter.match("suite/slow", "/"));
+   TEST_CHECK(!filter.match("suite/slowest", "/"));
+   TEST_CHECK(!filter.match("other/fast", "/"));
+
+   // the order of the patterns doesn't matter
+   filter = make_filter({"-**/slow", "**"});
+   TEST_CHECK(filter.match("suite/fast", "/"));
+   TEST_CHECK(!filter.match("suite/slow", "/"));
+   TEST_CHECK(!filter.match("suite/slow/case", "/"));
+
+   // only exclusions select everything else
+   filter = make_filter({"-suite/nested"});
+   TEST_CHECK(filter.match("suite/case", "/"));
+   TEST_CHECK(filter.match("other/nested", "/"));
+   TEST_CHECK(!filter.match("suite/nested/case", "/"));
+}
+
+TEST_CASE(separator) {
+   __name_filter_t filter;
+   filter.add("suite::*", "::", false);
+   TEST_CHECK(filter.match("suite::case", "::"));
+   TEST_CHECK(!filter.match("other::case", "::"));
+}
+
+TEST_SUITE_END() // nameFilterTests
@@ -0,0 +1,209 @@
+#include <test_framework/tiny_framework.h>
+
+#include <cstdint>
+#include <cstdlib>
+#include <cstring>
+#include <iomanip>
+#include <limits>
+#include <random>
+#include <sstream>
+#include <string>
+#include <vector>
+
+TESTS_BEGIN();
+
+template <typename T>
+static std::string shortest(T value) {
+   char buf[print_detail::max_number_chars];
+   return {buf, print_detail::format_shortest(buf, value)};
+}
+
+template <typename T>
+static std::string integer(T value) {
+   char buf[print_detail::max_number_chars];
+   return {buf, print_detail::format_integer(buf, value)};
+}
+
+static std::string hex(std::uint64_t value, bool upper = false) {
+   char buf[print_detail::max_number_chars];
+   return {buf, print_detail::format_hex(buf, value, upper)};
+}
+
+template <typename... Ts>
+static std::string print_to_string(Ts &&... args) {
+   std::ostringstream out;
+   PrintT::write(out, ' ', static_cast<Ts &&>(args)...);
+   return out.str();
+}
+
+// print `value` to a stream set up with `manip`
+template <typename Manip, typename T>
+static std::string print_with(Manip manip, T value) {
+   std::ostringstream out;
+   out << manip;
+   PrintT::write(out, ' ', value);
+   return out.str();
+}
+
+// stream which discards the output, so the benchmarks measure only the formatting
+class NullBuffer : public std::streambuf {
+protected:
+   int_type overflow(int_type ch) override { return traits_type::not_eof(ch); }
+   std::streamsize xsputn(const char *, std::streamsize n) override { return n; }
+};
+
+struct NullStream {
+   NullBuffer buffer;
+   std::ostream out{&buffer};
+};
+
+static std::vector<std::int64_t> random_integers(std::size_t count) {
+   std::mt19937_64 rng{42};
+   std::vector<std::int64_t> ret(count);
+   for (auto &value : ret) {
+      // spread over all lengths
+      value = static_cast<std::int64_t>(rng() >> (rng() % 64)) * (rng() % 2 ? 1 : -1);
+   }
+   return ret;
+}
+
+static std::vector<double> random_doubles(std::size_t count) {
+   std::mt19937_64 rng{42};
+   std::uniform_real_distribution<double> dist{-1e6, 1e6};
+   std::vector<double> ret(count);
+   for (auto &value : ret) {
+      value = dist(rng);
+   }
+   return ret;
+}
+
+TEST_SUITE_BEGIN(numberFormatTests)
+
+TEST_CASE(testIntegers) {
+   TEST_CHECK("0" == integer(0));
+   TEST_CHECK("7" == integer(7));
+   TEST_CHECK("-10" == integer(-10));
+   TEST_CHECK("100" == integer(100u));
+   TEST_CHECK("1234567890" == integer(1234567890));
+   TEST_CHECK("-32768" == integer(std::numeric_limits<short>::min()));
+   TEST_CHECK("-9223372036854775808" == integer(INT64_MIN));
+   TEST_CHECK("18446744073709551615" == integer(UINT64_MAX));
+   for (std::uint64_t value = 1; value < 10000000000000000000ull; value *= 10) {
+      TEST_CHECK(std::to_string(value) == integer(value));
+      TEST_CHECK(std::to_string(value - 1) == integer(value - 1));
+   }
+}
+
+TEST_CASE(testHex) {
+   TEST_CHECK("0" == hex(0));
+   TEST_CHECK("f" == hex(15));
+   TEST_CHECK("10" == hex(16));
+   TEST_CHECK("DEADBEEF" == hex(0xdeadbeef, true));
+   TEST_CHECK("ffffffffffffffff" == hex(~std::uint64_t{}));
+}
+
+TEST_CASE(testShortestSpecialValues) {
+   TEST_CHECK("0" == shortest(0.0));
+   TEST_CHECK("-0" == shortest(-0.0));
+   TEST_CHECK("inf" == shortest(std::numeric_limits<double>::infinity()));
+   TEST_CHECK("-inf" == shortest(-std::numeric_limits<float>::infinity()));
+   TEST_CHECK("nan" == shortest(std::numeric_limits<double>::quiet_NaN()));
+   TEST_CHECK("5e-324" == shortest(std::numeric_limits<double>::denorm_min()));
+   TEST_CHECK("1.7976931348623157e+308" == shortest(std::numeric_limits<double>::max()));
+   TEST_CHECK("1e-45" == shortest(std::numeric_limits<float>::denorm_min()));
+   TEST_CHECK("3.4028235e+38" == shortest(std::numeric_limits<float>::max()));
+}
+
+TEST_CASE(testShortestNotation) {
+   TEST_CHECK("1" == shortest(1.0));
+   TEST_CHECK("0.1" == shortest(0.1));
+   TEST_CHECK("0.1" == shortest(0.1f));
+   TEST_CHECK("1.5" == shortest(1.5));
+   TEST_CHECK("-123.456" == shortest(-123.456));
+   TEST_CHECK("1000000" == shortest(1e6));
+   TEST_CHECK("0.0001" == shortest(1e-4));
+   TEST_CHECK("1e-05" == shortest(1e-5));
+   TEST_CHECK("10000000000000000" == shortest(1e16));
+   TEST_CHECK("1e+17" == shortest(1e17));
+   TEST_CHECK("1.2345e+100" == shortest(1.2345e100));
+   TEST_CHECK("0.30000000000000004" == shortest(0.1 + 0.2));
+}
+
+TEST_CASE(testShortestRoundTrip) {
+   std::mt19937_64 rng{7};
+   int failed{};
+   for (int i = 0; i < 100000; ++i) {
+      auto bits = rng();
+      double d;
+      std::memcpy(&d, &bits, sizeof(d));
+      auto f = static_cast<float>(rng() % 2 ? d : std::ldexp(d, -900));
+      if (std::isfinite(d) && std::strtod(shortest(d).c_str(), nullptr) != d) {
+         ++failed;
+      }
+      if (std::isfinite(f) && std::strtof(shortest(f).c_str(), nullptr) != f) {
+         ++failed;
+      }
+   }
+   TEST_CHECK_EQUAL(0, failed);
+}
+
+TEST_CASE(testPrint) {
+   TEST_CHECK("1 -2 3 0.25 0.1" == print_to_string(1, -2L, 3ull, 0.25, 0.1f));
+   // chars and bools are printed by iostream as before
+   TEST_CHECK("a 1" == print_to_string('a', true));
+   // stream settings are respected, numbers fall back to iostream then
+   TEST_CHECK("ff" == print_with(std::hex, 255));
+   TEST_CHECK("+5" == print_with(std::showpos, 5));
+   TEST_CHECK("3.14" == print_with(std::setprecision(3), 3.14159));
+   TEST_CHECK("    7" == print_with(std::setw(5), 7));
+   TEST_CHECK("1.500000" == print_with(std::fixed, 1.5));
+   TEST_CHECK("3.14159265358979" == print_to_string(3.14159265358979));
+}
+
+TEST_BENCHMARK(benchPrintIntegers) {
+   auto values = random_integers(1000);
+   TEST_BENCHMARK_ITEMS(values.size());
+   NullStream null;
+   TEST_BENCHMARK_LOOP {
+      for (auto value : values) {
+         PrintT::write(null.out, ' ', value);
+      }
+   }
+}
+
+TEST_BENCHMARK(benchStreamIntegers) {
+   auto values = random_integers(1000);
+   TEST_BENCHMARK_ITEMS(values.size());
+   NullStream null;
+   TEST_BENCHMARK_LOOP {
+      for (auto value : values) {
+         null.out << value;
+      }
+   }
+}
+
+TEST_BENCHMARK(benchPrintDoubles) {
+   auto values = random_doubles(1000);
+   TEST_BENCHMARK_ITEMS(values.size());
+   NullStream null;
+   TEST_BENCHMARK_LOOP {
+      for (auto value : values) {
+         PrintT::write(null.out, ' ', value);
+      }
+   }
+}
+
+// shortest digits of a double need precision 17 with iostream
+TEST_BENCHMARK(benchStreamDoubles) {
+   auto values = random_doubles(1000);
+   TEST_BENCHMARK_ITEMS(values.size());
+   NullStream null;
+   null.out.precision(17);
+   TEST_BENCHMARK_LOOP {
+      for (auto value : values) {
+         null.out << value;
+      }
+   }
+}
+
+TEST_SUITE_END() // numberFormatTests
@@ -1,6 +1,11 @@
 #include <test_framework/tiny_framework.h>
 
+#include <iomanip>
+#include <iostream>
+#include <set>
 #include <sstream>
+#include <thread>
+#include <vector>
 
 TESTS_BEGIN();
 
@@ -32,6 +37,9 @@ using StreamPrintLnT = PrintBaseLnT<StringStreamGetter>;
 constexpr StreamPrintT sprint{};
 constexpr StreamPrintLnT sprintln{};
 
+// all cases share one stream object, so they must not run in parallel
+TEST_SUITE_SERIAL_BEGIN(printlnTests)
+
 TEST_CASE(testEmptyPrint) {
    reset_stream();
    sprint();
@@ -168,3 +176,113 @@ TEST_CASE(testCustomSeparator) {
    str = get_string_and_reset();
    TEST_CHECK("1+2+3+4+5+6+7+8+9+10+11+12+13\n" == str);
 }
+
+// lines printed from several threads at once are never mixed
+TEST_CASE(testThreadsLineAtomic) {
+   reset_stream();
+   const int threads_count = 4;
+   const int lines_count = 200;
+   std::vector<std::thread> threads;
+   for (int t = 0; t < threads_count; ++t) {
+      threads.emplace_back([t] {
+         for (int i = 0; i < lines_count; ++i) {
+            sprintln("thread", t, "line", i, "some longer text to print");
+         }
+      });
+   }
+   for (auto &thread : threads) {
+      thread.join();
+   }
+
+   std::set<std::string> expected;
+   for (int t = 0; t < threads_count; ++t) {
+      for (int i = 0; i < lines_count; ++i) {
+         expected.insert("thread " + std::to_string(t) + " line " + std::to_string(i) +
+                         " some longer text to print");
+      }
+   }
+   std::set<std::string> printed;
+   std::string line;
+   while (std::getline(StreamObject(), line)) {
+      printed.insert(line);
+   }
+   reset_stream();
+   TEST_CHECK_EQUAL(expected.size(), printed.size());
+   TEST_CHECK(expected == printed);
+}
+
+// printing of an argument may print itself, the outer line stays intact
+struct Nested {};
+
+std::ostream &operator<<(std::ostream &out, const Nested &) {
+   sprintln("inner");
+   return out << "nested";
+}
+
+TEST_CASE(testNestedPrint) {
+   reset_stream();
+   sprintln("outer", Nested{}, 1);
+   auto str = get_string_and_reset();
+   TEST_CHECK("inner\nouter nested 1\n" == str);
+}
+
+// the line is formatted like the stream it is printed to
+TEST_CASE(testStreamFormat) {
+   reset_stream();
+   auto &stream = StreamObject();
+   stream << std::hex << std::showbase;
+   sprintln(255, 10u, "text");
+   TEST_CHECK_EQUAL(std::string{"0xff 0xa text\n"}, get_string_and_reset());
+   stream.flags(std::ios_base::dec | std::ios_base::skipws);
+
+   stream << std::setprecision(3) << std::fixed;
+   sprintln(3.14159, 2.5f);
+   TEST_CHECK_EQUAL(std::string{"3.142 2.500\n"}, get_string_and_reset());
+   stream.flags(std::ios_base::dec | std::ios_base::skipws);
+   stream.precision(6);
+
+   // pending width applies to the first value only and is consumed
+   stream << std::setw(4) << std::setfill('.');
+   sprintln(1, 2);
+   sprintln(3);
+   TEST_CHECK_EQUAL(std::string{"...1 2\n3\n"}, get_string_and_reset());
+   TEST_CHECK_EQUAL(0, stream.width());
+   stream.fill(' ');
+
+   // the format of the line doesn't stay for the next one
+   sprintln(255, 0.5);
+   TEST_CHECK_EQUAL(std::string{"255 0.5\n"}, get_string_and_reset());
+}
+
+// println writes to the current buffer of std::cout, like `std::cout <<`
+TEST_CASE(testCoutRedirect) {
+   // not captured by the log of this test case with --jobs
+   auto *capture = print_detail::thread_capture();
+   print_detail::thread_capture() = nullptr;
+   std::stringstream captured;
+   auto *saved = std::cout.rdbuf(captured.rdbuf());
+   std::cout << std::hex;
+   println("redirected", 255);
+   std::cout << std::dec;
+   std::cout.rdbuf(saved);
+   print_detail::thread_capture() = capture;
+   TEST_CHECK_EQUAL(std::string{"redirected ff\n"}, captured.str());
+}
+
+// lines of a thread with a capture buffer don't go to std::cout
+TEST_CASE(testThreadCapture) {
+   auto *capture = print_detail::thread_capture();
+   std::string lines;
+   print_detail::thread_capture() = &lines;
+   std::stringstream out;
+   auto *saved = std::cout.rdbuf(out.rdbuf());
+   println("first", 1);
+   std::thread{[] { println("other thread"); }}.join();
+   println("second", 2.5);
+   std::cout.rdbuf(saved);
+   print_detail::thread_capture() = capture;
+   TEST_CHECK_EQUAL(std::string{"first 1\nsecond 2.5\n"}, lines);
+   TEST_CHECK_EQUAL(std::string{"other thread\n"}, out.str());
+}
+
+TEST_SUITE_END() // printlnTests
@@ -0,0 +1,122 @@
+// replace operator new/delete of this binary to count allocations
+#define DDS_TINYTEST_TRACK_ALLOCS
+
+#include <test_framework/tiny_framework.h>
+
+#include <string>
+#include <type_traits>
+#include <vector>
+
+using namespace dds;
+using namespace dds::tiny_test;
+
+TESTS_BEGIN()
+
+// allocations done by the main thread before the first test case is registered
+static std::size_t allocs_before_registration = __alloc_counters().count;
+// allocations done by the main thread when all test cases are registered
+static std::size_t allocs_after_registration;
+
+static_assert(std::is_trivially_destructible<__test_node_t>::value,
+              "Registration must not run at exit");
+static_assert(std::is_trivially_destructible<__static_test_object_t>::value,
+              "Registration must not run at exit");
+
+// full names of registered nodes starting with `prefix`, in registration order
+static std::vector<std::string> registered(const std::string &prefix) {
+   std::vector<std::string> names;
+   for (auto *test = __get_sobject().first; test; test = test->next) {
+      auto name = test->full_name();
+      if (!name.compare(0, prefix.size(), prefix)) {
+         names.push_back(name);
+      }
+   }
+   return names;
+}
+
+static const __test_node_t *find_node(const std::string &full_name) {
+   for (auto *test = __get_sobject().first; test; test = test->next) {
+      if (test->full_name() == full_name) {
+         return test;
+      }
+   }
+   return nullptr;
+}
+
+TEST_CASE(outsideSuite) { TEST_CHECK(!__result.test->suite); }
+
+TEST_SUITE_BEGIN(registrationTests)
+
+TEST_CASE(noAllocBeforeMain) {
+   TEST_CHECK_EQUAL(0u, allocs_before_registration);
+   TEST_CHECK_EQUAL(0u, allocs_after_registration);
+}
+
+TEST_CASE(order) {
+   std::vector<std::string> expected{"registrationTests/noAllocBeforeMain",
+                                     "registrationTests/order",
+                                     "registrationTests/nodes",
+                                     "registrationTests/serial/separator",
+                                     "registrationTests/serial/nested/deepest",
+                                     "registrationTests/benchmark",
+                                     "registrationTests/last"};
+   TEST_CHECK(expected == registered("registrationTests/"));
+   TEST_CHECK(std::vector<std::string>{"outsideSuite"} == registered("outsideSuite"));
+   TEST_CHECK(__get_sobject().last->next == nullptr);
+}
+
+TEST_CASE(nodes) {
+   auto *test = __result.test;
+   TEST_CHECK_EQUAL(std::string{"nodes"}, test->name);
+   TEST_REQUIRE(test->suite);
+   TEST_CHECK_EQUAL(std::string{"registrationTests"}, test->suite->label);
+   TEST_CHECK(!test->suite->parent);
+   TEST_CHECK(!test->benchmark);
+   TEST_CHECK(!test->serial());
+
+   // serial suite makes serial all nested test cases
+   auto *deepest = find_node("registrationTests/serial/nested/deepest");
+   TEST_REQUIRE(deepest);
+   TEST_CHECK(deepest->serial());
+   TEST_CHECK(!deepest->suite->serial);
+   TEST_CHECK(deepest->suite->parent->serial);
+
+   // benchmarks are always serial
+   auto *benchmark = find_node("registrationTests/benchmark");
+   TEST_REQUIRE(benchmark);
+   TEST_CHECK(benchmark->benchmark);
+   TEST_CHECK(benchmark->serial());
+}
+
+// test separator is global, the names of other test cases change with it
+TEST_SUITE_SERIAL_BEGIN(serial)
+
+TEST_CASE(separator) {
+   auto &sobject = __get_sobject();
+   auto *saved = sobject.test_separator;
+   sobject.test_separator = "::";
+   auto name = __result.test->full_name();
+   sobject.test_separator = saved;
+   TEST_CHECK_EQUAL("registrationTests::serial::separator", name);
+}
+
+TEST_SUITE_BEGIN(nested)
+
+TEST_CASE(deepest) { TEST_CHECK(__result.test->suite->parent->parent); }
+
+TEST_SUITE_END() // nested
+
+TEST_SUITE_END() // serial
+
+TEST_BENCHMARK(benchmark) {
+   TEST_BENCHMARK_LOOP {}
+}
+
+TEST_CASE(last) {
+   TEST_CHECK(__get_sobject().last == find_node("registrationTests/last"));
+}
+
+TEST_SUITE_END() // registrationTests
+
+static const bool registered_all =
+   (allocs_after_registration = __alloc_counters().count, true);
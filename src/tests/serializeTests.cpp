@@ -0,0 +1,282 @@
+#include <common/common.h>
+#include <mpl/serialize.h>
+#include <test_framework/tiny_framework.h>
+
+#include <array>
+#include <cstdint>
+#include <cstring>
+#include <sstream>
+#include <string>
+#include <type_traits>
+#include <vector>
+
+TESTS_BEGIN();
+
+using namespace dds;
+using namespace dds::mpl;
+
+struct fill_t {
+   std::uint64_t price;
+   std::uint32_t quantity;
+   std::uint32_t venue;
+};
+
+struct order_t {
+   std::uint64_t id;
+   std::int32_t side;
+   std::uint32_t flags;
+   std::string symbol;
+   std::vector<fill_t> fills;
+};
+
+// decoded without copies, refers to the input buffer
+struct order_view_t {
+   std::uint64_t id;
+   std::int32_t side;
+   std::uint32_t flags;
+   StringView symbol;
+   span_t<const fill_t> fills;
+};
+
+struct padded_t {
+   char tag;
+   std::uint32_t value;
+};
+
+struct nested_t {
+   std::array<std::uint16_t, 3> codes;
+   std::vector<std::string> names;
+   std::array<std::string, 2> pair;
+   std::vector<order_t> orders;
+};
+
+static std::vector<char> encode_to_vector(const order_t &order) {
+   std::vector<char> buffer(encoded_size(order));
+   encode(order, {buffer.data(), buffer.size()});
+   return buffer;
+}
+
+static order_t make_order(std::uint64_t id) {
+   order_t order{id, -1, 3, "SYM" + std::to_string(id), {}};
+   for (std::uint32_t i = 0; i < 4; ++i) {
+      order.fills.push_back({100 + id + i, 10 * i, i});
+   }
+   return order;
+}
+
+TEST_SUITE_BEGIN(serializeTests)
+
+TEST_CASE(fixedSize) {
+   static_assert(max_encoded_size_t<std::uint32_t>::value == 4, "Size mismatch");
+   static_assert(max_encoded_size_t<fill_t>::value == 16, "Size mismatch");
+   // padding isn't encoded
+   static_assert(max_encoded_size_t<padded_t>::value == 5, "Size mismatch");
+   using pair_t = std::array<padded_t, 2>;
+   static_assert(max_encoded_size_t<pair_t>::value == 10, "Size mismatch");
+   static_assert(!has_fixed_size_t<order_t>::value, "Fixed size mismatch");
+   static_assert(!has_fixed_size_t<std::string>::value, "Fixed size mismatch");
+
+   padded_t padded{'a', 0x01020304};
+   char buffer[max_encoded_size_t<padded_t>::value];
+   TEST_CHECK_EQUAL(5u, encode(padded, {buffer, sizeof(buffer)}));
+   padded_t decoded{};
+   TEST_REQUIRE(decode({buffer, sizeof(buffer)}, decoded));
+   TEST_CHECK_EQUAL('a', decoded.tag);
+   TEST_CHECK_EQUAL(0x01020304u, decoded.value);
+}
+
+TEST_CASE(layout) {
+   order_t order{7, 1, 2, "ab", {{1, 2, 3}}};
+   auto buffer = encode_to_vector(order);
+   TEST_CHECK_EQUAL(buffer.size(), encode(order, {buffer.data(), buffer.size()}));
+   // 16 bytes of numbers, string length and 2 chars, count, fills aligned to 8
+   TEST_CHECK_EQUAL(48u, buffer.size());
+
+   std::uint32_t length{};
+   std::memcpy(&length, buffer.data() + 16, sizeof(length));
+   TEST_CHECK_EQUAL(2u, length);
+   TEST_CHECK_EQUAL("ab", StringView(buffer.data() + 20, 2));
+   std::uint32_t count{};
+   std::memcpy(&count, buffer.data() + 22, sizeof(count));
+   TEST_CHECK_EQUAL(1u, count);
+   fill_t fill{};
+   std::memcpy(&fill, buffer.data() + 32, sizeof(fill));
+   TEST_CHECK_EQUAL(3u, fill.venue);
+}
+
+TEST_CASE(decodeViews) {
+   auto order = make_order(42);
+   auto buffer = encode_to_vector(order);
+
+   order_view_t view{};
+   TEST_REQUIRE(decode({buffer.data(), buffer.size()}, view));
+   TEST_CHECK_EQUAL(42u, view.id);
+   TEST_CHECK_EQUAL(-1, view.side);
+   TEST_CHECK_EQUAL(3u, view.flags);
+   TEST_CHECK_EQUAL("SYM42", view.symbol);
+   TEST_REQUIRE_EQUAL(4u, view.fills.size());
+   TEST_CHECK_EQUAL(145u, view.fills[3].price);
+   TEST_CHECK_EQUAL(30u, view.fills[3].quantity);
+
+   // views refer to the buffer
+   const char *begin = buffer.data();
+   const char *end = begin + buffer.size();
+   TEST_CHECK(view.symbol.data() >= begin && view.symbol.data() < end);
+   auto fills = reinterpret_cast<const char *>(view.fills.data());
+   TEST_CHECK(fills >= begin && fills < end);
+
+   // a view encodes the same as the owning struct
+   std::vector<char> again(encoded_size(view));
+   encode(view, {again.data(), again.size()});
+   TEST_CHECK(buffer == again);
+}
+
+TEST_CASE(decodeCopies) {
+   auto order = make_order(5);
+   auto buffer = encode_to_vector(order);
+   order_t decoded;
+   TEST_REQUIRE(decode({buffer.data(), buffer.size()}, decoded));
+   TEST_CHECK_EQUAL(order.id, decoded.id);
+   TEST_CHECK_EQUAL(order.symbol, decoded.symbol);
+   TEST_REQUIRE_EQUAL(order.fills.size(), decoded.fills.size());
+   TEST_CHECK_EQUAL(order.fills[2], decoded.fills[2]);
+}
+
+TEST_CASE(nested) {
+   nested_t value{{1, 2, 3}, {"one", "", "three"}, {{"x", "yz"}}, {}};
+   value.orders.push_back(make_order(1));
+   value.orders.push_back(make_order(2));
+
+   std::vector<char> buffer(encoded_size(value));
+   TEST_CHECK_EQUAL(buffer.size(), encode(value, {buffer.data(), buffer.size()}));
+   nested_t decoded{};
+   TEST_REQUIRE(decode({buffer.data(), buffer.size()}, decoded));
+   TEST_CHECK(value.codes == decoded.codes);
+   TEST_CHECK(value.names == decoded.names);
+   TEST_CHECK(value.pair == decoded.pair);
+   TEST_REQUIRE_EQUAL(2u, decoded.orders.size());
+   TEST_CHECK_EQUAL("SYM2", decoded.orders[1].symbol);
+   TEST_CHECK_EQUAL(value.orders[1].fills[3], decoded.orders[1].fills[3]);
+
+   // a sequence of views of the elements, the sequence itself is a copy
+   std::vector<order_view_t> views;
+   std::vector<char> orders(encoded_size(value.orders));
+   encode(value.orders, {orders.data(), orders.size()});
+   TEST_REQUIRE(decode({orders.data(), orders.size()}, views));
+   TEST_REQUIRE_EQUAL(2u, views.size());
+   TEST_CHECK_EQUAL("SYM1", views[0].symbol);
+   TEST_CHECK_EQUAL(102u, views[1].fills[0].price);
+}
+
+TEST_CASE(truncated) {
+   auto buffer = encode_to_vector(make_order(3));
+   for (std::size_t size = 0; size < buffer.size(); ++size) {
+      order_view_t view{};
+      TEST_CHECK(!decode({buffer.data(), size}, view));
+   }
+
+   // a count larger than the input doesn't allocate it
+   std::vector<char> huge(sizeof(std::uint32_t));
+   std::uint32_t count = 0xffffffff;
+   std::memcpy(huge.data(), &count, sizeof(count));
+   std::vector<std::string> names;
+   TEST_CHECK(!decode({huge.data(), huge.size()}, names));
+   TEST_CHECK(names.empty());
+}
+
+TEST_CASE(shortBuffer) {
+   auto order = make_order(3);
+   auto size = encoded_size(order);
+   // bytes past the given size are not written
+   std::vector<char> buffer(size + 1, 'x');
+   for (std::size_t given = 0; given < size; ++given) {
+      TEST_CHECK_EQUAL(0u, encode(order, {buffer.data(), given}));
+      TEST_CHECK_EQUAL('x', buffer[given]);
+   }
+   TEST_CHECK_EQUAL(size, encode(order, {buffer.data(), buffer.size()}));
+
+   // a view of the fills needs the input aligned
+   std::vector<char> shifted(buffer.size() + 1);
+   std::memcpy(shifted.data() + 1, buffer.data(), buffer.size());
+   order_view_t view{};
+   TEST_CHECK(!decode({shifted.data() + 1, buffer.size()}, view));
+   order_t copy{};
+   TEST_CHECK(decode({shifted.data() + 1, buffer.size()}, copy));
+   TEST_CHECK_EQUAL(order.fills[3], copy.fills[3]);
+}
+
+// the same encoding by a stream, field by field
+static void write_stream(std::ostream &out, const order_t &order) {
+   out.write(reinterpret_cast<const char *>(&order.id), sizeof(order.id));
+   out.write(reinterpret_cast<const char *>(&order.side), sizeof(order.side));
+   out.write(reinterpret_cast<const char *>(&order.flags), sizeof(order.flags));
+   auto length = static_cast<std::uint32_t>(order.symbol.size());
+   out.write(reinterpret_cast<const char *>(&length), sizeof(length));
+   out << order.symbol;
+   auto count = static_cast<std::uint32_t>(order.fills.size());
+   out.write(reinterpret_cast<const char *>(&count), sizeof(count));
+   for (const auto &fill : order.fills) {
+      out.write(reinterpret_cast<const char *>(&fill.price), sizeof(fill.price));
+      out.write(reinterpret_cast<const char *>(&fill.quantity), sizeof(fill.quantity));
+      out.write(reinterpret_cast<const char *>(&fill.venue), sizeof(fill.venue));
+   }
+}
+
+const std::size_t bench_orders = 1000;
+
+static std::vector<order_t> bench_input() {
+   std::vector<order_t> orders;
+   for (std::size_t i = 0; i < bench_orders; ++i) {
+      orders.push_back(make_order(i));
+   }
+   return orders;
+}
+
+TEST_BENCHMARK(benchEncode) {
+   auto orders = bench_input();
+   std::vector<char> buffer(encoded_size(orders));
+   TEST_BENCHMARK_BYTES(buffer.size());
+   TEST_BENCHMARK_LOOP {
+      tiny_test::do_not_optimize(encode(orders, {buffer.data(), buffer.size()}));
+      tiny_test::clobber_memory();
+   }
+}
+
+TEST_BENCHMARK(benchEncodeIostream) {
+   auto orders = bench_input();
+   std::ostringstream out;
+   TEST_BENCHMARK_BYTES(encoded_size(orders));
+   TEST_BENCHMARK_LOOP {
+      out.seekp(0);
+      for (const auto &order : orders) {
+         write_stream(out, order);
+      }
+      tiny_test::do_not_optimize(out.tellp());
+   }
+}
+
+TEST_BENCHMARK(benchDecodeViews) {
+   auto orders = bench_input();
+   std::vector<char> buffer(encoded_size(orders));
+   encode(orders, {buffer.data(), buffer.size()});
+   std::vector<order_view_t> views;
+   TEST_BENCHMARK_BYTES(buffer.size());
+   TEST_BENCHMARK_LOOP {
+      tiny_test::do_not_optimize(decode({buffer.data(), buffer.size()}, views));
+      tiny_test::clobber_memory();
+   }
+}
+
+TEST_BENCHMARK(benchDecodeCopies) {
+   auto orders = bench_input();
+   std::vector<char> buffer(encoded_size(orders));
+   encode(orders, {buffer.data(), buffer.size()});
+   std::vector<order_t> decoded;
+   TEST_BENCHMARK_BYTES(buffer.size());
+   TEST_BENCHMARK_LOOP {
+      tiny_test::do_not_optimize(decode({buffer.data(), buffer.size()}, decoded));
+      tiny_test::clobber_memory();
+   }
+}
+
+TEST_SUITE_END() // serializeTests
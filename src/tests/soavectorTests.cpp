@@ -0,0 +1,218 @@
+#include <common/common.h>
+#include <mpl/soa_vector.h>
+#include <test_framework/tiny_framework.h>
+
+#include <cstdint>
+#include <random>
+#include <vector>
+
+using namespace dds;
+using namespace dds::mpl;
+
+TESTS_BEGIN()
+
+TEST_SUITE_BEGIN(soavectorTests)
+
+using records_t = soa_vector_t<int, String, double>;
+
+static bool is_aligned(const void *ptr) {
+   return 0 == reinterpret_cast<std::uintptr_t>(ptr) % 64;
+}
+
+TEST_CASE(Basic) {
+   records_t records;
+   TEST_CHECK(records.empty());
+   records.push_back(1, "one", 1.5);
+   records.push_back(2, "two", 2.5);
+   TEST_CHECK_EQUAL(2u, records.size());
+
+   auto row = records[1];
+   TEST_CHECK_EQUAL(2, row.get<0>());
+   TEST_CHECK_EQUAL("two", row.get<String>());
+   TEST_CHECK_EQUAL(2.5, get<2>(row));
+   row.get<1>() = "TWO";
+   TEST_CHECK_EQUAL("TWO", records.column<1>()[1]);
+
+   const auto &crecords = records;
+   static_assert(std::is_same<const int &, decltype(crecords[0].get<0>())>::value,
+                 "Type mismatch");
+   TEST_CHECK_EQUAL(1, crecords[0].get<int>());
+
+   records.pop_back();
+   TEST_CHECK_EQUAL(1u, records.size());
+   records.clear();
+   TEST_CHECK(records.empty());
+}
+
+TEST_CASE(columns) {
+   records_t records;
+   for (int i = 0; i < 100; ++i) {
+      records.push_back(i, std::to_string(i), i * 0.5);
+   }
+   auto ids = records.column<int>();
+   TEST_CHECK_EQUAL(100u, ids.size());
+   int sum{};
+   for (auto id : ids) {
+      sum += id;
+   }
+   TEST_CHECK_EQUAL(99 * 100 / 2, sum);
+   TEST_CHECK_EQUAL("42", records.column<1>()[42]);
+   TEST_CHECK_EQUAL(21.0, records.column<double>()[42]);
+
+   TEST_CHECK(is_aligned(records.column<0>().data()));
+   TEST_CHECK(is_aligned(records.column<1>().data()));
+   TEST_CHECK(is_aligned(records.column<2>().data()));
+}
+
+TEST_CASE(resize) {
+   records_t records;
+   records.resize(10);
+   TEST_CHECK_EQUAL(10u, records.size());
+   TEST_CHECK_EQUAL(0, records[9].get<0>());
+   TEST_CHECK(records[9].get<1>().empty());
+
+   records.resize(20, 7, "seven", 7.5);
+   TEST_CHECK_EQUAL(20u, records.size());
+   TEST_CHECK_EQUAL(0, records[9].get<0>());
+   TEST_CHECK_EQUAL("seven", records[19].get<1>());
+
+   records.resize(5);
+   TEST_CHECK_EQUAL(5u, records.size());
+
+   // one allocation for the requested rows
+   records_t reserved;
+   reserved.reserve(1000);
+   TEST_CHECK_EQUAL(1000u, reserved.capacity());
+   reserved.resize(1000);
+   TEST_CHECK_EQUAL(1000u, reserved.capacity());
+}
+
+TEST_CASE(copyMove) {
+   records_t records;
+   for (int i = 0; i < 50; ++i) {
+      records.push_back(i, std::to_string(i), i * 0.5);
+   }
+   auto copy = records;
+   TEST_REQUIRE(50u == copy.size());
+   TEST_CHECK_EQUAL("49", copy[49].get<1>());
+   copy[0].get<1>() = "changed";
+   TEST_CHECK_EQUAL("0", records[0].get<1>());
+
+   auto moved = std::move(copy);
+   TEST_CHECK_EQUAL(50u, moved.size());
+   TEST_CHECK_EQUAL("changed", moved[0].get<1>());
+
+   records = moved;
+   TEST_CHECK_EQUAL("changed", records[0].get<1>());
+   records = records_t{};
+   TEST_CHECK(records.empty());
+}
+
+TEST_CASE(withRow) {
+   records_t records;
+   records.push_back(3, "abc", 0.5);
+   auto text = records.with_row(0, [](int id, const String &name, double value) {
+      return std::to_string(id) + name + std::to_string(value).substr(0, 3);
+   });
+   TEST_CHECK_EQUAL("3abc0.5", text);
+}
+
+// wide record of which the benchmarks read two fields
+struct order_t {
+   std::int64_t id;
+   double price;
+   double quantity;
+   double fee;
+   double discount;
+   std::int64_t customer;
+   std::int64_t timestamp;
+   std::int64_t flags;
+};
+
+using orders_t = soa_vector_t<std::int64_t,
+                              double,
+                              double,
+                              double,
+                              double,
+                              std::int64_t,
+                              std::int64_t,
+                              std::int64_t>;
+
+const std::size_t bench_size = 100000;
+
+static std::vector<order_t> random_orders() {
+   std::mt19937 rng{42};
+   std::uniform_real_distribution<double> dist{0, 100};
+   std::vector<order_t> ret(bench_size);
+   std::int64_t id{};
+   for (auto &order : ret) {
+      order = {id++, dist(rng), dist(rng), dist(rng), dist(rng), 1, 2, 3};
+   }
+   return ret;
+}
+
+static orders_t to_soa(const std::vector<order_t> &orders) {
+   orders_t ret;
+   ret.reserve(orders.size());
+   for (auto &o : orders) {
+      ret.push_back(o.id,
+                    o.price,
+                    o.quantity,
+                    o.fee,
+                    o.discount,
+                    o.customer,
+                    o.timestamp,
+                    o.flags);
+   }
+   return ret;
+}
+
+TEST_CASE(benchKernels) {
+   auto orders = random_orders();
+   auto soa = to_soa(orders);
+   double aos_sum{};
+   for (auto &order : orders) {
+      aos_sum += order.price * order.quantity;
+   }
+   double soa_sum{};
+   auto prices = soa.column<1>();
+   auto quantities = soa.column<2>();
+   for (std::size_t i = 0; i < prices.size(); ++i) {
+      soa_sum += prices[i] * quantities[i];
+   }
+   TEST_CHECK_EQUAL(aos_sum, soa_sum);
+}
+
+TEST_BENCHMARK(benchArrayOfStructs) {
+   auto orders = random_orders();
+   TEST_BENCHMARK_ITEMS(orders.size());
+   TEST_BENCHMARK_LOOP {
+      double sum{};
+      for (auto &order : orders) {
+         sum += order.price * order.quantity;
+      }
+      tiny_test::do_not_optimize(sum);
+   }
+}
+
+TEST_BENCHMARK(benchStructOfArrays) {
+   auto orders = to_soa(random_orders());
+   TEST_BENCHMARK_ITEMS(orders.size());
+   TEST_BENCHMARK_LOOP {
+      double sum{};
+      auto prices = orders.column<1>();
+      auto quantities = orders.column<2>();
+      for (std::size_t i = 0; i < prices.size(); ++i) {
+         sum += prices[i] * quantities[i];
+      }
+      tiny_test::do_not_optimize(sum);
+   }
+}
+
+TEST_BENCHMARK(benchPushBack) {
+   auto orders = random_orders();
+   TEST_BENCHMARK_ITEMS(orders.size());
+   TEST_BENCHMARK_LOOP { tiny_test::do_not_optimize(to_soa(orders).size()); }
+}
+
+TEST_SUITE_END() // soavectorTests
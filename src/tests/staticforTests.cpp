@@ -0,0 +1,182 @@
+#include <common/common.h>
+#include <mpl/static_for.h>
+#include <test_framework/tiny_framework.h>
+
+#include <cstdint>
+#include <random>
+#include <vector>
+
+using namespace dds;
+using namespace dds::mpl;
+
+TESTS_BEGIN()
+
+TEST_SUITE_BEGIN(staticforTests)
+
+template <int... Is>
+static std::vector<int> to_vector(std::integer_sequence<int, Is...>) {
+   return {Is...};
+}
+
+TEST_CASE(integerRange) {
+   TEST_CHECK(std::vector<int>({0, 1, 2}) == to_vector(integer_range_t<0, 3>{}));
+   TEST_CHECK(std::vector<int>({1, 4, 7}) == to_vector(integer_range_t<1, 9, 3>{}));
+   TEST_CHECK(std::vector<int>({5, 3, 1}) == to_vector(integer_range_t<5, 0, -2>{}));
+   TEST_CHECK(to_vector(integer_range_t<3, 3>{}).empty());
+   TEST_CHECK(to_vector(integer_range_t<3, 0>{}).empty());
+}
+
+TEST_CASE(staticFor) {
+   std::vector<int> values;
+   static_for<0, 5>([&](auto i) {
+      static_assert(decltype(i)::value >= 0 && decltype(i)::value < 5, "Out of range");
+      values.push_back(i);
+   });
+   TEST_CHECK(std::vector<int>({0, 1, 2, 3, 4}) == values);
+
+   values.clear();
+   static_for<10, 0, -3>([&](auto i) { values.push_back(i); });
+   TEST_CHECK(std::vector<int>({10, 7, 4, 1}) == values);
+
+   int calls{};
+   static_for<0, 0>([&](auto) { ++calls; });
+   TEST_CHECK_EQUAL(0, calls);
+}
+
+// indices are constants, so they can index a tuple
+TEST_CASE(staticForTuple) {
+   auto tuple = std::make_tuple(1, 2.5, String{"three"});
+   std::stringstream strm;
+   static_for<0, 3>([&](auto i) { strm << std::get<i>(tuple) << ";"; });
+   TEST_CHECK_EQUAL("1;2.5;three;", strm.str());
+}
+
+TEST_CASE(unroll) {
+   for (std::size_t count = 0; count < 20; ++count) {
+      std::vector<std::size_t> indices;
+      std::vector<std::size_t> lanes;
+      unroll<4>(count, [&](auto i) {
+         indices.push_back(i);
+         lanes.push_back(decltype(i)::lane);
+      });
+      TEST_REQUIRE(count == indices.size());
+      for (std::size_t i = 0; i < count; ++i) {
+         TEST_CHECK_EQUAL(i, indices[i]);
+         TEST_CHECK_EQUAL(i % 4, lanes[i]);
+      }
+   }
+}
+
+TEST_CASE(forEachType) {
+   std::vector<std::size_t> sizes;
+   for_each_type<char, std::int16_t, std::int64_t>(
+      [&](auto tag) { sizes.push_back(sizeof(typename decltype(tag)::type)); });
+   TEST_CHECK(std::vector<std::size_t>({1, 2, 8}) == sizes);
+   for_each_type<>([&](auto) { sizes.clear(); });
+   TEST_CHECK_EQUAL(3u, sizes.size());
+}
+
+static std::vector<float> random_floats(std::size_t count) {
+   std::mt19937 rng{42};
+   std::uniform_real_distribution<float> dist{-1, 1};
+   std::vector<float> ret(count);
+   for (auto &value : ret) {
+      value = dist(rng);
+   }
+   return ret;
+}
+
+static std::vector<char> random_text(std::size_t count) {
+   std::mt19937 rng{42};
+   std::vector<char> ret(count);
+   for (auto &c : ret) {
+      c = rng() % 16 ? static_cast<char>('a' + rng() % 26) : '\n';
+   }
+   return ret;
+}
+
+// kernels compared with plain loops, unrolled ones use an accumulator per lane
+const std::size_t bench_size = 4096;
+
+TEST_BENCHMARK(benchSumLoop) {
+   auto data = random_floats(bench_size);
+   TEST_BENCHMARK_ITEMS(data.size());
+   TEST_BENCHMARK_LOOP {
+      float sum{};
+      for (std::size_t i = 0; i < data.size(); ++i) {
+         sum += data[i];
+      }
+      tiny_test::do_not_optimize(sum);
+   }
+}
+
+TEST_BENCHMARK(benchSumUnroll) {
+   auto data = random_floats(bench_size);
+   TEST_BENCHMARK_ITEMS(data.size());
+   TEST_BENCHMARK_LOOP {
+      float sums[8]{};
+      unroll<8>(data.size(), [&](auto i) { sums[decltype(i)::lane] += data[i]; });
+      float sum{};
+      static_for<0, 8>([&](auto lane) { sum += sums[lane]; });
+      tiny_test::do_not_optimize(sum);
+   }
+}
+
+TEST_BENCHMARK(benchDotLoop) {
+   auto lhs = random_floats(bench_size);
+   auto rhs = random_floats(bench_size);
+   TEST_BENCHMARK_ITEMS(lhs.size());
+   TEST_BENCHMARK_LOOP {
+      float dot{};
+      for (std::size_t i = 0; i < lhs.size(); ++i) {
+         dot += lhs[i] * rhs[i];
+      }
+      tiny_test::do_not_optimize(dot);
+   }
+}
+
+TEST_BENCHMARK(benchDotUnroll) {
+   auto lhs = random_floats(bench_size);
+   auto rhs = random_floats(bench_size);
+   TEST_BENCHMARK_ITEMS(lhs.size());
+   TEST_BENCHMARK_LOOP {
+      float dots[8]{};
+      unroll<8>(lhs.size(), [&](auto i) { dots[decltype(i)::lane] += lhs[i] * rhs[i]; });
+      float dot{};
+      static_for<0, 8>([&](auto lane) { dot += dots[lane]; });
+      tiny_test::do_not_optimize(dot);
+   }
+}
+
+// count of lines
+TEST_BENCHMARK(benchScanLoop) {
+   auto text = random_text(bench_size);
+   TEST_BENCHMARK_BYTES(text.size());
+   TEST_BENCHMARK_LOOP {
+      std::size_t lines{};
+      for (std::size_t i = 0; i < text.size(); ++i) {
+         lines += '\n' == text[i];
+      }
+      tiny_test::do_not_optimize(lines);
+   }
+}
+
+TEST_BENCHMARK(benchScanUnroll) {
+   auto text = random_text(bench_size);
+   TEST_BENCHMARK_BYTES(text.size());
+   TEST_BENCHMARK_LOOP {
+      // narrow counters of a block, added up before they can overflow
+      std::size_t lines{};
+      for (std::size_t block = 0; block < text.size(); block += 255 * 16) {
+         auto size = std::min<std::size_t>(255 * 16, text.size() - block);
+         std::uint8_t counts[16]{};
+         unroll<16>(size, [&](auto i) {
+            counts[decltype(i)::lane] += '\n' == text[block + i];
+         });
+         static_for<0, 16>([&](auto lane) { lines += counts[lane]; });
+      }
+      tiny_test::do_not_optimize(lines);
+   }
+}
+
+TEST_SUITE_END() // staticforTests
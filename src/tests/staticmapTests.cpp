@@ -0,0 +1,257 @@
+#include <common/common.h>
+#include <mpl/static_map.h>
+#include <mpl/switch_string.h>
+#include <test_framework/tiny_framework.h>
+
+#include <cstdint>
+#include <initializer_list>
+#include <memory>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+TESTS_BEGIN();
+
+using namespace dds;
+using namespace dds::mpl;
+
+enum class Color { Red, Green, Blue };
+
+constexpr auto colors = make_static_map<Color>(
+   {{"red", Color::Red}, {"green", Color::Green}, {"blue", Color::Blue}});
+
+// options of the framework, values are the position in the list
+constexpr auto options = make_static_map<int>({{"--help", 0},
+                                               {"--log_level=", 1},
+                                               {"--bench", 2},
+                                               {"--no-bench", 3},
+                                               {"--jobs=", 4},
+                                               {"--filter=", 5},
+                                               {"--list", 6},
+                                               {"--slowest=", 7},
+                                               {"--timeout=", 8},
+                                               {"--flush=", 9},
+                                               {"--log-sink=", 10},
+                                               {"--timeout-abort", 11},
+                                               {"--save-baseline=", 12},
+                                               {"--compare-baseline=", 13},
+                                               {"--regression-threshold=", 14}});
+
+// keys "k000" to "k999" of the generated maps
+struct generated_keys_t {
+   char text[1000][5];
+};
+
+constexpr generated_keys_t make_generated_keys() {
+   generated_keys_t ret{};
+   for (int i = 0; i < 1000; ++i) {
+      ret.text[i][0] = 'k';
+      ret.text[i][1] = static_cast<char>('0' + i / 100);
+      ret.text[i][2] = static_cast<char>('0' + i / 10 % 10);
+      ret.text[i][3] = static_cast<char>('0' + i % 10);
+   }
+   return ret;
+}
+
+static constexpr generated_keys_t generated_keys = make_generated_keys();
+
+// map of the first N generated keys to their numbers
+template <std::size_t N>
+constexpr static_map_t<int, N> make_generated_map() {
+   static_map_entry_t<int> entries[N]{};
+   for (std::size_t i = 0; i < N; ++i) {
+      entries[i].key = StringView{generated_keys.text[i], 4};
+      entries[i].value = static_cast<int>(i);
+   }
+   return static_map_t<int, N>{entries};
+}
+
+TEST_SUITE_BEGIN(staticmapTests)
+
+TEST_CASE(stringHash) {
+   // reference values of 64-bit FNV-1a
+   static_assert(string_hash("") == 0xcbf29ce484222325ull, "Hash mismatch");
+   static_assert(string_hash("a") == 0xaf63dc4c8601ec8cull, "Hash mismatch");
+   static_assert(string_hash("foobar") == 0x85944171f73967e8ull, "Hash mismatch");
+
+   std::string text{"foobar"};
+   TEST_CHECK_EQUAL(string_hash("foobar"), string_hash(StringView{text}));
+   TEST_CHECK_EQUAL(string_hash("foo"), string_hash(StringView{text}.substr(0, 3)));
+   TEST_CHECK_EQUAL(StringView{text}.hash(), string_hash(text));
+}
+
+TEST_CASE(find) {
+   static_assert(colors.size() == 3, "Size mismatch");
+   TEST_REQUIRE(colors.find("green"));
+   TEST_CHECK(Color::Green == *colors.find("green"));
+   TEST_CHECK(Color::Red == *colors.find(std::string{"red"}));
+   TEST_CHECK(colors.contains("blue"));
+
+   TEST_CHECK(!colors.find(""));
+   TEST_CHECK(!colors.find("gree"));
+   TEST_CHECK(!colors.find("greens"));
+   TEST_CHECK(!colors.find("Green"));
+
+   int count{};
+   for (const auto &entry : colors) {
+      TEST_CHECK(colors.find(entry.key) == &entry.value);
+      ++count;
+   }
+   TEST_CHECK_EQUAL(3, count);
+}
+
+TEST_CASE(manyKeys) {
+   int index{};
+   for (const auto &entry : options) {
+      TEST_CHECK_EQUAL(index++, entry.value);
+      TEST_REQUIRE(options.find(entry.key));
+      TEST_CHECK_EQUAL(entry.value, *options.find(entry.key));
+   }
+   TEST_CHECK(!options.contains("--jobs"));
+   TEST_CHECK(!options.contains("--help="));
+
+   // keys shorter than a word
+   constexpr auto short_keys =
+      make_static_map<int>({{"", 0}, {"a", 1}, {"ab", 2}, {"abc", 3}});
+   for (const auto &entry : short_keys) {
+      TEST_REQUIRE(short_keys.find(entry.key));
+      TEST_CHECK_EQUAL(entry.value, *short_keys.find(entry.key));
+   }
+   TEST_CHECK(!short_keys.contains("b"));
+   TEST_CHECK(!short_keys.contains("abcd"));
+
+   // built at run time as well
+   static_map_t<int, 2> map{{{"one", 1}, {"two", 2}}};
+   TEST_CHECK_EQUAL(2, *map.find("two"));
+   TEST_CHECK(!map.contains("three"));
+}
+
+TEST_CASE(largeMaps) {
+   // tables grow linearly with the number of keys
+   using large_t = static_map_t<int, 1000>;
+   static_assert(large_t::slot_count == 2048, "Slots mismatch");
+   static_assert(large_t::bucket_count == 256, "Buckets mismatch");
+   static_assert(sizeof(large_t) < 1000 * (sizeof(static_map_entry_t<int>) + 16),
+                 "Size mismatch");
+
+   // built by the compiler and at run time
+   static constexpr large_t generated = make_generated_map<1000>();
+   std::unique_ptr<const large_t> large{new large_t{make_generated_map<1000>()}};
+   for (auto *map : {&generated, large.get()}) {
+      for (int i = 0; i < 1000; ++i) {
+         TEST_REQUIRE(map->find(generated_keys.text[i]));
+         TEST_CHECK_EQUAL(i, *map->find(generated_keys.text[i]));
+      }
+      TEST_CHECK(!map->contains("k1000"));
+      TEST_CHECK(!map->contains("k00"));
+      TEST_CHECK(!map->contains(""));
+   }
+}
+
+TEST_CASE(switchString) {
+   auto color = [](StringView name) {
+      int ret{-1};
+      switch_string(name,
+                    case_("red", [&] { ret = 0; }),
+                    case_("green", [&] { ret = 1; }),
+                    case_("blue", [&] { ret = 2; }));
+      return ret;
+   };
+   TEST_CHECK_EQUAL(0, color("red"));
+   TEST_CHECK_EQUAL(1, color(std::string{"green"}));
+   TEST_CHECK_EQUAL(2, color("blue"));
+   TEST_CHECK_EQUAL(-1, color("blu"));
+   TEST_CHECK_EQUAL(-1, color(""));
+   TEST_CHECK(switch_string("blue", case_("blue", [] {})));
+   TEST_CHECK(!switch_string("blu", case_("blue", [] {})));
+
+   // only the first matching case is called
+   int calls{};
+   auto count = [&] { ++calls; };
+   TEST_CHECK(switch_string("a", case_("a", count), case_("a", count)));
+   TEST_CHECK_EQUAL(1, calls);
+}
+
+static std::vector<std::string> bench_keys() {
+   std::vector<std::string> keys;
+   for (const auto &entry : options) {
+      keys.push_back(entry.key.to_string());
+   }
+   keys.push_back("--unknown");
+   return keys;
+}
+
+TEST_BENCHMARK(benchStaticMap) {
+   auto keys = bench_keys();
+   TEST_BENCHMARK_ITEMS(keys.size());
+   TEST_BENCHMARK_LOOP {
+      for (const auto &key : keys) {
+         tiny_test::do_not_optimize(options.find(key));
+      }
+   }
+}
+
+TEST_BENCHMARK(benchUnorderedMap) {
+   std::unordered_map<std::string, int> map;
+   for (const auto &entry : options) {
+      map.emplace(entry.key.to_string(), entry.value);
+   }
+   auto keys = bench_keys();
+   TEST_BENCHMARK_ITEMS(keys.size());
+   TEST_BENCHMARK_LOOP {
+      for (const auto &key : keys) {
+         tiny_test::do_not_optimize(map.find(key));
+      }
+   }
+}
+
+// the chain of comparisons parse_args used before
+static int compare_chain(StringView key) {
+   int ret{};
+   for (const auto &entry : options) {
+      if (entry.key == key) {
+         return ret;
+      }
+      ++ret;
+   }
+   return -1;
+}
+
+TEST_BENCHMARK(benchCompareChain) {
+   auto keys = bench_keys();
+   TEST_BENCHMARK_ITEMS(keys.size());
+   TEST_BENCHMARK_LOOP {
+      for (const auto &key : keys) {
+         tiny_test::do_not_optimize(compare_chain(key));
+      }
+   }
+}
+
+TEST_BENCHMARK(benchSwitchString) {
+   auto keys = bench_keys();
+   TEST_BENCHMARK_ITEMS(keys.size());
+   TEST_BENCHMARK_LOOP {
+      for (const auto &key : keys) {
+         int ret{-1};
+         switch_string(key,
+                       case_("--help", [&] { ret = 0; }),
+                       case_("--log_level=", [&] { ret = 1; }),
+                       case_("--bench", [&] { ret = 2; }),
+                       case_("--no-bench", [&] { ret = 3; }),
+                       case_("--jobs=", [&] { ret = 4; }),
+                       case_("--filter=", [&] { ret = 5; }),
+                       case_("--list", [&] { ret = 6; }),
+                       case_("--slowest=", [&] { ret = 7; }),
+                       case_("--timeout=", [&] { ret = 8; }),
+                       case_("--flush=", [&] { ret = 9; }),
+                       case_("--log-sink=", [&] { ret = 10; }),
+                       case_("--timeout-abort", [&] { ret = 11; }),
+                       case_("--save-baseline=", [&] { ret = 12; }),
+                       case_("--compare-baseline=", [&] { ret = 13; }),
+                       case_("--regression-threshold=", [&] { ret = 14; }));
+         tiny_test::do_not_optimize(ret);
+      }
+   }
+}
+
+TEST_SUITE_END() // staticmapTests
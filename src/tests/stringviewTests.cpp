@@ -0,0 +1,270 @@
+#include <common/common.h>
+#include <test_framework/tiny_framework.h>
+
+#include <random>
+#include <sstream>
+#include <unordered_map>
+#include <vector>
+
+using namespace dds;
+
+TESTS_BEGIN()
+
+TEST_SUITE_BEGIN(stringviewTests)
+
+TEST_CASE(Basic) {
+   String text{"hello world"};
+   StringView view{text};
+   TEST_CHECK_EQUAL(text.data(), view.data());
+   TEST_CHECK_EQUAL(11u, view.size());
+   TEST_CHECK_EQUAL('h', view.front());
+   TEST_CHECK_EQUAL('d', view.back());
+   TEST_CHECK_EQUAL("world", view.substr(6));
+   TEST_CHECK_EQUAL("wor", view.substr(6, 3));
+   TEST_CHECK(view.substr(11).empty());
+
+   view.remove_prefix(6);
+   view.remove_suffix(1);
+   TEST_CHECK_EQUAL("worl", view.to_string());
+   TEST_CHECK_EQUAL(String{"worl"}, static_cast<String>(view));
+
+   std::stringstream strm;
+   strm << '[' << view << ']';
+   TEST_CHECK_EQUAL("[worl]", strm.str());
+
+   constexpr StringView literal{"abc", 3};
+   static_assert(3 == literal.size(), "Size mismatch");
+   TEST_CHECK(StringView{}.empty());
+}
+
+TEST_CASE(compare) {
+   TEST_CHECK(StringView{"abc"} == "abc");
+   TEST_CHECK(String{"abc"} == StringView{"abc"});
+   TEST_CHECK(StringView{"abc"} != "abd");
+   TEST_CHECK(StringView{"abc"} < "abd");
+   TEST_CHECK(StringView{"ab"} < "abc");
+   TEST_CHECK(StringView{"b"} > "abc");
+   TEST_CHECK(StringView{"abc"} <= "abc");
+   TEST_CHECK(StringView{"abc"} >= "abc");
+   // characters compare as unsigned, like std::string
+   TEST_CHECK(StringView{"\x80"} > "a");
+   TEST_CHECK_EQUAL(0, StringView{}.compare(""));
+
+   StringView name{"--log_level=all"};
+   TEST_CHECK(name.starts_with("--log_level="));
+   TEST_CHECK(name.starts_with('-'));
+   TEST_CHECK(!name.starts_with("--log_level=all!"));
+   TEST_CHECK(name.ends_with("=all"));
+   TEST_CHECK(name.ends_with('l'));
+   TEST_CHECK(!StringView{}.ends_with('l'));
+}
+
+TEST_CASE(search) {
+   StringView text{"abcabcabc"};
+   TEST_CHECK_EQUAL(0u, text.find("abc"));
+   TEST_CHECK_EQUAL(3u, text.find("abc", 1));
+   TEST_CHECK_EQUAL(2u, text.find('c'));
+   TEST_CHECK_EQUAL(9u, text.find("", 9));
+   TEST_CHECK(StringView::npos == text.find("", 10));
+   TEST_CHECK(StringView::npos == text.find("abd"));
+   TEST_CHECK_EQUAL(6u, text.rfind("abc"));
+   TEST_CHECK_EQUAL(3u, text.rfind("abc", 5));
+   TEST_CHECK_EQUAL(8u, text.rfind('c'));
+   TEST_CHECK_EQUAL(5u, text.rfind('c', 7));
+   TEST_CHECK_EQUAL(9u, text.rfind(""));
+   TEST_CHECK_EQUAL(1u, text.find_first_of("cb"));
+   TEST_CHECK_EQUAL(4u, text.find_first_of("cb", 3));
+   TEST_CHECK(StringView::npos == text.find_first_of(""));
+}
+
+// random text over a small alphabet, so there are many partial matches
+static String random_text(std::mt19937 &rng, std::size_t size) {
+   String ret(size, 'a');
+   for (auto &c : ret) {
+      c = static_cast<char>('a' + rng() % 4);
+   }
+   return ret;
+}
+
+static std::size_t to_npos(std::size_t pos) {
+   return String::npos == pos ? detail::search_npos : pos;
+}
+
+// every kernel set against std::string, over all the block boundaries of the kernels
+static bool kernels_match(const detail::string_kernels_t &kernels) {
+   std::mt19937 rng{42};
+   for (std::size_t size = 0; size < 100; ++size) {
+      for (int round = 0; round < 20; ++round) {
+         auto text = random_text(rng, size);
+         auto other = text;
+         if (size) {
+            other[rng() % size] = 'z';
+         }
+         auto needle = random_text(rng, 2 + rng() % 4);
+         auto set = random_text(rng, 2 + rng() % 3);
+         set[0] = 'z'; // not always found
+         char c = static_cast<char>('a' + rng() % 5);
+         auto found = size >= needle.size()
+                         ? kernels.find(text.data(), size, needle.data(), needle.size())
+                         : to_npos(text.find(needle));
+         if (to_npos(text.find(c)) != kernels.find_char(text.data(), size, c) ||
+             to_npos(text.rfind(c)) != kernels.rfind_char(text.data(), size, c) ||
+             to_npos(text.find(needle)) != found ||
+             to_npos(text.find_first_of(set)) !=
+                kernels.find_first_of(text.data(), size, set.data(), set.size())) {
+            return false;
+         }
+         auto diff = std::mismatch(text.begin(), text.end(), other.begin()).first;
+         if (static_cast<std::size_t>(diff - text.begin()) !=
+             kernels.mismatch(text.data(), other.data(), size)) {
+            return false;
+         }
+      }
+   }
+   return true;
+}
+
+TEST_CASE(kernels) {
+   TEST_CHECK(kernels_match(detail::kernels_of<detail::scalar_kernels_t>()));
+#if DDS_STRING_KERNELS_SIMD
+   TEST_CHECK(kernels_match(detail::kernels_of<detail::sse2_kernels_t>()));
+   if (__builtin_cpu_supports("avx2")) {
+      TEST_CHECK(kernels_match(detail::kernels_of<detail::avx2_kernels_t>()));
+   }
+#endif
+   TEST_CHECK(kernels_match(detail::string_kernels()));
+}
+
+TEST_CASE(searchRandom) {
+   std::mt19937 rng{7};
+   for (int round = 0; round < 2000; ++round) {
+      auto text = random_text(rng, rng() % 200);
+      auto needle = random_text(rng, rng() % 6);
+      auto set = random_text(rng, rng() % 20);
+      std::size_t pos = rng() % 210;
+      StringView view{text};
+      TEST_CHECK_EQUAL(text.find(needle, pos), view.find(needle, pos));
+      TEST_CHECK_EQUAL(text.rfind(needle, pos), view.rfind(needle, pos));
+      TEST_CHECK_EQUAL(text.rfind(needle), view.rfind(needle));
+      TEST_CHECK_EQUAL(text.find('c', pos), view.find('c', pos));
+      TEST_CHECK_EQUAL(text.rfind('c', pos), view.rfind('c', pos));
+      TEST_CHECK_EQUAL(text.find_first_of(set, pos), view.find_first_of(set, pos));
+      auto other = random_text(rng, text.size());
+      auto expected = text.compare(other);
+      auto sign = view.compare(other);
+      TEST_CHECK((expected < 0) == (sign < 0));
+      TEST_CHECK((expected > 0) == (sign > 0));
+   }
+}
+
+TEST_CASE(hash) {
+   String text{"name"};
+   TEST_CHECK_EQUAL(StringView{"name"}.hash(), StringView{text}.hash());
+   TEST_CHECK(StringView{"name"}.hash() != StringView{"game"}.hash());
+   // 64-bit FNV-1a of the empty string
+   TEST_CHECK_EQUAL(0xcbf29ce484222325ull, detail::fnv1a("", 0));
+
+   std::unordered_map<StringView, int> map;
+   map["one"] = 1;
+   map[text] = 2;
+   TEST_CHECK_EQUAL(1, map["one"]);
+   TEST_CHECK_EQUAL(2, map[StringView{"name"}]);
+}
+
+const std::size_t bench_size = 64 * 1024;
+
+// haystack of random letters with the match at its end
+static String bench_text() {
+   std::mt19937 rng{42};
+   String ret(bench_size, 'a');
+   for (auto &c : ret) {
+      c = static_cast<char>('a' + rng() % 26);
+   }
+   ret.replace(bench_size - 8, 8, "#needle#");
+   return ret;
+}
+
+TEST_BENCHMARK(benchFindChar) {
+   auto text = bench_text();
+   StringView view{text};
+   TEST_BENCHMARK_BYTES(text.size());
+   TEST_BENCHMARK_LOOP { tiny_test::do_not_optimize(view.find('#')); }
+}
+
+TEST_BENCHMARK(benchFindCharString) {
+   auto text = bench_text();
+   TEST_BENCHMARK_BYTES(text.size());
+   TEST_BENCHMARK_LOOP { tiny_test::do_not_optimize(text.find('#')); }
+}
+
+TEST_BENCHMARK(benchFind) {
+   auto text = bench_text();
+   StringView view{text};
+   TEST_BENCHMARK_BYTES(text.size());
+   TEST_BENCHMARK_LOOP { tiny_test::do_not_optimize(view.find("needle")); }
+}
+
+TEST_BENCHMARK(benchFindString) {
+   auto text = bench_text();
+   TEST_BENCHMARK_BYTES(text.size());
+   TEST_BENCHMARK_LOOP { tiny_test::do_not_optimize(text.find("needle")); }
+}
+
+TEST_BENCHMARK(benchFindFirstOf) {
+   auto text = bench_text();
+   StringView view{text};
+   TEST_BENCHMARK_BYTES(text.size());
+   TEST_BENCHMARK_LOOP { tiny_test::do_not_optimize(view.find_first_of("#@!")); }
+}
+
+TEST_BENCHMARK(benchFindFirstOfString) {
+   auto text = bench_text();
+   TEST_BENCHMARK_BYTES(text.size());
+   TEST_BENCHMARK_LOOP { tiny_test::do_not_optimize(text.find_first_of("#@!")); }
+}
+
+TEST_BENCHMARK(benchCompare) {
+   auto text = bench_text();
+   auto other = text;
+   other.back() = '!';
+   StringView view{text};
+   TEST_BENCHMARK_BYTES(text.size());
+   TEST_BENCHMARK_LOOP { tiny_test::do_not_optimize(view.compare(other)); }
+}
+
+TEST_BENCHMARK(benchCompareString) {
+   auto text = bench_text();
+   auto other = text;
+   other.back() = '!';
+   TEST_BENCHMARK_BYTES(text.size());
+   TEST_BENCHMARK_LOOP { tiny_test::do_not_optimize(text.compare(other)); }
+}
+
+// copies the old `using StringView = std::string` made of every argument
+TEST_BENCHMARK(benchParseArgs) {
+   std::vector<const char *> args{"--log_level=all", "--filter=suite/*", "--no-bench"};
+   TEST_BENCHMARK_ITEMS(args.size());
+   TEST_BENCHMARK_LOOP {
+      std::size_t matched{};
+      for (auto *arg : args) {
+         StringView opt{arg};
+         matched += "--no-bench" == opt || opt.starts_with("--filter=");
+      }
+      tiny_test::do_not_optimize(matched);
+   }
+}
+
+TEST_BENCHMARK(benchParseArgsString) {
+   std::vector<const char *> args{"--log_level=all", "--filter=suite/*", "--no-bench"};
+   TEST_BENCHMARK_ITEMS(args.size());
+   TEST_BENCHMARK_LOOP {
+      std::size_t matched{};
+      for (auto *arg : args) {
+         String opt{arg};
+         matched += "--no-bench" == opt || 0 == opt.compare(0, 9, "--filter=");
+      }
+      tiny_test::do_not_optimize(matched);
+   }
+}
+
+TEST_SUITE_END() // stringviewTests
@@ -0,0 +1,86 @@
+#include <common/common.h>
+#include <mpl/switch_static.h>
+#include <test_framework/tiny_framework.h>
+
+using namespace dds;
+using namespace dds::mpl;
+
+TESTS_BEGIN()
+
+TEST_SUITE_BEGIN(switchstaticTests)
+
+TEST_CASE(Basic) {
+   using namespace std::literals;
+   auto ret1 = switch_static<2>(
+      case_static<1>(1), case_static<2>("string value"s), default_static(2.5));
+   static_assert(std::is_same<String, decltype(ret1)>::value, "Type mismatch");
+   TEST_CHECK_EQUAL("string value", ret1);
+
+   auto ret2 = switch_static<3>(
+      case_static<1>(1), case_static<2>("string value"s), default_static(2.5));
+   static_assert(std::is_same<double, decltype(ret2)>::value, "Type mismatch");
+   TEST_CHECK_EQUAL(2.5, ret2);
+
+   // default can be anywhere and is optional when a case matches
+   TEST_CHECK_EQUAL(1, switch_static<-1>(default_static(0), case_static<-1>(1)));
+   TEST_CHECK_EQUAL(7, switch_static<7>(case_static<7>(7)));
+}
+
+enum class color_t { red, green, blue };
+
+template <color_t c>
+static String color_name() {
+   auto red = [] { return String{"red"}; };
+   auto green = [] { return String{"green"}; };
+   auto other = [] { return String{"other"}; };
+   return switch_static<static_cast<long long>(c)>(
+      case_static<static_cast<long long>(color_t::red)>(red),
+      case_static<static_cast<long long>(color_t::green)>(green),
+      default_static(other))();
+}
+
+TEST_CASE(enumKey) {
+   TEST_CHECK_EQUAL("red", color_name<color_t::red>());
+   TEST_CHECK_EQUAL("green", color_name<color_t::green>());
+   TEST_CHECK_EQUAL("other", color_name<color_t::blue>());
+}
+
+struct counts_t {
+   int copies{};
+   int moves{};
+};
+
+struct counted_t {
+   explicit counted_t(counts_t &counts_)
+      : counts{&counts_} {}
+   counted_t(const counted_t &other)
+      : counts{other.counts} {
+      ++counts->copies;
+   }
+   counted_t(counted_t &&other)
+      : counts{other.counts} {
+      ++counts->moves;
+   }
+
+   counts_t *counts;
+};
+
+TEST_CASE(forwarding) {
+   counts_t counts;
+   counted_t branch{counts};
+   decltype(auto) ref = switch_static<1>(case_static<0>(0), case_static<1>(branch));
+   static_assert(std::is_same<counted_t &, decltype(ref)>::value, "Type mismatch");
+   TEST_CHECK(&branch == &ref);
+   auto moved = switch_static<5>(case_static<0>(0), default_static(counted_t{counts}));
+   static_assert(std::is_same<counted_t, decltype(moved)>::value, "Type mismatch");
+   TEST_CHECK_EQUAL(0, counts.copies);
+   TEST_CHECK_EQUAL(1, counts.moves);
+}
+
+TEST_CASE(constexprContext) {
+   static_assert(20 == switch_static<2>(case_static<1>(10), case_static<2>(20)), "");
+   static_assert(0 == switch_static<3>(case_static<1>(10), default_static(0)), "");
+   TEST_CHECK(true);
+}
+
+TEST_SUITE_END() // switchstaticTests
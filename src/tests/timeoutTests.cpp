@@ -0,0 +1,142 @@
+#include <test_framework/tiny_framework.h>
+
+#include <atomic>
+#include <chrono>
+#include <initializer_list>
+#include <iostream>
+#include <sstream>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include <csignal>
+#include <fcntl.h>
+#include <sys/wait.h>
+#include <unistd.h>
+
+using namespace dds;
+using namespace dds::tiny_test;
+
+TESTS_BEGIN();
+
+static const char *const sleeping_case = "timeoutTests/helpers/sleeping";
+
+// time slept by `sleeping_case`, it is run only from other test cases
+static std::atomic<int> &sleep_ms() {
+   static std::atomic<int> ms{0};
+   return ms;
+}
+
+// output of a nested run of `sleeping_case`
+struct nested_run_t {
+   String log;         // test output
+   std::string report; // stderr: timeouts and the summary
+};
+
+// runs `sleeping_case` with options `args`, it sleeps for `ms`
+static nested_run_t run_sleeping(std::initializer_list<const char *> args, int ms) {
+   std::vector<std::string> storage{"timeoutTests", "--slowest=0"};
+   storage.push_back(std::string{"--filter="} + sleeping_case);
+   storage.insert(storage.end(), args.begin(), args.end());
+   std::vector<char *> argv;
+   for (auto &arg : storage) {
+      argv.push_back(&arg[0]);
+   }
+   nested_run_t ret;
+   __config_t cfg;
+   if (!cfg.parse_args(static_cast<int>(argv.size()), argv.data())) {
+      return ret;
+   }
+   std::stringstream err;
+   auto *saved_err = std::cerr.rdbuf(err.rdbuf());
+   auto *saved_log = __thread_log();
+   __thread_log() = &ret.log;
+   sleep_ms() = ms;
+   cfg.run_tests(__get_sobject());
+   sleep_ms() = 0;
+   __thread_log() = saved_log;
+   std::cerr.rdbuf(saved_err);
+   ret.report = err.str();
+   return ret;
+}
+
+static bool contains(const std::string &text, const std::string &part) {
+   return text.find(part) != std::string::npos;
+}
+
+// nested runs share the global test list and the standard streams
+TEST_SUITE_SERIAL_BEGIN(timeoutTests)
+
+TEST_CASE(watchdog) {
+   std::atomic<int> calls{0};
+   std::atomic<int> slot{-1};
+   {
+      __watchdog_t watchdog{3, std::chrono::milliseconds{5}, [&](std::size_t i) {
+                               slot = static_cast<int>(i);
+                               ++calls;
+                            }};
+      watchdog.start(0);
+      watchdog.start(1);
+      TEST_CHECK(!watchdog.stop(0));
+      std::this_thread::sleep_for(std::chrono::milliseconds{50});
+      TEST_CHECK(watchdog.stop(1));
+      TEST_CHECK(!watchdog.stop(2));
+   }
+   // expired slot is reported once
+   TEST_CHECK_EQUAL(1, calls.load());
+   TEST_CHECK_EQUAL(1, slot.load());
+}
+
+TEST_CASE(withinTimeout) {
+   auto run = run_sleeping({"--timeout=1000"}, 1);
+   TEST_CHECK(run.log.empty());
+   TEST_CHECK(!contains(run.report, "[timeout]"));
+   TEST_CHECK(contains(run.report, "*** run 1 tests. \n"));
+}
+
+TEST_CASE(timeoutReported) {
+   auto run = run_sleeping({"--timeout=5"}, 50);
+   TEST_CHECK(contains(run.report,
+                       std::string{"[timeout] Test case "} + sleeping_case +
+                          " runs longer than 5 ms\n"));
+   // the test case is finished and fails
+   TEST_CHECK(contains(run.log,
+                       std::string{"[error] Test case "} + sleeping_case +
+                          " exceeded timeout 5 ms, it took "));
+   TEST_CHECK(contains(run.report, "*** run 1 tests. 1 checks failed.\n"));
+
+   // no watchdog without --timeout
+   run = run_sleeping({}, 50);
+   TEST_CHECK(run.log.empty());
+   TEST_CHECK(contains(run.report, "*** run 1 tests. \n"));
+}
+
+TEST_CASE(timeoutAbort) {
+   std::cout.flush();
+   std::cerr.flush();
+   auto pid = ::fork();
+   TEST_REQUIRE(pid >= 0);
+   if (!pid) {
+      // child: keep the output of the parent clean
+      auto null = ::open("/dev/null", O_WRONLY);
+      ::dup2(null, STDOUT_FILENO);
+      ::dup2(null, STDERR_FILENO);
+      run_sleeping({"--timeout=5", "--timeout-abort"}, 1000);
+      ::_exit(0);
+   }
+   int status{};
+   TEST_REQUIRE(::waitpid(pid, &status, 0) == pid);
+   TEST_CHECK(WIFSIGNALED(status));
+   TEST_CHECK_EQUAL(SIGABRT, WIFSIGNALED(status) ? WTERMSIG(status) : 0);
+}
+
+TEST_SUITE_BEGIN(helpers)
+
+TEST_CASE(sleeping) {
+   std::this_thread::sleep_for(std::chrono::milliseconds{sleep_ms().load()});
+   TEST_CHECK(true);
+}
+
+TEST_SUITE_END() // helpers
+
+TEST_SUITE_END() // timeoutTests
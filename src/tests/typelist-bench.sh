@@ -0,0 +1,110 @@
+#!/usr/bin/env bash
+
+# compile-time benchmark of mpl/type_list.h: every algorithm on a list of N types, with
+# each compiler of make.sh which is installed. Peak memory of the compiler is printed
+# when /usr/bin/time or python3 is available.
+# usage: typelist-bench.sh [N...] (default 100 1000 5000)
+
+FULL_SCRIPT=`readlink -f $0`
+DIRNAME=`dirname $FULL_SCRIPT`
+
+cd $DIRNAME
+
+if [ -z $CXX ] ; then
+   CXX=clang++
+fi
+COMPILERS=()
+for COMPILER in $CXX g++
+do
+   if command -v $COMPILER > /dev/null && [[ ! " ${COMPILERS[*]} " =~ " $COMPILER " ]]
+   then
+      COMPILERS+=($COMPILER)
+   else
+      echo "$COMPILER not found, skipped"
+   fi
+done
+
+INCLUDE="-I `pwd`/../include"
+
+SIZES=("$@")
+if [ ${#SIZES[@]} -eq 0 ]
+then
+   SIZES=(100 1000 5000)
+fi
+
+WORK_DIR=`mktemp -d`
+trap "rm -rf $WORK_DIR" EXIT
+
+# list of N types of which every 4th is a duplicate, each algorithm is applied to it
+generate() {
+   local N=$1
+   cat << EOF
+#include <mpl/type_list.h>
+using namespace dds::mpl;
+template <std::size_t I> struct item_t { static constexpr std::size_t key = I % 7; };
+template <typename T> using key_t = std::integral_constant<std::size_t, T::key>;
+template <typename T> using is_even_t = bool_t<T::key % 2 == 0>;
+template <typename Seq> struct make_t;
+template <std::size_t... Is> struct make_t<std::index_sequence<Is...>> {
+   using type = type_list_t<item_t<Is % 4 ? Is : Is / 2>...>;
+};
+using list = make_t<std::make_index_sequence<$N>>::type;
+template <typename Seq> struct reverse_t;
+template <std::size_t... Is> struct reverse_t<std::index_sequence<Is...>> {
+   using type = type_list_t<at_t<list, list::size - 1 - Is>...>;
+};
+static_assert($N == reverse_t<std::make_index_sequence<$N>>::type::size, "at");
+static_assert(index_of_t<list, item_t<$N - 1>>::value < $N, "index_of");
+static_assert(!contains_t<list, int>::value, "contains");
+static_assert(2 * $N == concat_t<list, list>::size, "concat");
+static_assert($N == transform_t<list, std::add_pointer_t>::size, "transform");
+static_assert(filter_t<list, is_even_t>::size <= $N, "filter");
+static_assert(unique_t<list>::size < $N, "unique");
+static_assert($N == sort_by_t<list, key_t>::size, "sort_by");
+int main() {}
+EOF
+}
+
+# runs argv[2:], writes the peak resident size of the child in KB to argv[1]
+PEAK_MEMORY="
+import resource, subprocess, sys
+ret = subprocess.call(sys.argv[2:])
+with open(sys.argv[1], 'w') as out:
+   out.write(str(resource.getrusage(resource.RUSAGE_CHILDREN).ru_maxrss))
+sys.exit(ret)"
+
+BUILD_OK=0
+for N in "${SIZES[@]}"
+do
+   FILE=$WORK_DIR/type_list_$N.cpp
+   generate $N > $FILE
+   for COMPILER in "${COMPILERS[@]}"
+   do
+      CMD="$COMPILER -std=c++14 $INCLUDE -fsyntax-only $FILE"
+      MEMORY="-"
+      START=`date +%s%N`
+      if [ -x /usr/bin/time ]
+      then
+         /usr/bin/time -f %M -o $WORK_DIR/memory $CMD
+         ret=$?
+         MEMORY="`tail -n 1 $WORK_DIR/memory` KB"
+      elif command -v python3 > /dev/null
+      then
+         python3 -c "$PEAK_MEMORY" $WORK_DIR/memory $CMD
+         ret=$?
+         MEMORY="`cat $WORK_DIR/memory` KB"
+      else
+         $CMD
+         ret=$?
+      fi
+      END=`date +%s%N`
+      if [ $ret -ne 0 ]
+      then
+         BUILD_OK=$ret
+      fi
+      printf "%-10s N=%-5s %6d ms %12s\n" $COMPILER $N $(((END - START) / 1000000)) \
+         "$MEMORY"
+   done
+done
+
+exit $BUILD_OK
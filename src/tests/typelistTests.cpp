@@ -0,0 +1,158 @@
+#include <common/common.h>
+#include <mpl/static_for.h>
+#include <mpl/type_list.h>
+#include <test_framework/tiny_framework.h>
+
+#include <cstdint>
+#include <vector>
+
+using namespace dds;
+using namespace dds::mpl;
+
+TESTS_BEGIN()
+
+TEST_SUITE_BEGIN(typelistTests)
+
+using list_t = type_list_t<char, int, double, int, char, float>;
+
+template <std::size_t I>
+struct item_t {
+   static constexpr std::size_t key = I % 5;
+};
+
+template <typename Seq>
+struct items_impl_t;
+
+template <std::size_t... Is>
+struct items_impl_t<std::index_sequence<Is...>> {
+   using type = type_list_t<item_t<Is>...>;
+};
+
+// long list, a naive recursive implementation exceeds the instantiation depth limit
+template <std::size_t N>
+using items_t = typename items_impl_t<std::make_index_sequence<N>>::type;
+
+template <typename T>
+using key_of_t = std::integral_constant<std::size_t, T::key>;
+
+template <typename T>
+using size_of_t = std::integral_constant<std::size_t, sizeof(T)>;
+
+template <typename... Ts>
+static std::vector<std::size_t> sizes(type_list_t<Ts...>) {
+   return {sizeof(Ts)...};
+}
+
+TEST_CASE(sizeAt) {
+   static_assert(0 == type_list_t<>::size, "Size mismatch");
+   static_assert(6 == list_t::size, "Size mismatch");
+   static_assert(std::is_same<char, at_t<list_t, 0>>::value, "Type mismatch");
+   static_assert(std::is_same<double, at_t<list_t, 2>>::value, "Type mismatch");
+   static_assert(std::is_same<float, at_t<list_t, 5>>::value, "Type mismatch");
+
+   using items = items_t<1000>;
+   static_assert(std::is_same<item_t<0>, at_t<items, 0>>::value, "Type mismatch");
+   static_assert(std::is_same<item_t<31>, at_t<items, 31>>::value, "Type mismatch");
+   static_assert(std::is_same<item_t<32>, at_t<items, 32>>::value, "Type mismatch");
+   static_assert(std::is_same<item_t<999>, at_t<items, 999>>::value, "Type mismatch");
+
+   std::vector<std::size_t> values;
+   static_for<0, 6>([&](auto i) { values.push_back(sizeof(at_t<list_t, i>)); });
+   TEST_CHECK(sizes(list_t{}) == values);
+}
+
+TEST_CASE(indexOf) {
+   static_assert(0 == index_of_t<list_t, char>::value, "Index mismatch");
+   static_assert(1 == index_of_t<list_t, int>::value, "Index mismatch");
+   static_assert(5 == index_of_t<list_t, float>::value, "Index mismatch");
+   static_assert(6 == index_of_t<list_t, long>::value, "Index mismatch");
+   static_assert(0 == index_of_t<type_list_t<>, int>::value, "Index mismatch");
+   static_assert(777 == index_of_t<items_t<1000>, item_t<777>>::value, "Index mismatch");
+
+   static_assert(contains_t<list_t, double>::value, "Not found");
+   static_assert(!contains_t<list_t, const double>::value, "Found");
+   static_assert(!contains_t<type_list_t<>, int>::value, "Found");
+   auto found = contains_t<list_t, int>{};
+   TEST_CHECK(found);
+}
+
+TEST_CASE(concat) {
+   static_assert(std::is_same<type_list_t<>, concat_t<>>::value, "Type mismatch");
+   static_assert(std::is_same<list_t, concat_t<list_t>>::value, "Type mismatch");
+   using joined = concat_t<type_list_t<int>,
+                           type_list_t<>,
+                           type_list_t<char, double>,
+                           type_list_t<float>,
+                           type_list_t<>,
+                           type_list_t<>,
+                           type_list_t<long>,
+                           type_list_t<>,
+                           type_list_t<short>,
+                           type_list_t<bool>>;
+   using expected = type_list_t<int, char, double, float, long, short, bool>;
+   static_assert(std::is_same<expected, joined>::value, "Type mismatch");
+   static_assert(2000 == concat_t<items_t<1000>, items_t<1000>>::size, "Size mismatch");
+}
+
+TEST_CASE(transform) {
+   using pointers = transform_t<list_t, std::add_pointer_t>;
+   using expected = type_list_t<char *, int *, double *, int *, char *, float *>;
+   static_assert(std::is_same<expected, pointers>::value, "Type mismatch");
+   using empty = transform_t<type_list_t<>, std::add_pointer_t>;
+   static_assert(std::is_same<type_list_t<>, empty>::value, "Type mismatch");
+}
+
+TEST_CASE(filter) {
+   using integral = filter_t<list_t, std::is_integral>;
+   static_assert(std::is_same<type_list_t<char, int, int, char>, integral>::value,
+                 "Type mismatch");
+   static_assert(std::is_same<type_list_t<>, filter_t<list_t, std::is_pointer>>::value,
+                 "Type mismatch");
+}
+
+template <typename T>
+using is_zero_key_t = bool_t<0 == T::key>;
+
+TEST_CASE(filterLong) {
+   static_assert(1000 == filter_t<items_t<1000>, std::is_empty>::size, "Size mismatch");
+   // every 5th item
+   using zero_keys = filter_t<items_t<1000>, is_zero_key_t>;
+   static_assert(200 == zero_keys::size, "Size mismatch");
+   static_assert(std::is_same<item_t<0>, at_t<zero_keys, 0>>::value, "Type mismatch");
+   static_assert(std::is_same<item_t<995>, at_t<zero_keys, 199>>::value, "Type mismatch");
+}
+
+TEST_CASE(unique) {
+   using expected = type_list_t<char, int, double, float>;
+   static_assert(std::is_same<expected, unique_t<list_t>>::value, "Type mismatch");
+   static_assert(std::is_same<type_list_t<>, unique_t<type_list_t<>>>::value,
+                 "Type mismatch");
+   using ints = type_list_t<int, int, int>;
+   static_assert(std::is_same<type_list_t<int>, unique_t<ints>>::value, "Type mismatch");
+
+   // duplicates in different chunks
+   using twice = concat_t<items_t<500>, type_list_t<int>, items_t<500>, type_list_t<int>>;
+   using unique = unique_t<twice>;
+   static_assert(501 == unique::size, "Size mismatch");
+   static_assert(std::is_same<int, at_t<unique, 500>>::value, "Type mismatch");
+   using same = unique_t<items_t<500>>;
+   static_assert(std::is_same<items_t<500>, same>::value, "Type mismatch");
+}
+
+TEST_CASE(sortBy) {
+   using sorted = sort_by_t<list_t, size_of_t>;
+   using expected = type_list_t<char, char, int, int, float, double>;
+   static_assert(std::is_same<expected, sorted>::value, "Type mismatch");
+   static_assert(std::is_same<type_list_t<>, sort_by_t<type_list_t<>, size_of_t>>::value,
+                 "Type mismatch");
+
+   // stable, items of the same key keep their order
+   using items = sort_by_t<items_t<1000>, key_of_t>;
+   static_assert(std::is_same<item_t<0>, at_t<items, 0>>::value, "Type mismatch");
+   static_assert(std::is_same<item_t<5>, at_t<items, 1>>::value, "Type mismatch");
+   static_assert(std::is_same<item_t<995>, at_t<items, 199>>::value, "Type mismatch");
+   static_assert(std::is_same<item_t<1>, at_t<items, 200>>::value, "Type mismatch");
+   static_assert(std::is_same<item_t<999>, at_t<items, 999>>::value, "Type mismatch");
+}
+
+TEST_SUITE_END() // typelistTests
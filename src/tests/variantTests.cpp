@@ -0,0 +1,359 @@
+#include <common/common.h>
+#include <mpl/dispatch_static.h>
+#include <mpl/variant.h>
+#include <test_framework/tiny_framework.h>
+
+#include <cstdint>
+#include <memory>
+#include <random>
+#include <type_traits>
+#include <vector>
+
+using namespace dds;
+using namespace dds::mpl;
+
+TESTS_BEGIN()
+
+TEST_SUITE_BEGIN(variantTests)
+
+TEST_CASE(Basic) {
+   variant_t<int, String, double> v;
+   TEST_CHECK_EQUAL(0u, v.index());
+   TEST_CHECK_EQUAL(0, get<int>(v));
+
+   v = String{"text"};
+   TEST_CHECK_EQUAL(1u, v.index());
+   TEST_CHECK(holds_alternative<String>(v));
+   TEST_CHECK(!holds_alternative<int>(v));
+   TEST_CHECK_EQUAL("text", get<1>(v));
+   TEST_CHECK_EQUAL("text", get<String>(v));
+
+   v = 2.5;
+   TEST_CHECK_EQUAL(2.5, get<double>(v));
+   TEST_CHECK(nullptr == get_if<String>(&v));
+   TEST_REQUIRE(get_if<double>(&v));
+   *get_if<double>(&v) = 3.5;
+   const auto &cv = v;
+   TEST_CHECK_EQUAL(3.5, *get_if<double>(&cv));
+
+   auto &text = v.emplace<String>(3u, 'x');
+   TEST_CHECK_EQUAL("xxx", text);
+   TEST_CHECK(&text == &get<String>(v));
+}
+
+TEST_CASE(indexType) {
+   static_assert(sizeof(variant_t<char, std::int8_t>::index_type) == 1, "Size mismatch");
+   static_assert(sizeof(variant_t<char, std::int8_t>) == 2, "Size mismatch");
+   static_assert(alignof(variant_t<char, double>) == alignof(double), "Align mismatch");
+   static_assert(sizeof(variant_t<char, double>) == 2 * sizeof(double), "Size mismatch");
+   TEST_CHECK(true);
+}
+
+struct counts_t {
+   int copies{};
+   int moves{};
+   int destroyed{};
+};
+
+struct counted_t {
+   explicit counted_t(counts_t &counts_)
+      : counts{&counts_} {}
+   counted_t(const counted_t &other)
+      : counts{other.counts} {
+      ++counts->copies;
+   }
+   counted_t(counted_t &&other) noexcept
+      : counts{other.counts} {
+      ++counts->moves;
+   }
+   counted_t &operator=(const counted_t &other) {
+      counts = other.counts;
+      ++counts->copies;
+      return *this;
+   }
+   counted_t &operator=(counted_t &&other) noexcept {
+      counts = other.counts;
+      ++counts->moves;
+      return *this;
+   }
+   ~counted_t() { ++counts->destroyed; }
+
+   counts_t *counts;
+};
+
+TEST_CASE(copyMove) {
+   counts_t counts;
+   {
+      variant_t<int, counted_t> v{counted_t{counts}};
+      TEST_CHECK_EQUAL(1, counts.moves);
+
+      auto copy = v;
+      TEST_CHECK_EQUAL(1, counts.copies);
+      auto moved = std::move(copy);
+      TEST_CHECK_EQUAL(2, counts.moves);
+
+      // same alternative is assigned
+      moved = v;
+      TEST_CHECK_EQUAL(2, counts.copies);
+      moved = std::move(v);
+      TEST_CHECK_EQUAL(3, counts.moves);
+
+      // another alternative destroys the value
+      auto destroyed = counts.destroyed;
+      moved = 1;
+      TEST_CHECK_EQUAL(destroyed + 1, counts.destroyed);
+      TEST_CHECK_EQUAL(1, get<int>(moved));
+   }
+   // the temporary and the values of the three variants
+   TEST_CHECK_EQUAL(4, counts.destroyed);
+}
+
+// move assignment is noexcept only when the alternatives are nothrow move assignable
+struct throwing_assign_t {
+   throwing_assign_t() = default;
+   throwing_assign_t(throwing_assign_t &&) noexcept = default;
+   throwing_assign_t &operator=(throwing_assign_t &&) noexcept(false) { return *this; }
+};
+
+static_assert(std::is_nothrow_move_assignable<variant_t<int, String>>::value,
+              "Move assignment must be noexcept");
+static_assert(!std::is_nothrow_move_assignable<variant_t<int, throwing_assign_t>>::value,
+              "Move assignment must not be noexcept");
+static_assert(
+   std::is_nothrow_move_constructible<variant_t<int, throwing_assign_t>>::value,
+   "Move construction must be noexcept");
+
+TEST_CASE(compare) {
+   using variant = variant_t<int, String>;
+   TEST_CHECK(variant{1} == variant{1});
+   TEST_CHECK(variant{1} != variant{2});
+   TEST_CHECK(variant{String{"1"}} != variant{1});
+   TEST_CHECK(variant{String{"1"}} == variant{String{"1"}});
+}
+
+TEST_CASE(visit) {
+   variant_t<int, String, double> v{String{"abc"}};
+   auto size = visit([](const auto &value) { return sizeof(value); }, v);
+   TEST_CHECK_EQUAL(sizeof(String), size);
+
+   // reference to the held value
+   visit([](auto &value) { value += value; }, v);
+   TEST_CHECK_EQUAL("abcabc", get<String>(v));
+
+   // an rvalue variant is visited as rvalues
+   auto moved = visit(
+      [](auto &&value) -> String {
+         using T = decltype(value);
+         return std::is_rvalue_reference<T>::value ? "rvalue" : "lvalue";
+      },
+      std::move(v));
+   TEST_CHECK_EQUAL("rvalue", moved);
+}
+
+TEST_CASE(visitMultiple) {
+   using variant = variant_t<int, double, String>;
+   auto f = [](const auto &a, const auto &b, const auto &c) {
+      return sizeof(a) * 100 + sizeof(b) * 10 + sizeof(c);
+   };
+   variant a{1};
+   variant b{2.5};
+   variant_t<char, int> c{'c'};
+   TEST_CHECK_EQUAL(4u * 100 + 8 * 10 + 1, visit(f, a, b, c));
+   c = 3;
+   TEST_CHECK_EQUAL(4u * 100 + 8 * 10 + 4, visit(f, a, b, c));
+   a = String{};
+   TEST_CHECK_EQUAL(sizeof(String) * 100 + 8 * 10 + 4, visit(f, a, b, c));
+}
+
+// alternatives of the benchmarks, with the same work in all the dispatch variants
+template <std::size_t I>
+struct shape_t {
+   int area() const { return value * static_cast<int>(I + 1); }
+
+   int value;
+};
+
+struct shape_base_t {
+   virtual ~shape_base_t() = default;
+   virtual int area() const = 0;
+};
+
+template <std::size_t I>
+struct virtual_shape_t : shape_base_t {
+   explicit virtual_shape_t(int value_)
+      : value{value_} {}
+   int area() const override { return value * static_cast<int>(I + 1); }
+
+   int value;
+};
+
+template <typename Seq>
+struct shapes_impl_t;
+
+template <std::size_t... Is>
+struct shapes_impl_t<std::index_sequence<Is...>> {
+   using type = variant_t<shape_t<Is>...>;
+};
+
+template <std::size_t N>
+using shape_variant_t = typename shapes_impl_t<std::make_index_sequence<N>>::type;
+
+const std::size_t bench_size = 1000;
+
+template <std::size_t N>
+static std::vector<int> random_kinds() {
+   std::mt19937 rng{42};
+   std::vector<int> ret(bench_size);
+   for (auto &kind : ret) {
+      kind = static_cast<int>(rng() % N);
+   }
+   return ret;
+}
+
+template <std::size_t N>
+static std::vector<shape_variant_t<N>> make_variants() {
+   std::vector<shape_variant_t<N>> ret;
+   for (auto kind : random_kinds<N>()) {
+      ret.push_back(dispatch_static<0, N - 1>(kind, [&](auto i) {
+         return shape_variant_t<N>{shape_t<decltype(i)::value>{kind}};
+      }));
+   }
+   return ret;
+}
+
+template <std::size_t N>
+static std::vector<std::unique_ptr<shape_base_t>> make_virtuals() {
+   std::vector<std::unique_ptr<shape_base_t>> ret;
+   for (auto kind : random_kinds<N>()) {
+      ret.push_back(dispatch_static<0, N - 1>(kind, [&](auto i) {
+         using shape = virtual_shape_t<decltype(i)::value>;
+         return std::unique_ptr<shape_base_t>{new shape{kind}};
+      }));
+   }
+   return ret;
+}
+
+template <typename V>
+static int sum_visit(const std::vector<V> &shapes) {
+   int sum{};
+   for (auto &shape : shapes) {
+      sum += visit([](const auto &s) { return s.area(); }, shape);
+   }
+   return sum;
+}
+
+static int sum_virtual(const std::vector<std::unique_ptr<shape_base_t>> &shapes) {
+   int sum{};
+   for (auto &shape : shapes) {
+      sum += shape->area();
+   }
+   return sum;
+}
+
+// chain of comparisons with the index, one per alternative
+template <std::size_t I, typename V>
+static int area_chain(const V &shape, std::true_type) {
+   return shape.template get_unchecked<I>().area();
+}
+
+template <std::size_t I, typename V>
+static int area_chain(const V &shape, std::false_type) {
+   if (I == shape.index()) {
+      return shape.template get_unchecked<I>().area();
+   }
+   return area_chain<I + 1>(shape, bool_t<I + 2 == V::size>{});
+}
+
+template <typename V>
+static int sum_chain(const std::vector<V> &shapes) {
+   int sum{};
+   for (auto &shape : shapes) {
+      sum += area_chain<0>(shape, bool_t<1 == V::size>{});
+   }
+   return sum;
+}
+
+// every alternative through the chain of comparisons and through the table
+template <std::size_t N>
+static bool visits_every_alternative() {
+   bool ret = true;
+   for (int kind = 0; kind < static_cast<int>(N); ++kind) {
+      auto v = dispatch_static<0, N - 1>(kind, [&](auto i) {
+         return shape_variant_t<N>{shape_t<decltype(i)::value>{1}};
+      });
+      ret = ret && kind + 1 == visit([](const auto &s) { return s.area(); }, v);
+      ret = ret && kind == v.with_index([](auto i) { return decltype(i)::value; });
+   }
+   return ret;
+}
+
+TEST_CASE(visitEveryAlternative) {
+   static_assert(mpl::detail::variant_chain_max == 8, "Alternatives mismatch");
+   TEST_CHECK(visits_every_alternative<1>());
+   TEST_CHECK(visits_every_alternative<2>());
+   TEST_CHECK(visits_every_alternative<8>());
+   TEST_CHECK(visits_every_alternative<9>());
+   TEST_CHECK(visits_every_alternative<64>());
+}
+
+TEST_CASE(benchKernels) {
+   auto expected = sum_virtual(make_virtuals<8>());
+   TEST_CHECK_EQUAL(expected, sum_visit(make_variants<8>()));
+   TEST_CHECK_EQUAL(expected, sum_chain(make_variants<8>()));
+}
+
+TEST_BENCHMARK(benchVisit2) {
+   auto shapes = make_variants<2>();
+   TEST_BENCHMARK_ITEMS(shapes.size());
+   TEST_BENCHMARK_LOOP { tiny_test::do_not_optimize(sum_visit(shapes)); }
+}
+
+TEST_BENCHMARK(benchVirtual2) {
+   auto shapes = make_virtuals<2>();
+   TEST_BENCHMARK_ITEMS(shapes.size());
+   TEST_BENCHMARK_LOOP { tiny_test::do_not_optimize(sum_virtual(shapes)); }
+}
+
+TEST_BENCHMARK(benchChain2) {
+   auto shapes = make_variants<2>();
+   TEST_BENCHMARK_ITEMS(shapes.size());
+   TEST_BENCHMARK_LOOP { tiny_test::do_not_optimize(sum_chain(shapes)); }
+}
+
+TEST_BENCHMARK(benchVisit8) {
+   auto shapes = make_variants<8>();
+   TEST_BENCHMARK_ITEMS(shapes.size());
+   TEST_BENCHMARK_LOOP { tiny_test::do_not_optimize(sum_visit(shapes)); }
+}
+
+TEST_BENCHMARK(benchVirtual8) {
+   auto shapes = make_virtuals<8>();
+   TEST_BENCHMARK_ITEMS(shapes.size());
+   TEST_BENCHMARK_LOOP { tiny_test::do_not_optimize(sum_virtual(shapes)); }
+}
+
+TEST_BENCHMARK(benchChain8) {
+   auto shapes = make_variants<8>();
+   TEST_BENCHMARK_ITEMS(shapes.size());
+   TEST_BENCHMARK_LOOP { tiny_test::do_not_optimize(sum_chain(shapes)); }
+}
+
+TEST_BENCHMARK(benchVisit64) {
+   auto shapes = make_variants<64>();
+   TEST_BENCHMARK_ITEMS(shapes.size());
+   TEST_BENCHMARK_LOOP { tiny_test::do_not_optimize(sum_visit(shapes)); }
+}
+
+TEST_BENCHMARK(benchVirtual64) {
+   auto shapes = make_virtuals<64>();
+   TEST_BENCHMARK_ITEMS(shapes.size());
+   TEST_BENCHMARK_LOOP { tiny_test::do_not_optimize(sum_virtual(shapes)); }
+}
+
+TEST_BENCHMARK(benchChain64) {
+   auto shapes = make_variants<64>();
+   TEST_BENCHMARK_ITEMS(shapes.size());
+   TEST_BENCHMARK_LOOP { tiny_test::do_not_optimize(sum_chain(shapes)); }
+}
+
+TEST_SUITE_END() // variantTests